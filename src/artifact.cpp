@@ -1130,7 +1130,7 @@ void it_artifact_tool::deserialize( const JsonObject &jo )
     melee[DT_BASH] = jo.get_int( "melee_dam" );
     melee[DT_CUT] = jo.get_int( "melee_cut" );
     m_to_hit = jo.get_int( "m_to_hit" );
-    item_tags = jo.get_tags( "item_flags" );
+    item_tags = flag_set( jo.get_tags( "item_flags" ) );
 
     tool->max_charges = jo.get_int( "max_charges" );
     tool->def_charges = jo.get_int( "def_charges" );
@@ -1238,7 +1238,7 @@ void it_artifact_armor::deserialize( const JsonObject &jo )
     melee[DT_BASH] = jo.get_int( "melee_dam" );
     melee[DT_CUT] = jo.get_int( "melee_cut" );
     m_to_hit = jo.get_int( "m_to_hit" );
-    item_tags = jo.get_tags( "item_flags" );
+    item_tags = flag_set( jo.get_tags( "item_flags" ) );
 
     // Old saves don't have max_encumber, so set it to base encumbrance value
     armor->data.push_back( { jo.get_int( "encumber" ), jo.get_int( "max_encumber", jo.get_int( "encumber" ) ), jo.get_int( "coverage" ), {} } );
@@ -1182,9 +1182,10 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
                 } else {
                     color = catacurses::blue + bold;
                 }
-                if( get_option<std::string>( "USE_CELSIUS" ) == "celsius" ) {
+                static const option_handle<std::string> use_celsius( "USE_CELSIUS" );
+                if( use_celsius.get() == "celsius" ) {
                     temp_value = temp_to_celsius( temp_value );
-                } else if( get_option<std::string>( "USE_CELSIUS" ) == "kelvin" ) {
+                } else if( use_celsius.get() == "kelvin" ) {
                     temp_value = temp_to_kelvin( temp_value );
 
                 }
@@ -3325,7 +3326,8 @@ void cata_tiles::draw_weather_frame()
 
 void cata_tiles::draw_sct_frame( std::multimap<point, formatted_text> &overlay_strings )
 {
-    const bool use_font = get_option<bool>( "ANIMATION_SCT_USE_FONT" );
+    static const option_handle<bool> animation_sct_use_font( "ANIMATION_SCT_USE_FONT" );
+    const bool use_font = animation_sct_use_font.get();
     Character &player_character = get_player_character();
 
     for( auto iter = SCT.vSCT.begin(); iter != SCT.vSCT.end(); ++iter ) {
@@ -540,10 +540,16 @@ bool read_from_file( const std::string &path, const std::function<void( std::ist
 
 bool read_from_file_json( const std::string &path, const std::function<void( JsonIn & )> &reader )
 {
-    return read_from_file( path, [&reader]( std::istream & fin ) {
-        JsonIn jsin( fin );
+    try {
+        const mapped_file file( path );
+        JsonIn jsin( file.data(), file.size() );
         reader( jsin );
-    } );
+        return true;
+
+    } catch( const std::exception &err ) {
+        debugmsg( _( "Failed to read from \"%1$s\": %2$s" ), path.c_str(), err.what() );
+        return false;
+    }
 }
 
 bool read_from_file( const std::string &path, JsonDeserializer &reader )
@@ -565,10 +571,8 @@ bool read_from_file_optional( const std::string &path,
 bool read_from_file_optional_json( const std::string &path,
                                    const std::function<void( JsonIn & )> &reader )
 {
-    return read_from_file_optional( path, [&reader]( std::istream & fin ) {
-        JsonIn jsin( fin );
-        reader( jsin );
-    } );
+    // Same race condition as above
+    return file_exist( path ) && read_from_file_json( path, reader );
 }
 
 bool read_from_file_optional( const std::string &path, JsonDeserializer &reader )
@@ -34,6 +34,7 @@
 #include "fungal_effects.h"
 #include "game.h"
 #include "game_constants.h"
+#include "hash_utils.h"
 #include "int_id.h"
 #include "item_contents.h"
 #include "item_location.h"
@@ -349,40 +350,40 @@ static const trait_id trait_WEB_SPINNER( "WEB_SPINNER" );
 static const trait_id trait_WEB_WALKER( "WEB_WALKER" );
 static const trait_id trait_WEB_WEAVER( "WEB_WEAVER" );
 
-static const std::string flag_ACTIVE_CLOAKING( "ACTIVE_CLOAKING" );
-static const std::string flag_ALLOWS_NATURAL_ATTACKS( "ALLOWS_NATURAL_ATTACKS" );
-static const std::string flag_AURA( "AURA" );
-static const std::string flag_BELTED( "BELTED" );
-static const std::string flag_BLIND( "BLIND" );
-static const std::string flag_DEAF( "DEAF" );
-static const std::string flag_DISABLE_SIGHTS( "DISABLE_SIGHTS" );
-static const std::string flag_EFFECT_IMPEDING( "EFFECT_IMPEDING" );
-static const std::string flag_EFFECT_INVISIBLE( "EFFECT_INVISIBLE" );
-static const std::string flag_EFFECT_NIGHT_VISION( "EFFECT_NIGHT_VISION" );
-static const std::string flag_FIX_NEARSIGHT( "FIX_NEARSIGHT" );
-static const std::string flag_FUNGUS( "FUNGUS" );
-static const std::string flag_GNV_EFFECT( "GNV_EFFECT" );
-static const std::string flag_HELMET_COMPAT( "HELMET_COMPAT" );
-static const std::string flag_IR_EFFECT( "IR_EFFECT" );
-static const std::string flag_ONLY_ONE( "ONLY_ONE" );
-static const std::string flag_OUTER( "OUTER" );
-static const std::string flag_OVERSIZE( "OVERSIZE" );
-static const std::string flag_PARTIAL_DEAF( "PARTIAL_DEAF" );
-static const std::string flag_PERPETUAL( "PERPETUAL" );
-static const std::string flag_PERSONAL( "PERSONAL" );
-static const std::string flag_PLOWABLE( "PLOWABLE" );
-static const std::string flag_POWERARMOR_COMPATIBLE( "POWERARMOR_COMPATIBLE" );
-static const std::string flag_RESTRICT_HANDS( "RESTRICT_HANDS" );
-static const std::string flag_SEMITANGIBLE( "SEMITANGIBLE" );
-static const std::string flag_SKINTIGHT( "SKINTIGHT" );
-static const std::string flag_SPEEDLOADER( "SPEEDLOADER" );
-static const std::string flag_SPLINT( "SPLINT" );
-static const std::string flag_TOURNIQUET( "TOURNIQUET" );
-static const std::string flag_STURDY( "STURDY" );
-static const std::string flag_SWIMMABLE( "SWIMMABLE" );
-static const std::string flag_SWIM_GOGGLES( "SWIM_GOGGLES" );
-static const std::string flag_UNDERSIZE( "UNDERSIZE" );
-static const std::string flag_USE_UPS( "USE_UPS" );
+static const flag_id flag_ACTIVE_CLOAKING( "ACTIVE_CLOAKING" );
+static const flag_id flag_ALLOWS_NATURAL_ATTACKS( "ALLOWS_NATURAL_ATTACKS" );
+static const flag_id flag_AURA( "AURA" );
+static const flag_id flag_BELTED( "BELTED" );
+static const flag_id flag_BLIND( "BLIND" );
+static const flag_id flag_DEAF( "DEAF" );
+static const flag_id flag_DISABLE_SIGHTS( "DISABLE_SIGHTS" );
+static const flag_id flag_EFFECT_IMPEDING( "EFFECT_IMPEDING" );
+static const flag_id flag_EFFECT_INVISIBLE( "EFFECT_INVISIBLE" );
+static const flag_id flag_EFFECT_NIGHT_VISION( "EFFECT_NIGHT_VISION" );
+static const flag_id flag_FIX_NEARSIGHT( "FIX_NEARSIGHT" );
+static const flag_id flag_FUNGUS( "FUNGUS" );
+static const flag_id flag_GNV_EFFECT( "GNV_EFFECT" );
+static const flag_id flag_HELMET_COMPAT( "HELMET_COMPAT" );
+static const flag_id flag_IR_EFFECT( "IR_EFFECT" );
+static const flag_id flag_ONLY_ONE( "ONLY_ONE" );
+static const flag_id flag_OUTER( "OUTER" );
+static const flag_id flag_OVERSIZE( "OVERSIZE" );
+static const flag_id flag_PARTIAL_DEAF( "PARTIAL_DEAF" );
+static const flag_id flag_PERPETUAL( "PERPETUAL" );
+static const flag_id flag_PERSONAL( "PERSONAL" );
+static const flag_id flag_PLOWABLE( "PLOWABLE" );
+static const flag_id flag_POWERARMOR_COMPATIBLE( "POWERARMOR_COMPATIBLE" );
+static const flag_id flag_RESTRICT_HANDS( "RESTRICT_HANDS" );
+static const flag_id flag_SEMITANGIBLE( "SEMITANGIBLE" );
+static const flag_id flag_SKINTIGHT( "SKINTIGHT" );
+static const flag_id flag_SPEEDLOADER( "SPEEDLOADER" );
+static const flag_id flag_SPLINT( "SPLINT" );
+static const flag_id flag_TOURNIQUET( "TOURNIQUET" );
+static const flag_id flag_STURDY( "STURDY" );
+static const flag_id flag_SWIMMABLE( "SWIMMABLE" );
+static const flag_id flag_SWIM_GOGGLES( "SWIM_GOGGLES" );
+static const flag_id flag_UNDERSIZE( "UNDERSIZE" );
+static const flag_id flag_USE_UPS( "USE_UPS" );
 
 static const mtype_id mon_player_blob( "mon_player_blob" );
 static const mtype_id mon_shadow_snake( "mon_shadow_snake" );
@@ -894,6 +895,7 @@ void Character::react_to_felt_pain( int intensity )
 void Character::action_taken()
 {
     nv_cached = false;
+    invalidate_carried_totals();
 }
 
 int Character::swim_speed() const
@@ -1989,14 +1991,43 @@ float Character::get_vision_threshold( float light_level ) const
                      threshold_for_range( range ) * dimming_from_light );
 }
 
+// worn is changed directly in many places, so caches that depend on it remember which items
+// it held
+static std::vector<std::pair<const item *, itype_id>> worn_snapshot( const std::list<item> &worn )
+{
+    std::vector<std::pair<const item *, itype_id>> result;
+    result.reserve( worn.size() );
+    for( const item &w : worn ) {
+        result.emplace_back( &w, w.typeId() );
+    }
+    return result;
+}
+
+static bool same_worn( const std::list<item> &worn,
+                       const std::vector<std::pair<const item *, itype_id>> &snapshot )
+{
+    if( snapshot.size() != worn.size() ) {
+        return false;
+    }
+    auto cached = snapshot.begin();
+    for( const item &w : worn ) {
+        if( cached->first != &w || cached->second != w.typeId() ) {
+            return false;
+        }
+        ++cached;
+    }
+    return true;
+}
+
 void Character::flag_encumbrance()
 {
     check_encumbrance = true;
+    invalidate_carried_totals();
 }
 
 void Character::check_item_encumbrance_flag()
 {
-    bool update_required = check_encumbrance;
+    bool update_required = check_encumbrance || !same_worn( worn, encumbrance_worn );
     for( auto &i : worn ) {
         if( !update_required && i.encumbrance_update_ ) {
             update_required = true;
@@ -3014,7 +3045,19 @@ std::vector<item_location> Character::find_reloadables()
 
 units::mass Character::weight_carried() const
 {
-    return weight_carried_with_tweaks( item_tweaks() );
+    const carried_totals &totals = get_carried_totals();
+    return add_wielded_weight( totals.worn_weight, totals.wielded_weight );
+}
+
+units::mass Character::add_wielded_weight( const units::mass &worn_weight,
+        const units::mass &wielded_weight ) const
+{
+    // Exclude wielded item if using lifting tool
+    if( ( wielded_weight + worn_weight <= weight_capacity() ) || ( g->new_game ||
+            best_nearby_lifting_assist() < wielded_weight ) ) {
+        return worn_weight + wielded_weight;
+    }
+    return worn_weight;
 }
 
 units::mass Character::best_nearby_lifting_assist() const
@@ -3085,13 +3128,7 @@ units::mass Character::weight_carried_with_tweaks( const item_tweaks &tweaks ) c
         weaponweight += weapon.weight() - get_selected_stack_weight( &weapon, without );
     }
 
-    // Exclude wielded item if using lifting tool
-    if( ( weaponweight + ret <= weight_capacity() ) || ( g->new_game ||
-            best_nearby_lifting_assist() < weaponweight ) ) {
-        ret += weaponweight;
-    }
-
-    return ret;
+    return add_wielded_weight( ret, weaponweight );
 }
 
 units::mass Character::get_selected_stack_weight( const item *i,
@@ -3541,8 +3578,13 @@ bool Character::is_wearing_on_bp( const itype_id &it, const bodypart_id &bp ) co
 
 bool Character::worn_with_flag( const std::string &flag, const bodypart_id &bp ) const
 {
-    return std::any_of( worn.begin(), worn.end(), [&flag, bp]( const item & it ) {
-        return it.has_flag( flag ) && ( bp == bodypart_id( "num_bp" ) || bp == bodypart_id() ||
+    const cata::optional<flag_id> found = flag_id::lookup( flag );
+    if( !found ) {
+        return false;
+    }
+    const flag_id id = *found;
+    return std::any_of( worn.begin(), worn.end(), [&id, bp]( const item & it ) {
+        return it.has_flag( id ) && ( bp == bodypart_id( "num_bp" ) || bp == bodypart_id() ||
                                         it.covers( bp ) );
     } );
 }
@@ -3550,8 +3592,13 @@ bool Character::worn_with_flag( const std::string &flag, const bodypart_id &bp )
 item Character::item_worn_with_flag( const std::string &flag, const bodypart_id &bp ) const
 {
     item it_with_flag;
+    const cata::optional<flag_id> found = flag_id::lookup( flag );
+    if( !found ) {
+        return it_with_flag;
+    }
+    const flag_id id = *found;
     for( const item &it : worn ) {
-        if( it.has_flag( flag ) && ( bp == bodypart_id( "num_bp" ) || bp == bodypart_id() ||
+        if( it.has_flag( id ) && ( bp == bodypart_id( "num_bp" ) || bp == bodypart_id() ||
                                      it.covers( bp ) ) ) {
             it_with_flag = it;
             break;
@@ -3919,11 +3966,15 @@ bool Character::has_nv()
 void Character::calc_encumbrance()
 {
     calc_encumbrance( item() );
+    check_encumbrance = false;
+    encumbrance_worn = worn_snapshot( worn );
 }
 
 void Character::calc_encumbrance( const item &new_item )
 {
-
+    // This only runs when encumbrance was flagged or worn items changed, not every turn, so the
+    // map is cheap enough. It is kept apart from the stored values so check_carried_caches() can
+    // compute encumbrance without changing them.
     std::map<bodypart_id, encumbrance_data> enc;
     item_encumb( enc, new_item );
     mut_cbm_encumb( enc );
@@ -9645,30 +9696,105 @@ void Character::update_morale()
 
 units::volume Character::free_space() const
 {
-    units::volume volume_capacity = 0_ml;
-    volume_capacity += weapon.get_total_capacity();
+    return get_carried_totals().free_space;
+}
+
+units::volume Character::volume_capacity() const
+{
+    return get_carried_totals().volume_capacity;
+}
+
+Character::carried_totals Character::compute_carried_totals() const
+{
+    carried_totals totals;
+    totals.wielded_weight = weapon.weight();
+    totals.volume_capacity = weapon.contents.total_container_capacity();
+    totals.free_space = weapon.get_total_capacity();
     for( const item *it : weapon.contents.all_items_top( item_pocket::pocket_type::CONTAINER ) ) {
-        volume_capacity -= it->volume();
+        totals.free_space -= it->volume();
     }
-    volume_capacity += weapon.check_for_free_space( &weapon );
+    totals.free_space += weapon.check_for_free_space( &weapon );
     for( const item &w : worn ) {
-        volume_capacity += w.get_total_capacity();
+        totals.worn_weight += w.weight();
+        totals.volume_capacity += w.contents.total_container_capacity();
+        totals.free_space += w.get_total_capacity();
         for( const item *it : w.contents.all_items_top( item_pocket::pocket_type::CONTAINER ) ) {
-            volume_capacity -= it->volume();
+            totals.free_space -= it->volume();
         }
-        volume_capacity += w.check_for_free_space( &w );
+        totals.free_space += w.check_for_free_space( &w );
     }
-    return volume_capacity;
+    return totals;
 }
 
-units::volume Character::volume_capacity() const
+const Character::carried_totals &Character::get_carried_totals() const
 {
-    units::volume volume_capacity = 0_ml;
-    volume_capacity += weapon.contents.total_container_capacity();
+    size_t contents_changes = weapon.contents.changes();
     for( const item &w : worn ) {
-        volume_capacity += w.contents.total_container_capacity();
+        cata::hash_combine( contents_changes, w.contents.changes() );
     }
-    return volume_capacity;
+    if( !carried_cache || carried_cache_contents_changes != contents_changes ||
+        carried_cache_turn != calendar::turn || carried_cache_wielded_type != weapon.typeId() ||
+        carried_cache_wielded_charges != weapon.charges || !same_worn( worn, carried_cache_worn ) ) {
+        carried_cache = compute_carried_totals();
+        carried_cache_contents_changes = contents_changes;
+        carried_cache_turn = calendar::turn;
+        carried_cache_worn = worn_snapshot( worn );
+        carried_cache_wielded_type = weapon.typeId();
+        carried_cache_wielded_charges = weapon.charges;
+    }
+    return *carried_cache;
+}
+
+void Character::invalidate_carried_totals()
+{
+    carried_cache.reset();
+}
+
+bool Character::check_carried_caches() const
+{
+    bool consistent = true;
+    const carried_totals cached = get_carried_totals();
+    const carried_totals actual = compute_carried_totals();
+    if( cached.worn_weight != actual.worn_weight ) {
+        debugmsg( "%s: cached weight of worn items is %d g, should be %d g", name,
+                  units::to_gram( cached.worn_weight ), units::to_gram( actual.worn_weight ) );
+        consistent = false;
+    }
+    if( cached.wielded_weight != actual.wielded_weight ) {
+        debugmsg( "%s: cached weight of the wielded item is %d g, should be %d g", name,
+                  units::to_gram( cached.wielded_weight ), units::to_gram( actual.wielded_weight ) );
+        consistent = false;
+    }
+    if( cached.volume_capacity != actual.volume_capacity ) {
+        debugmsg( "%s: cached volume capacity is %d ml, should be %d ml", name,
+                  units::to_milliliter( cached.volume_capacity ),
+                  units::to_milliliter( actual.volume_capacity ) );
+        consistent = false;
+    }
+    if( cached.free_space != actual.free_space ) {
+        debugmsg( "%s: cached free space is %d ml, should be %d ml", name,
+                  units::to_milliliter( cached.free_space ), units::to_milliliter( actual.free_space ) );
+        consistent = false;
+    }
+
+    // Encumbrance flagged for an update is recalculated by check_item_encumbrance_flag.
+    bool encumbrance_flagged = check_encumbrance || !same_worn( worn, encumbrance_worn );
+    for( const item &w : worn ) {
+        encumbrance_flagged = encumbrance_flagged || w.encumbrance_update_;
+    }
+    if( !encumbrance_flagged ) {
+        std::map<bodypart_id, encumbrance_data> enc;
+        item_encumb( enc, item() );
+        mut_cbm_encumb( enc );
+        for( const std::pair<const bodypart_id, encumbrance_data> &elem : enc ) {
+            if( encumb( elem.first ) != elem.second.encumbrance ) {
+                debugmsg( "%s: cached encumbrance of %s is %d, should be %d", name,
+                          body_part_name( elem.first ), encumb( elem.first ), elem.second.encumbrance );
+                consistent = false;
+            }
+        }
+    }
+    return consistent;
 }
 
 units::volume Character::volume_capacity_with_tweaks( const
@@ -10265,18 +10391,28 @@ bool Character::in_sleep_state() const
 
 bool Character::has_item_with_flag( const std::string &flag, bool need_charges ) const
 {
-    return has_item_with( [&flag, &need_charges]( const item & it ) {
+    const cata::optional<flag_id> found = flag_id::lookup( flag );
+    if( !found ) {
+        return false;
+    }
+    const flag_id id = *found;
+    return has_item_with( [&id, &need_charges]( const item & it ) {
         if( it.is_tool() && need_charges ) {
-            return it.has_flag( flag ) && it.type->tool->max_charges ? it.charges > 0 : it.has_flag( flag );
+            return it.has_flag( id ) && it.type->tool->max_charges ? it.charges > 0 : it.has_flag( id );
         }
-        return it.has_flag( flag );
+        return it.has_flag( id );
     } );
 }
 
 std::vector<const item *> Character::all_items_with_flag( const std::string &flag ) const
 {
-    return items_with( [&flag]( const item & it ) {
-        return it.has_flag( flag );
+    const cata::optional<flag_id> found = flag_id::lookup( flag );
+    if( !found ) {
+        return {};
+    }
+    const flag_id id = *found;
+    return items_with( [&id]( const item & it ) {
+        return it.has_flag( id );
     } );
 }
 
@@ -10602,11 +10738,13 @@ void Character::on_worn_item_washed( const item &it )
 void Character::on_item_wear( const item &it )
 {
     morale->on_item_wear( it );
+    flag_encumbrance();
 }
 
 void Character::on_item_takeoff( const item &it )
 {
     morale->on_item_takeoff( it );
+    flag_encumbrance();
 }
 
 void Character::on_effect_int_change( const efftype_id &eid, int intensity, body_part bp )
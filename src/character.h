@@ -1470,6 +1470,12 @@ class Character : public Creature, public visitable<Character>
         units::volume volume_capacity_with_tweaks( const std::vector<std::pair<item_location, int>>
                 &locations ) const;
         units::volume free_space() const;
+        /**
+         * Recomputes carried weight, volume and encumbrance from scratch and compares them with the
+         * cached values, showing a debug message for each difference.
+         * @returns true if the caches were up to date.
+         */
+        bool check_carried_caches() const;
 
 
         /** Note that we've read a book at least once. **/
@@ -2549,6 +2555,8 @@ class Character : public Creature, public visitable<Character>
         int fatigue;
         int sleep_deprivation;
         bool check_encumbrance = true;
+        /** The worn items encumbrance was last calculated for. */
+        std::vector<std::pair<const item *, itype_id>> encumbrance_worn;
 
         int stim;
         int pkill;
@@ -2576,6 +2584,34 @@ class Character : public Creature, public visitable<Character>
         /** Amount of time the player has spent in each overmap tile. */
         std::unordered_map<point_abs_omt, time_duration> overmap_time;
 
+        /** Weight and volume of everything worn and wielded, without any @ref item_tweaks. */
+        struct carried_totals {
+            units::mass worn_weight = 0_gram;
+            units::mass wielded_weight = 0_gram;
+            units::volume volume_capacity = 0_ml;
+            units::volume free_space = 0_ml;
+        };
+        /**
+         * Items don't know who carries them, so instead of being updated item by item the totals
+         * are thrown away when the contents of a worn or wielded item change (see
+         * @ref item_contents::changes), when the turn passes, when worn items or the wielded item
+         * are swapped and after actions.
+         */
+        mutable cata::optional<carried_totals> carried_cache;
+        mutable size_t carried_cache_contents_changes = 0;
+        mutable time_point carried_cache_turn = calendar::before_time_starts;
+        mutable std::vector<std::pair<const item *, itype_id>> carried_cache_worn;
+        mutable itype_id carried_cache_wielded_type;
+        mutable int carried_cache_wielded_charges = 0;
+
+        /** Returns the cached totals, recomputing them if anything they depend on changed. */
+        const carried_totals &get_carried_totals() const;
+        carried_totals compute_carried_totals() const;
+        void invalidate_carried_totals();
+        /** Adds the wielded weight to the worn weight unless a lifting tool takes it. */
+        units::mass add_wielded_weight( const units::mass &worn_weight,
+                                        const units::mass &wielded_weight ) const;
+
     public:
         time_point next_climate_control_check;
         bool last_climate_control_ret;
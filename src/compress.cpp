@@ -0,0 +1,138 @@
+#include "compress.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+// Tags below this start a run of (tag + 1) literal bytes, the others a back reference
+// of (tag - match_tag + min_match) bytes, followed by the distance as a varint.
+static constexpr unsigned char match_tag = 0x80;
+static constexpr size_t max_literals = match_tag;
+static constexpr size_t min_match = 4;
+static constexpr size_t max_match = 0xff - match_tag + min_match;
+static constexpr int hash_bits = 15;
+
+void write_varint( std::string &out, uint64_t value )
+{
+    while( value >= 0x80 ) {
+        out.push_back( static_cast<char>( ( value & 0x7f ) | 0x80 ) );
+        value >>= 7;
+    }
+    out.push_back( static_cast<char>( value ) );
+}
+
+uint64_t read_varint( const std::string &in, size_t &pos )
+{
+    uint64_t result = 0;
+    for( int shift = 0; shift < 64; shift += 7 ) {
+        if( pos >= in.size() ) {
+            throw std::runtime_error( "unexpected end of data in varint" );
+        }
+        const unsigned char byte = static_cast<unsigned char>( in[pos++] );
+        result |= static_cast<uint64_t>( byte & 0x7f ) << shift;
+        if( !( byte & 0x80 ) ) {
+            return result;
+        }
+    }
+    throw std::runtime_error( "varint too long" );
+}
+
+static uint32_t hash_at( const char *p )
+{
+    uint32_t v;
+    std::memcpy( &v, p, sizeof( v ) );
+    return ( v * 2654435761u ) >> ( 32 - hash_bits );
+}
+
+static void write_literals( std::string &out, const char *begin, size_t count )
+{
+    while( count > 0 ) {
+        const size_t run = std::min( count, max_literals );
+        out.push_back( static_cast<char>( run - 1 ) );
+        out.append( begin, run );
+        begin += run;
+        count -= run;
+    }
+}
+
+std::string compress_lz( const std::string &input )
+{
+    std::string out;
+    out.reserve( input.size() / 2 + 16 );
+    write_varint( out, input.size() );
+
+    const char *const data = input.data();
+    const size_t size = input.size();
+    // Last position at which each hash of four bytes was seen
+    std::vector<int64_t> last_seen( size_t( 1 ) << hash_bits, -1 );
+    size_t literal_start = 0;
+    size_t pos = 0;
+    while( pos + min_match <= size ) {
+        const uint32_t h = hash_at( data + pos );
+        const int64_t candidate = last_seen[h];
+        last_seen[h] = static_cast<int64_t>( pos );
+        if( candidate < 0 || std::memcmp( data + candidate, data + pos, min_match ) != 0 ) {
+            pos++;
+            continue;
+        }
+        size_t length = min_match;
+        while( pos + length < size && length < max_match &&
+               data[candidate + length] == data[pos + length] ) {
+            length++;
+        }
+        write_literals( out, data + literal_start, pos - literal_start );
+        out.push_back( static_cast<char>( match_tag + length - min_match ) );
+        write_varint( out, pos - candidate );
+        // Remember the positions inside the match too, they are likely to repeat
+        for( size_t i = pos + 1; i < pos + length && i + min_match <= size; i++ ) {
+            last_seen[hash_at( data + i )] = static_cast<int64_t>( i );
+        }
+        pos += length;
+        literal_start = pos;
+    }
+    write_literals( out, data + literal_start, size - literal_start );
+    return out;
+}
+
+std::string decompress_lz( const std::string &input )
+{
+    size_t pos = 0;
+    const uint64_t size = read_varint( input, pos );
+    // Every byte of input yields at most max_match bytes of output, so this guards against
+    // allocating absurd amounts of memory for corrupt data
+    if( size > ( input.size() - pos ) * max_match ) {
+        throw std::runtime_error( "compressed data is corrupt, invalid size" );
+    }
+    std::string out;
+    out.reserve( size );
+    while( pos < input.size() ) {
+        const unsigned char tag = static_cast<unsigned char>( input[pos++] );
+        if( tag < match_tag ) {
+            const size_t count = tag + 1;
+            if( pos + count > input.size() ) {
+                throw std::runtime_error( "compressed data is corrupt, literals out of bounds" );
+            }
+            out.append( input, pos, count );
+            pos += count;
+        } else {
+            const size_t length = tag - match_tag + min_match;
+            const uint64_t distance = read_varint( input, pos );
+            if( distance == 0 || distance > out.size() ) {
+                throw std::runtime_error( "compressed data is corrupt, reference out of bounds" );
+            }
+            // Byte by byte, the reference may overlap the bytes it produces
+            size_t from = out.size() - distance;
+            for( size_t i = 0; i < length; i++ ) {
+                out.push_back( out[from++] );
+            }
+        }
+        if( out.size() > size ) {
+            throw std::runtime_error( "compressed data is corrupt, too much output" );
+        }
+    }
+    if( out.size() != size ) {
+        throw std::runtime_error( "compressed data is corrupt, output truncated" );
+    }
+    return out;
+}
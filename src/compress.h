@@ -0,0 +1,30 @@
+#pragma once
+#ifndef CATA_SRC_COMPRESS_H
+#define CATA_SRC_COMPRESS_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Small LZ77 style compressor for savefiles, so we don't need an external library.
+ *
+ * The output starts with the size of the uncompressed data, followed by a series of
+ * literal runs and back references. It's fast rather than small, savefiles are
+ * repetitive enough that this gets most of the way.
+ */
+std::string compress_lz( const std::string &input );
+/**
+ * Reverses @ref compress_lz.
+ * @throws std::runtime_error if the input is not valid compressed data.
+ */
+std::string decompress_lz( const std::string &input );
+
+// LEB128 variable length integers, also used by the binary savefile formats.
+void write_varint( std::string &out, uint64_t value );
+/**
+ * Reads a variable length integer starting at pos and advances pos past it.
+ * @throws std::runtime_error if the data ends before the integer does.
+ */
+uint64_t read_varint( const std::string &in, size_t &pos );
+
+#endif // CATA_SRC_COMPRESS_H
@@ -2,10 +2,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <ostream>
 #include <string>
+#include <tuple>
 #include <utility>
 
+#include "cata_utility.h"
 #include "debug.h"
 #include "mongroup.h"
 #include "monster.h"
@@ -31,6 +34,106 @@ shared_ptr_fast<monster> Creature_tracker::find( const tripoint &pos ) const
     return nullptr;
 }
 
+tripoint Creature_tracker::cell_of( const tripoint &p )
+{
+    return tripoint( divide_round_down( p.x, cell_size ), divide_round_down( p.y, cell_size ), p.z );
+}
+
+void Creature_tracker::add_to_location_map( const tripoint &p,
+        const shared_ptr_fast<monster> &critter )
+{
+    const auto iter = monsters_by_location.find( p );
+    if( iter != monsters_by_location.end() ) {
+        erase_from_location_map( iter );
+    }
+    monsters_by_location.emplace( p, critter );
+    monsters_by_cell[cell_of( p )].emplace_back( p, critter.get() );
+}
+
+void Creature_tracker::erase_from_location_map( decltype( monsters_by_location )::iterator iter )
+{
+    const auto cell_iter = monsters_by_cell.find( cell_of( iter->first ) );
+    if( cell_iter != monsters_by_cell.end() ) {
+        std::vector<std::pair<tripoint, monster *>> &cell = cell_iter->second;
+        const auto entry = std::find_if( cell.begin(), cell.end(),
+        [&]( const std::pair<tripoint, monster *> &e ) {
+            return e.first == iter->first;
+        } );
+        if( entry != cell.end() ) {
+            // Order within a cell does not matter, queries sort their results.
+            *entry = cell.back();
+            cell.pop_back();
+        }
+        if( cell.empty() ) {
+            monsters_by_cell.erase( cell_iter );
+        }
+    }
+    monsters_by_location.erase( iter );
+}
+
+std::vector<monster *> Creature_tracker::find_in_rectangle( const tripoint &min,
+        const tripoint &max ) const
+{
+    std::vector<std::pair<tripoint, monster *>> found;
+    const auto collect = [&]( const std::vector<std::pair<tripoint, monster *>> &cell ) {
+        for( const std::pair<tripoint, monster *> &e : cell ) {
+            const tripoint &p = e.first;
+            if( p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y &&
+                p.z >= min.z && p.z <= max.z && !e.second->is_dead() ) {
+                found.push_back( e );
+            }
+        }
+    };
+    const tripoint min_cell = cell_of( min );
+    const tripoint max_cell = cell_of( max );
+    const int64_t cells = static_cast<int64_t>( max_cell.x - min_cell.x + 1 ) *
+                          ( max_cell.y - min_cell.y + 1 ) * ( max_cell.z - min_cell.z + 1 );
+    if( cells <= 0 ) {
+        return {};
+    }
+    if( cells > static_cast<int64_t>( monsters_by_cell.size() ) ) {
+        // Large areas: cheaper to look at each occupied cell than at each cell in the area.
+        for( const auto &cell : monsters_by_cell ) {
+            const tripoint &c = cell.first;
+            if( c.x >= min_cell.x && c.x <= max_cell.x && c.y >= min_cell.y && c.y <= max_cell.y &&
+                c.z >= min_cell.z && c.z <= max_cell.z ) {
+                collect( cell.second );
+            }
+        }
+    } else {
+        for( int z = min_cell.z; z <= max_cell.z; ++z ) {
+            for( int y = min_cell.y; y <= max_cell.y; ++y ) {
+                for( int x = min_cell.x; x <= max_cell.x; ++x ) {
+                    const auto iter = monsters_by_cell.find( tripoint( x, y, z ) );
+                    if( iter != monsters_by_cell.end() ) {
+                        collect( iter->second );
+                    }
+                }
+            }
+        }
+    }
+    // Neither the hash map nor the cells have a stable order, so sort the way
+    // points_in_rectangle would visit the positions.
+    std::sort( found.begin(), found.end(), []( const std::pair<tripoint, monster *> &lhs,
+    const std::pair<tripoint, monster *> &rhs ) {
+        return std::tie( lhs.first.z, lhs.first.y, lhs.first.x ) <
+               std::tie( rhs.first.z, rhs.first.y, rhs.first.x );
+    } );
+    std::vector<monster *> result;
+    result.reserve( found.size() );
+    for( const std::pair<tripoint, monster *> &e : found ) {
+        result.push_back( e.second );
+    }
+    return result;
+}
+
+std::vector<monster *> Creature_tracker::find_in_radius( const tripoint &center, int radius,
+        int radiusz ) const
+{
+    return find_in_rectangle( center - tripoint( radius, radius, radiusz ),
+                              center + tripoint( radius, radius, radiusz ) );
+}
+
 int Creature_tracker::temporary_id( const monster &critter ) const
 {
     const auto iter = std::find_if( monsters_list.begin(), monsters_list.end(),
@@ -85,7 +188,7 @@ bool Creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos()] = critter_ptr;
+    add_to_location_map( critter.pos(), critter_ptr );
     add_to_faction_map( critter_ptr );
     return true;
 }
@@ -130,13 +233,25 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         }
     }
 
+    // Usually the monster is filed under its current position, which saves searching the whole list.
+    const auto loc_iter = monsters_by_location.find( critter.pos() );
+    if( loc_iter != monsters_by_location.end() && loc_iter->second.get() == &critter ) {
+        const shared_ptr_fast<monster> critter_ptr = loc_iter->second;
+        erase_from_location_map( loc_iter );
+        add_to_location_map( new_pos, critter_ptr );
+        return true;
+    }
+
     const auto iter = std::find_if( monsters_list.begin(), monsters_list.end(),
     [&]( const shared_ptr_fast<monster> &ptr ) {
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( critter.pos() );
-        monsters_by_location[new_pos] = *iter;
+        const auto old_iter = monsters_by_location.find( critter.pos() );
+        if( old_iter != monsters_by_location.end() ) {
+            erase_from_location_map( old_iter );
+        }
+        add_to_location_map( new_pos, *iter );
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -155,7 +270,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_from_location_map( pos_iter );
         return;
     }
 
@@ -166,7 +281,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_from_location_map( iter );
     }
 }
 
@@ -199,6 +314,7 @@ void Creature_tracker::clear()
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_cell.clear();
     monster_faction_map_.clear();
     removed_.clear();
 }
@@ -206,9 +322,10 @@ void Creature_tracker::clear()
 void Creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    monsters_by_cell.clear();
     monster_faction_map_.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        add_to_location_map( mon_ptr->pos(), mon_ptr );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -221,19 +338,20 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
 
     // Either of them may be invalid!
     const auto first_iter = monsters_by_location.find( first.pos() );
-    const auto second_iter = monsters_by_location.find( second.pos() );
     // implied: first_iter != second_iter
 
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_from_location_map( first_iter );
     }
 
+    // Looked up only now, erasing the first entry may have invalidated iterators.
+    const auto second_iter = monsters_by_location.find( second.pos() );
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_from_location_map( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -243,10 +361,10 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos()] = first_ptr;
+        add_to_location_map( first.pos(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos()] = second_ptr;
+        add_to_location_map( second.pos(), second_ptr );
     }
 }
 
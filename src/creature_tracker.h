@@ -6,6 +6,7 @@
 #include <memory>
 #include <unordered_map>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include "point.h"
@@ -83,6 +84,14 @@ class Creature_tracker
         const std::vector<shared_ptr_fast<monster>> &get_monsters_list() const {
             return monsters_list;
         }
+        /**
+         * Returns the living monsters in the box from @p min to @p max (both inclusive).
+         * They are ordered by position (z, then y, then x), like iterating the box point by point.
+         */
+        std::vector<monster *> find_in_rectangle( const tripoint &min, const tripoint &max ) const;
+        /** Same as @ref find_in_rectangle with the box of the given radii around @p center. */
+        std::vector<monster *> find_in_radius( const tripoint &center, int radius,
+                                               int radiusz = 0 ) const;
 
         void serialize( JsonOut &jsout ) const;
         void deserialize( JsonIn &jsin );
@@ -94,6 +103,18 @@ class Creature_tracker
     private:
         std::vector<shared_ptr_fast<monster>> monsters_list;
         std::unordered_map<tripoint, shared_ptr_fast<monster>> monsters_by_location;
+        /** Side length of the squares @ref monsters_by_cell groups the monsters by. */
+        static constexpr int cell_size = 12;
+        /**
+         * The entries of @ref monsters_by_location again, grouped by the square (see @ref cell_of)
+         * they are in, so area queries only need to look at the monsters near them.
+         */
+        std::unordered_map<tripoint, std::vector<std::pair<tripoint, monster *>>> monsters_by_cell;
+        static tripoint cell_of( const tripoint &p );
+        /** Puts @p critter into @ref monsters_by_location (and @ref monsters_by_cell) at @p p. */
+        void add_to_location_map( const tripoint &p, const shared_ptr_fast<monster> &critter );
+        /** Erases an entry from @ref monsters_by_location (and @ref monsters_by_cell). */
+        void erase_from_location_map( decltype( monsters_by_location )::iterator iter );
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
 };
@@ -103,8 +103,50 @@ namespace
 
 std::set<std::string> ignored_messages;
 
+thread_local deferred_debugmsgs *current_deferred_debugmsgs = nullptr;
+// Stream returned by DebugLog while current_deferred_debugmsgs is set
+thread_local std::ostringstream deferred_log_stream;
+
 } // namespace
 
+deferred_debugmsgs::capture::capture( deferred_debugmsgs &target ) :
+    previous( current_deferred_debugmsgs )
+{
+    if( previous != nullptr ) {
+        previous->end_log_line();
+    }
+    current_deferred_debugmsgs = &target;
+}
+
+deferred_debugmsgs::capture::~capture()
+{
+    current_deferred_debugmsgs->end_log_line();
+    current_deferred_debugmsgs = previous;
+}
+
+void deferred_debugmsgs::end_log_line()
+{
+    if( !log.empty() ) {
+        log.back().text += deferred_log_stream.str();
+    }
+    deferred_log_stream.str( std::string() );
+    deferred_log_stream.clear();
+}
+
+void deferred_debugmsgs::replay()
+{
+    std::vector<log_line> to_log;
+    to_log.swap( log );
+    for( const log_line &line : to_log ) {
+        DebugLog( line.level, line.cl ) << line.text;
+    }
+    std::vector<message> to_report;
+    to_report.swap( messages );
+    for( const message &msg : to_report ) {
+        realDebugmsg( msg.filename.c_str(), msg.line.c_str(), msg.funcname.c_str(), msg.text );
+    }
+}
+
 void realDebugmsg( const char *filename, const char *line, const char *funcname,
                    const std::string &text )
 {
@@ -112,6 +154,11 @@ void realDebugmsg( const char *filename, const char *line, const char *funcname,
     assert( line != nullptr );
     assert( funcname != nullptr );
 
+    if( current_deferred_debugmsgs != nullptr ) {
+        current_deferred_debugmsgs->messages.push_back( { filename, line, funcname, text } );
+        return;
+    }
+
     DebugLog( D_ERROR, D_MAIN ) << filename << ":" << line << " [" << funcname << "] "
                                 << text << std::flush;
 
@@ -910,6 +957,12 @@ void debug_write_backtrace( std::ostream &out )
 
 std::ostream &DebugLog( DebugLevel lev, DebugClass cl )
 {
+    if( current_deferred_debugmsgs != nullptr ) {
+        current_deferred_debugmsgs->end_log_line();
+        current_deferred_debugmsgs->log.push_back( { lev, cl, std::string() } );
+        return deferred_log_stream;
+    }
+
     if( lev & D_ERROR ) {
         error_observed = true;
     }
@@ -203,6 +203,74 @@ bool debug_has_error_been_observed();
 // See documentation at the top.
 std::ostream &DebugLog( DebugLevel, DebugClass );
 
+/**
+ * Stores debugmsg and DebugLog calls instead of logging and showing them, so work running on
+ * other threads can report errors that are logged and shown later on the main thread with
+ * @ref replay.
+ * \code
+ * std::vector<deferred_debugmsgs> messages( count );
+ * parallel_for( count, [&]( size_t i ) {
+ *     deferred_debugmsgs::capture capture( messages[i] );
+ *     do_work( i );
+ * } );
+ * for( deferred_debugmsgs &msgs : messages ) {
+ *     msgs.replay();
+ * }
+ * \endcode
+ */
+class deferred_debugmsgs
+{
+    public:
+        /**
+         * While alive, debugmsg and DebugLog calls made on the thread that created it go to the
+         * target.
+         * Captures on one thread must be destroyed in reverse order of creation.
+         */
+        class capture
+        {
+            public:
+                explicit capture( deferred_debugmsgs &target );
+                ~capture();
+                capture( const capture & ) = delete;
+                capture &operator=( const capture & ) = delete;
+
+            private:
+                deferred_debugmsgs *previous;
+        };
+
+        bool empty() const {
+            return messages.empty() && log.empty();
+        }
+        /**
+         * Writes the stored log lines with DebugLog and reports the stored messages with
+         * debugmsg on the calling thread, then forgets them.
+         */
+        void replay();
+
+    private:
+        friend void realDebugmsg( const char *filename, const char *line, const char *funcname,
+                                  const std::string &text );
+        friend std::ostream &DebugLog( DebugLevel, DebugClass );
+
+        struct message {
+            std::string filename;
+            std::string line;
+            std::string funcname;
+            std::string text;
+        };
+        std::vector<message> messages;
+
+        struct log_line {
+            DebugLevel level;
+            DebugClass cl;
+            std::string text;
+        };
+        std::vector<log_line> log;
+        // Moves the text written to the last DebugLog stream into the last line
+        void end_log_line();
+};
+
+
 /**
  * Extended debugging mode, can be toggled during game.
  * If enabled some debug message in the normal player message log are shown,
@@ -88,6 +88,7 @@
 #include "string_input_popup.h"
 #include "trait_group.h"
 #include "translations.h"
+#include "turn_profiler.h"
 #include "type_id.h"
 #include "ui.h"
 #include "ui_manager.h"
@@ -181,6 +182,9 @@ std::string enum_to_string<debug_menu::debug_menu_index>( debug_menu::debug_menu
         case debug_menu::debug_menu_index::TEST_MAP_EXTRA_DISTRIBUTION: return "TEST_MAP_EXTRA_DISTRIBUTION";
         case debug_menu::debug_menu_index::NESTED_MAPGEN: return "NESTED_MAPGEN";
         case debug_menu::debug_menu_index::VEHICLE_BATTERY_CHARGE: return "VEHICLE_BATTERY_CHARGE";
+        case debug_menu::debug_menu_index::SIGHT_CACHE_STATS: return "SIGHT_CACHE_STATS";
+        case debug_menu::debug_menu_index::TURN_PROFILER: return "TURN_PROFILER";
+        case debug_menu::debug_menu_index::TURN_PROFILER_TRACE: return "TURN_PROFILER_TRACE";
         // *INDENT-ON*
         case debug_menu::debug_menu_index::last:
             break;
@@ -260,6 +264,9 @@ static int info_uilist( bool display_all_entries = true )
             { uilist_entry( debug_menu_index::PRINT_NPC_MAGIC, true, 'M', _( "Print NPC magic info to console" ) ) },
             { uilist_entry( debug_menu_index::TEST_WEATHER, true, 'W', _( "Test weather" ) ) },
             { uilist_entry( debug_menu_index::TEST_MAP_EXTRA_DISTRIBUTION, true, 'e', _( "Test map extra list" ) ) },
+            { uilist_entry( debug_menu_index::SIGHT_CACHE_STATS, true, 'C', _( "Show line of sight cache hit rate" ) ) },
+            { uilist_entry( debug_menu_index::TURN_PROFILER, true, 'P', _( "Toggle turn profiler" ) ) },
+            { uilist_entry( debug_menu_index::TURN_PROFILER_TRACE, true, 'X', _( "Toggle turn profile trace recording" ) ) },
         };
         uilist_initializer.insert( uilist_initializer.begin(), debug_only_options.begin(),
                                    debug_only_options.end() );
@@ -1207,6 +1214,9 @@ void debug()
         debug_menu_index::ENABLE_ACHIEVEMENTS,
         debug_menu_index::BENCHMARK,
         debug_menu_index::SHOW_MSG,
+        debug_menu_index::SIGHT_CACHE_STATS,
+        debug_menu_index::TURN_PROFILER,
+        debug_menu_index::TURN_PROFILER_TRACE,
     };
     bool should_disable_achievements = action && !non_cheaty_options.count( *action );
     if( should_disable_achievements && achievements.is_enabled() ) {
@@ -1327,6 +1337,9 @@ void debug()
             if( get_option<bool>( "STATS_THROUGH_KILLS" ) ) {
                 add_msg( m_info, _( "Kill xp: %d" ), player_character.kill_xp() );
             }
+            if( player_character.check_carried_caches() ) {
+                add_msg( m_info, _( "Carried weight, volume and encumbrance are up to date." ) );
+            }
             g->invalidate_main_ui_adaptor();
             g->disp_NPCs();
             break;
@@ -1955,6 +1968,41 @@ void debug()
             MapExtras::debug_spawn_test();
             break;
 
+        case debug_menu_index::SIGHT_CACHE_STATS: {
+            const map::sight_memo_stats &stats = here.get_sight_memo_stats();
+            const uint64_t lookups = stats.hits + stats.misses;
+            popup( _( "Line of sight checks: %1$d\nAnswered from the cache: %2$d (%3$.1f%%)\n"
+                      "Cache emptied for map changes: %4$d" ),
+                   lookups, stats.hits, lookups == 0 ? 0.0 : 100.0 * stats.hits / lookups,
+                   stats.invalidations );
+            break;
+        }
+
+        case debug_menu_index::TURN_PROFILER:
+            turn_profiler::set_enabled( !turn_profiler::enabled() );
+            if( turn_profiler::enabled() ) {
+                add_msg( m_info, _( "Turn profiler enabled.  "
+                                    "Show the \"Turn profile\" sidebar panel to see the results." ) );
+            } else {
+                add_msg( m_info, _( "Turn profiler disabled." ) );
+            }
+            break;
+
+        case debug_menu_index::TURN_PROFILER_TRACE:
+            if( turn_profiler::tracing() ) {
+                const std::string path = turn_profiler::default_trace_path();
+                const int events = turn_profiler::stop_trace( path );
+                if( events >= 0 ) {
+                    popup( _( "Wrote %1$d events to %2$s.\n"
+                              "Open it in chrome://tracing or Perfetto." ), events, path );
+                }
+            } else {
+                turn_profiler::start_trace();
+                add_msg( m_info,
+                         _( "Recording turn profile trace.  Use this option again to save it." ) );
+            }
+            break;
+
         case debug_menu_index::VEHICLE_BATTERY_CHARGE: {
 
             optional_vpart_position v_part_pos = here.veh_at( player_character.pos() );
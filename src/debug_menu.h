@@ -78,6 +78,9 @@ enum class debug_menu_index : int {
     TEST_MAP_EXTRA_DISTRIBUTION,
     NESTED_MAPGEN,
     VEHICLE_BATTERY_CHARGE,
+    SIGHT_CACHE_STATS,
+    TURN_PROFILER,
+    TURN_PROFILER_TRACE,
     last
 };
 
@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <cstring>
 #include <deque>
+#include <stdexcept>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -26,6 +27,11 @@
 #   include <unistd.h>
 #endif
 
+#if !defined(_WIN32)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#endif
+
 #if defined(_WIN32)
 #   include "platform_win.h"
 #endif
@@ -425,3 +431,79 @@ std::string ensure_valid_file_name( const std::string &file_name )
 
     return new_file_name;
 }
+
+#if defined(_WIN32)
+mapped_file::mapped_file( const std::string &path )
+{
+    HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( file == INVALID_HANDLE_VALUE ) {
+        throw std::runtime_error( "opening file failed" );
+    }
+    LARGE_INTEGER file_size;
+    if( !GetFileSizeEx( file, &file_size ) ) {
+        CloseHandle( file );
+        throw std::runtime_error( "reading file size failed" );
+    }
+    length = static_cast<size_t>( file_size.QuadPart );
+    if( length == 0 ) {
+        // Empty files can't be mapped
+        CloseHandle( file );
+        return;
+    }
+    mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    // The mapping keeps the file open
+    CloseHandle( file );
+    if( mapping == nullptr ) {
+        throw std::runtime_error( "mapping file failed" );
+    }
+    contents = static_cast<const char *>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+    if( contents == nullptr ) {
+        CloseHandle( mapping );
+        throw std::runtime_error( "mapping file failed" );
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if( contents != nullptr ) {
+        UnmapViewOfFile( contents );
+    }
+    if( mapping != nullptr ) {
+        CloseHandle( mapping );
+    }
+}
+#else
+mapped_file::mapped_file( const std::string &path )
+{
+    const int fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 ) {
+        throw std::runtime_error( "opening file failed" );
+    }
+    struct stat file_stat;
+    if( fstat( fd, &file_stat ) != 0 ) {
+        close( fd );
+        throw std::runtime_error( "reading file size failed" );
+    }
+    length = static_cast<size_t>( file_stat.st_size );
+    if( length == 0 ) {
+        // Empty files can't be mapped
+        close( fd );
+        return;
+    }
+    void *const mem = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+    // The mapping keeps the file open
+    close( fd );
+    if( mem == MAP_FAILED ) {
+        throw std::runtime_error( std::string( "mapping file failed: " ) + strerror( errno ) );
+    }
+    contents = static_cast<const char *>( mem );
+}
+
+mapped_file::~mapped_file()
+{
+    if( contents != nullptr ) {
+        munmap( const_cast<char *>( contents ), length );
+    }
+}
+#endif
@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_FILESYSTEM_H
 #define CATA_SRC_FILESYSTEM_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -52,6 +53,34 @@ std::vector<std::string> get_directories_with( const std::string &pattern,
 
 bool copy_file( const std::string &source_path, const std::string &dest_path );
 
+/**
+ * Read-only view of the whole content of a file, mapped into memory so parsers can scan it
+ * directly instead of copying it through a stream first.
+ * Throws std::runtime_error if the file can't be opened or mapped.
+ */
+class mapped_file
+{
+    public:
+        explicit mapped_file( const std::string &path );
+        ~mapped_file();
+        mapped_file( const mapped_file & ) = delete;
+        mapped_file &operator=( const mapped_file & ) = delete;
+
+        const char *data() const {
+            return contents;
+        }
+        size_t size() const {
+            return length;
+        }
+
+    private:
+        const char *contents = nullptr;
+        size_t length = 0;
+#if defined(_WIN32)
+        void *mapping = nullptr;
+#endif
+};
+
 /**
  *  Replace invalid characters in a string with a default character; can be used to ensure that a file name is compliant with most file systems.
  *  @param file_name Name of the file to check.
@@ -1,5 +1,7 @@
 #include "flag.h"
 
+#include <deque>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 
@@ -7,6 +9,163 @@
 #include "json.h"
 
 static std::unordered_map<std::string, json_flag> json_flags_all;
+// Same flags as above, indexed by flag_id::index()
+static std::vector<const json_flag *> json_flags_by_index;
+
+namespace
+{
+struct flag_names {
+    // A deque so the references handed out by flag_id::str stay valid
+    std::deque<std::string> names = { std::string() };
+    std::unordered_map<std::string, uint32_t> indices = { { std::string(), 0 } };
+    std::mutex mutex;
+};
+
+flag_names &get_flag_names()
+{
+    // Flags are interned while initializing statics of other translation units
+    static flag_names names;
+    return names;
+}
+} // namespace
+
+flag_id::flag_id( const std::string &id )
+{
+    flag_names &all = get_flag_names();
+    std::lock_guard<std::mutex> lock( all.mutex );
+    const auto iter = all.indices.find( id );
+    if( iter != all.indices.end() ) {
+        index_ = iter->second;
+        return;
+    }
+    index_ = static_cast<uint32_t>( all.names.size() );
+    all.names.push_back( id );
+    all.indices.emplace( id, index_ );
+}
+
+cata::optional<flag_id> flag_id::lookup( const std::string &id )
+{
+    flag_names &all = get_flag_names();
+    std::lock_guard<std::mutex> lock( all.mutex );
+    const auto iter = all.indices.find( id );
+    if( iter == all.indices.end() ) {
+        return cata::nullopt;
+    }
+    flag_id result;
+    result.index_ = iter->second;
+    return result;
+}
+
+const std::string &flag_id::str() const
+{
+    flag_names &all = get_flag_names();
+    std::lock_guard<std::mutex> lock( all.mutex );
+    return all.names[index_];
+}
+
+const json_flag &flag_id::obj() const
+{
+    return json_flag::get( *this );
+}
+
+flag_set::flag_set( const std::set<std::string> &flags )
+{
+    for( const std::string &flag : flags ) {
+        insert( flag );
+    }
+}
+
+bool flag_set::count( const std::string &flag ) const
+{
+    // Flags that were never interned can't be in any set, and don't need to be added
+    const cata::optional<flag_id> id = flag_id::lookup( flag );
+    return id && test( id->index() );
+}
+
+void flag_set::insert( const flag_id &flag )
+{
+    const size_t word = flag.index() / bits_per_word;
+    if( word >= words.size() ) {
+        words.resize( word + 1, 0 );
+    }
+    words[word] |= uint64_t( 1 ) << flag.index() % bits_per_word;
+}
+
+void flag_set::erase( const flag_id &flag )
+{
+    const size_t word = flag.index() / bits_per_word;
+    if( word >= words.size() ) {
+        return;
+    }
+    words[word] &= ~( uint64_t( 1 ) << flag.index() % bits_per_word );
+    while( !words.empty() && words.back() == 0 ) {
+        words.pop_back();
+    }
+}
+
+void flag_set::erase( const std::string &flag )
+{
+    if( count( flag ) ) {
+        erase( flag_id( flag ) );
+    }
+}
+
+size_t flag_set::size() const
+{
+    size_t result = 0;
+    for( uint64_t word : words ) {
+        for( ; word != 0; word &= word - 1 ) {
+            result++;
+        }
+    }
+    return result;
+}
+
+void flag_set::serialize( JsonOut &jsout ) const
+{
+    jsout.start_array();
+    for( const flag_id &flag : *this ) {
+        jsout.write( flag.str() );
+    }
+    jsout.end_array();
+}
+
+void flag_set::deserialize( JsonIn &jsin )
+{
+    clear();
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        insert( jsin.get_string() );
+    }
+}
+
+flag_set::const_iterator::const_iterator( const flag_set *set, const size_t index ) :
+    set( set ), index( index )
+{
+    find_flag();
+}
+
+flag_set::const_iterator &flag_set::const_iterator::operator++()
+{
+    index++;
+    find_flag();
+    return *this;
+}
+
+void flag_set::const_iterator::find_flag()
+{
+    const size_t end = set->words.size() * bits_per_word;
+    while( index < end ) {
+        const uint64_t rest = set->words[index / bits_per_word] >> index % bits_per_word;
+        if( rest & 1 ) {
+            current.index_ = static_cast<uint32_t>( index );
+            return;
+        }
+        // Skip the zero bits of this word in one go
+        index = rest == 0 ? ( index / bits_per_word + 1 ) * bits_per_word : index + 1;
+    }
+    index = end;
+}
 
 const json_flag &json_flag::get( const std::string &id )
 {
@@ -15,10 +174,22 @@ const json_flag &json_flag::get( const std::string &id )
     return iter != json_flags_all.end() ? iter->second : null_flag;
 }
 
+const json_flag &json_flag::get( const flag_id &id )
+{
+    static json_flag null_flag;
+    return id.index() < json_flags_by_index.size() && json_flags_by_index[id.index()] ?
+           *json_flags_by_index[id.index()] : null_flag;
+}
+
 void json_flag::load( const JsonObject &jo )
 {
     auto id = jo.get_string( "id" );
     auto &f = json_flags_all.emplace( id, json_flag( id ) ).first->second;
+    const flag_id index( id );
+    if( index.index() >= json_flags_by_index.size() ) {
+        json_flags_by_index.resize( index.index() + 1, nullptr );
+    }
+    json_flags_by_index[index.index()] = &f;
 
     jo.read( "info", f.info_ );
     jo.read( "conflicts", f.conflicts_ );
@@ -48,4 +219,5 @@ void json_flag::check_consistency()
 void json_flag::reset()
 {
     json_flags_all.clear();
+    json_flags_by_index.clear();
 }
@@ -2,10 +2,170 @@
 #ifndef CATA_SRC_FLAG_H
 #define CATA_SRC_FLAG_H
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "optional.h"
+
+class JsonIn;
 class JsonObject;
+class JsonOut;
+class json_flag;
+
+/**
+ * A flag name, interned to a small integer the first time it is seen.
+ * Any string can be a flag_id, not only the flags defined in json, as items carry
+ * all kinds of tags. The table of names is guarded by a mutex, so flags can be
+ * interned and looked up on any thread.
+ */
+class flag_id
+{
+    public:
+        /** The empty flag */
+        flag_id() = default;
+        explicit flag_id( const std::string &id );
+
+        /**
+         * The flag with this name, if it has been interned. Unlike the constructor it never
+         * adds the name to the table, so use it to check for names that may not be flags at all:
+         * a flag that was never interned can't be set anywhere.
+         */
+        static cata::optional<flag_id> lookup( const std::string &id );
+
+        const std::string &str() const;
+        /** So flags can still be passed to the functions taking them as strings */
+        operator const std::string &() const {
+            return str();
+        }
+
+        /** Flag definition from json (or the null flag if there is none) */
+        const json_flag &obj() const;
+
+        size_t index() const {
+            return index_;
+        }
+
+        bool operator==( const flag_id &rhs ) const {
+            return index_ == rhs.index_;
+        }
+        bool operator!=( const flag_id &rhs ) const {
+            return index_ != rhs.index_;
+        }
+        // Orders by index, not alphabetically
+        bool operator<( const flag_id &rhs ) const {
+            return index_ < rhs.index_;
+        }
+
+    private:
+        friend class flag_set;
+
+        uint32_t index_ = 0;
+};
+
+/**
+ * Set of flags stored as a bitset indexed by @ref flag_id, so membership tests are O(1).
+ * It mostly behaves like the std::set<std::string> it replaces. Iteration yields the
+ * flags in the order they were interned.
+ */
+class flag_set
+{
+    public:
+        class const_iterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = flag_id;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const flag_id *;
+                using reference = const flag_id &;
+
+                const_iterator( const flag_set *set, size_t index );
+
+                reference operator*() const {
+                    return current;
+                }
+                pointer operator->() const {
+                    return &current;
+                }
+                const_iterator &operator++();
+                const_iterator operator++( int ) {
+                    const_iterator old = *this;
+                    ++*this;
+                    return old;
+                }
+                bool operator==( const const_iterator &rhs ) const {
+                    return index == rhs.index;
+                }
+                bool operator!=( const const_iterator &rhs ) const {
+                    return index != rhs.index;
+                }
+
+            private:
+                const flag_set *set;
+                size_t index;
+                flag_id current;
+
+                // Moves to the first flag at or after index
+                void find_flag();
+        };
+        using iterator = const_iterator;
+        using value_type = flag_id;
+
+        flag_set() = default;
+        explicit flag_set( const std::set<std::string> &flags );
+
+        bool count( const flag_id &flag ) const {
+            return test( flag.index() );
+        }
+        bool count( const std::string &flag ) const;
+
+        void insert( const flag_id &flag );
+        void insert( const std::string &flag ) {
+            insert( flag_id( flag ) );
+        }
+        void erase( const flag_id &flag );
+        void erase( const std::string &flag );
+
+        bool empty() const {
+            return words.empty();
+        }
+        size_t size() const;
+        void clear() {
+            words.clear();
+        }
+
+        const_iterator begin() const {
+            return const_iterator( this, 0 );
+        }
+        const_iterator end() const {
+            return const_iterator( this, words.size() * bits_per_word );
+        }
+
+        bool operator==( const flag_set &rhs ) const {
+            return words == rhs.words;
+        }
+        bool operator!=( const flag_set &rhs ) const {
+            return words != rhs.words;
+        }
+
+        // Written as an array of strings, like the set of strings it replaces
+        void serialize( JsonOut &jsout ) const;
+        void deserialize( JsonIn &jsin );
+
+    private:
+        static constexpr size_t bits_per_word = 64;
+        // No trailing zero words, so equal sets compare equal and empty() is cheap
+        std::vector<uint64_t> words;
+
+        bool test( const size_t index ) const {
+            const size_t word = index / bits_per_word;
+            return word < words.size() && ( words[word] >> index % bits_per_word & 1 );
+        }
+};
 
 class json_flag
 {
@@ -14,6 +174,7 @@ class json_flag
     public:
         /** Fetches flag definition (or null flag if not found) */
         static const json_flag &get( const std::string &id );
+        static const json_flag &get( const flag_id &id );
 
         /** Get identifier of flag as specified in JSON */
         const std::string &id() const {
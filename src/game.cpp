@@ -147,6 +147,7 @@
 #include "timed_event.h"
 #include "translations.h"
 #include "trap.h"
+#include "turn_profiler.h"
 #include "ui.h"
 #include "ui_manager.h"
 #include "uistate.h"
@@ -1382,6 +1383,7 @@ void game::calc_driving_offset( vehicle *veh )
 // Returns true if game is over (death, saved, quit, etc)
 bool game::do_turn()
 {
+    turn_profiler::end_turn();
     if( is_game_over() ) {
         return cleanup_at_end();
     }
@@ -1414,11 +1416,13 @@ bool game::do_turn()
         u.check_mount_is_spooked();
     }
     if( calendar::once_every( 1_days ) ) {
+        TURN_PROFILER_ZONE( "overmapbuffer::process_mongroups" );
         overmap_buffer.process_mongroups();
     }
 
     // Move hordes every 2.5 min
     if( calendar::once_every( time_duration::from_minutes( 2.5 ) ) ) {
+        TURN_PROFILER_ZONE( "overmapbuffer::move_hordes" );
         overmap_buffer.move_hordes();
         // Hordes that reached the reality bubble need to spawn,
         // make them spawn in invisible areas only.
@@ -1428,8 +1432,10 @@ bool game::do_turn()
     u.update_body();
 
     // Auto-save if autosave is enabled
-    if( get_option<bool>( "AUTOSAVE" ) &&
-        calendar::once_every( 1_turns * get_option<int>( "AUTOSAVE_TURNS" ) ) &&
+    static const option_handle<bool> autosave_enabled( "AUTOSAVE" );
+    static const option_handle<int> autosave_turns( "AUTOSAVE_TURNS" );
+    if( autosave_enabled.get() &&
+        calendar::once_every( 1_turns * autosave_turns.get() ) &&
         !u.is_dead_state() ) {
         autosave();
     }
@@ -1565,7 +1571,8 @@ bool game::do_turn()
     update_stair_monsters();
     mon_info_update();
     u.process_turn();
-    if( u.moves < 0 && get_option<bool>( "FORCE_REDRAW" ) ) {
+    static const option_handle<bool> force_redraw( "FORCE_REDRAW" );
+    if( u.moves < 0 && force_redraw.get() ) {
         ui_manager::redraw();
         refresh_display();
     }
@@ -3594,8 +3601,10 @@ void game::draw_panels( bool force_draw )
     const bool draw_this_turn = current_turn > previous_turn || force_draw;
     auto &mgr = panel_manager::get_manager();
     int y = 0;
-    const bool sidebar_right = get_option<std::string>( "SIDEBAR_POSITION" ) == "right";
-    int spacer = get_option<bool>( "SIDEBAR_SPACERS" ) ? 1 : 0;
+    static const option_handle<std::string> sidebar_position( "SIDEBAR_POSITION" );
+    static const option_handle<bool> sidebar_spacers( "SIDEBAR_SPACERS" );
+    const bool sidebar_right = sidebar_position.get() == "right";
+    int spacer = sidebar_spacers.get() ? 1 : 0;
     int log_height = 0;
     for( const window_panel &panel : mgr.get_current_layout() ) {
         if( panel.get_height() != -2 && panel.toggle && panel.render() ) {
@@ -3733,7 +3742,8 @@ void game::draw_ter( const tripoint &center, const bool looking, const bool draw
 
 cata::optional<tripoint> game::get_veh_dir_indicator_location( bool next ) const
 {
-    if( !get_option<bool>( "VEHICLE_DIR_INDICATOR" ) ) {
+    static const option_handle<bool> vehicle_dir_indicator( "VEHICLE_DIR_INDICATOR" );
+    if( !vehicle_dir_indicator.get() ) {
         return cata::nullopt;
     }
     const optional_vpart_position vp = m.veh_at( u.pos() );
@@ -4044,8 +4054,9 @@ character_id game::assign_npc_id()
 
 Creature *game::is_hostile_nearby()
 {
-    int distance = ( get_option<int>( "SAFEMODEPROXIMITY" ) <= 0 ) ? MAX_VIEW_DISTANCE :
-                   get_option<int>( "SAFEMODEPROXIMITY" );
+    static const option_handle<int> safemode_proximity( "SAFEMODEPROXIMITY" );
+    const int safe_proxy_dist = safemode_proximity.get();
+    const int distance = ( safe_proxy_dist <= 0 ) ? MAX_VIEW_DISTANCE : safe_proxy_dist;
     return is_hostile_within( distance );
 }
 
@@ -4276,7 +4287,11 @@ void game::mon_info( const catacurses::window &w, int hor_padding )
 void game::mon_info_update( )
 {
     int newseen = 0;
-    const int safe_proxy_dist = get_option<int>( "SAFEMODEPROXIMITY" );
+    static const option_handle<int> safemode_proximity( "SAFEMODEPROXIMITY" );
+    static const option_handle<int> safemode_ignore_turns( "SAFEMODEIGNORETURNS" );
+    static const option_handle<bool> autosafemode( "AUTOSAFEMODE" );
+    static const option_handle<int> autosafemode_turns( "AUTOSAFEMODETURNS" );
+    const int safe_proxy_dist = safemode_proximity.get();
     const int iProxyDist = ( safe_proxy_dist <= 0 ) ? MAX_VIEW_DISTANCE :
                            safe_proxy_dist;
 
@@ -4303,7 +4318,7 @@ void game::mon_info_update( )
     static int previous_turn = 0;
     // TODO: change current_turn to time_point
     const int current_turn = to_turns<int>( calendar::turn - calendar::turn_zero );
-    const int sm_ignored_turns = get_option<int>( "SAFEMODEIGNORETURNS" );
+    const int sm_ignored_turns = safemode_ignore_turns.get();
 
     for( Creature *c : u.get_visible_creatures( MAPSIZE_X ) ) {
         monster *m = dynamic_cast<monster *>( c );
@@ -4451,10 +4466,10 @@ void game::mon_info_update( )
         if( safe_mode == SAFE_MODE_ON ) {
             set_safe_mode( SAFE_MODE_STOP );
         }
-    } else if( current_turn > previous_turn && get_option<bool>( "AUTOSAFEMODE" ) &&
+    } else if( current_turn > previous_turn && autosafemode.get() &&
                newseen == 0 ) { // Auto-safe mode, but only if it's a new turn
         turnssincelastmon += current_turn - previous_turn;
-        if( turnssincelastmon >= get_option<int>( "AUTOSAFEMODETURNS" ) && safe_mode == SAFE_MODE_OFF ) {
+        if( turnssincelastmon >= autosafemode_turns.get() && safe_mode == SAFE_MODE_OFF ) {
             set_safe_mode( SAFE_MODE_ON );
             add_msg( m_info, _( "Safe mode ON!" ) );
         }
@@ -4505,8 +4520,23 @@ void game::cleanup_dead()
 
 void game::monmove()
 {
+    TURN_PROFILER_ZONE( "game::monmove" );
     cleanup_dead();
 
+    static const option_handle<bool> parallel_planning( "PARALLEL_MONSTER_PLANNING" );
+    if( parallel_planning.get() ) {
+        // Trace the lines of sight the monsters are going to look along when they plan on
+        // several threads up front. They still take their turns one after another below.
+        std::vector<const monster *> planners;
+        for( const monster &critter : all_monsters() ) {
+            if( !critter.is_dead() && !critter.has_effect( effect_ridden ) &&
+                !critter.has_effect( effect_controlled ) ) {
+                planners.push_back( &critter );
+            }
+        }
+        monster::trace_plan_sight_lines( planners );
+    }
+
     for( monster &critter : all_monsters() ) {
         // Critters in impassable tiles get pushed away, unless it's not impassable for them
         if( !critter.is_dead() && m.impassable( critter.pos() ) && !critter.can_move_to( critter.pos() ) ) {
@@ -4631,6 +4661,7 @@ void game::monmove()
 
 void game::overmap_npc_move()
 {
+    TURN_PROFILER_ZONE( "game::overmap_npc_move" );
     std::vector<npc *> travelling_npcs;
     static constexpr int move_search_radius = 600;
     for( auto &elem : overmap_buffer.get_npcs_near_player( move_search_radius ) ) {
@@ -11236,6 +11267,14 @@ point game::update_map( int &x, int &y )
     // as "current z-level"
     u.setpos( tripoint( x, y, m.get_abs_sub().z ) );
 
+    // We're likely to keep going the same way, start reading the next submaps in that direction
+    // from disk. A vehicle can cross several submaps before the next shift, so look further ahead.
+    const optional_vpart_position vp = m.veh_at( u.pos() );
+    const bool driving = vp && u.controlling_vehicle && vp->vehicle().velocity != 0;
+    m.prefetch_submaps( clamp( shift, size_1 ), driving ? 4 : 2 );
+    // Same for the overmaps, which take much longer to generate.
+    overmap_buffer.pregenerate_near( u.global_omt_location() );
+
     // Only do the loading after all coordinates have been shifted.
 
     // Check for overmap saved npcs that should now come into view.
@@ -11568,7 +11607,8 @@ void game::perhaps_add_random_npc()
     }
     // Create a new NPC?
 
-    double spawn_time = get_option<float>( "NPC_SPAWNTIME" );
+    static const option_handle<float> npc_spawntime( "NPC_SPAWNTIME" );
+    double spawn_time = npc_spawntime.get();
     if( spawn_time == 0.0 ) {
         return;
     }
@@ -4083,9 +4083,7 @@ cata::optional<tripoint> iexamine::getNearFilledGasTank( const tripoint &center,
 
 static int getGasDiscountCardQuality( const item &it )
 {
-    std::set<std::string> tags = it.type->item_tags;
-
-    for( const std::string &tag : tags ) {
+    for( const std::string &tag : it.type->item_tags ) {
 
         if( tag.size() > 15 && tag.substr( 0, 15 ) == "DISCOUNT_VALUE_" ) {
             return atoi( tag.substr( 15 ).c_str() );
@@ -1,7 +1,11 @@
 #include "init.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdio>
+#include <deque>
 #include <exception>
 #include <fstream>
 #include <iterator>
@@ -20,6 +24,7 @@
 #include "behavior.h"
 #include "bionics.h"
 #include "bodypart.h"
+#include "cata_utility.h"
 #include "clothing_mod.h"
 #include "clzones.h"
 #include "construction.h"
@@ -39,6 +44,7 @@
 #include "filesystem.h"
 #include "flag.h"
 #include "gates.h"
+#include "get_version.h"
 #include "harvest.h"
 #include "item_action.h"
 #include "item_category.h"
@@ -68,6 +74,8 @@
 #include "overmap.h"
 #include "overmap_connection.h"
 #include "overmap_location.h"
+#include "parallel.h"
+#include "path_info.h"
 #include "profession.h"
 #include "proficiency.h"
 #include "recipe_dictionary.h"
@@ -95,6 +103,58 @@
 #include "weather_type.h"
 #include "worldfactory.h"
 
+extern bool test_mode;
+
+static constexpr uint64_t fnv_offset_basis = 14695981039346656037ULL;
+
+/** Adds @p size bytes at @p data to the FNV-1a hash @p hash. */
+static uint64_t fnv1a_hash( uint64_t hash, const char *data, const size_t size )
+{
+    for( size_t i = 0; i < size; ++i ) {
+        hash ^= static_cast<unsigned char>( data[i] );
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t fnv1a_hash( const uint64_t hash, const std::string &str )
+{
+    // Including the terminating null keeps "ab" + "c" apart from "a" + "bc"
+    return fnv1a_hash( hash, str.c_str(), str.size() + 1 );
+}
+
+uint64_t loaded_data_key::hash_contents( const char *data, const size_t size )
+{
+    return fnv1a_hash( fnv_offset_basis, data, size );
+}
+
+void loaded_data_key::add_source( const std::string &src )
+{
+    sources.push_back( src );
+    hash = fnv1a_hash( hash, src );
+}
+
+void loaded_data_key::add_file( const std::string &path, const uint64_t contents_hash,
+                                const size_t size )
+{
+    ++file_count;
+    hash = fnv1a_hash( hash, path + ':' + std::to_string( size ) + ':' +
+                       std::to_string( contents_hash ) );
+}
+
+void loaded_data_key::clear()
+{
+    *this = loaded_data_key();
+}
+
+std::string loaded_data_key::str() const
+{
+    // The mods are spelled out, so that only files with the same contents in the same mods can
+    // ever have the same key.
+    return string_format( "%s [%s] %s files %s", getVersionString(), join( sources, "," ),
+                          std::to_string( file_count ), std::to_string( hash ) );
+}
+
 DynamicDataLoader::DynamicDataLoader()
 {
     initialize();
@@ -415,8 +475,72 @@ void DynamicDataLoader::initialize()
 #endif
 }
 
+static long long microseconds_since( const std::chrono::steady_clock::time_point &start )
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() -
+            start ).count();
+}
+
+namespace
+{
+/**
+ * A data file mapped into memory, with the top level objects in it already located.
+ * Parsing only touches this object, so files can be parsed on different threads.
+ */
+struct parsed_json_file {
+    std::unique_ptr<mapped_file> contents;
+    std::unique_ptr<JsonIn> jsin;
+    /**
+     * Objects read from @ref jsin, in file order. A JsonObject moves the stream when it's
+     * destroyed, so they are kept in a deque (which never moves its elements) and are always
+     * destroyed before the stream.
+     */
+    std::deque<JsonObject> objects;
+    /** Set if the file could not be read completely, rethrown after loading @ref objects. */
+    std::exception_ptr error;
+    /** Hash of the file contents, see @ref loaded_data_key. */
+    uint64_t hash = 0;
+    size_t size = 0;
+
+    void parse( const std::string &file ) {
+        try {
+            // map the file into memory and parse it straight from there
+            contents = std::make_unique<mapped_file>( file );
+            hash = loaded_data_key::hash_contents( contents->data(), contents->size() );
+            size = contents->size();
+            jsin = std::make_unique<JsonIn>( contents->data(), contents->size() );
+            if( jsin->test_object() ) {
+                objects.emplace_back( *jsin );
+                // if there's anything else in the file, it's an error.
+                jsin->eat_whitespace();
+                if( jsin->good() ) {
+                    jsin->error( string_format( "expected single-object file but found '%c'",
+                                                jsin->peek() ) );
+                }
+            } else if( jsin->test_array() ) {
+                jsin->start_array();
+                while( !jsin->end_array() ) {
+                    objects.emplace_back( *jsin );
+                }
+            } else {
+                // not an object or an array?
+                jsin->error( "expected object or array" );
+            }
+        } catch( const std::runtime_error & ) {
+            error = std::current_exception();
+        }
+    }
+
+    void clear() {
+        objects.clear();
+        jsin.reset();
+        contents.reset();
+    }
+};
+} // namespace
+
 void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
-        loading_ui &ui )
+        loading_ui & )
 {
     assert( !finalized && "Can't load additional data after finalization.  Must be unloaded first." );
     // We assume that each folder is consistent in itself,
@@ -435,26 +559,37 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back( path );
         }
     }
-    // iterate over each file
-    for( auto &files_i : files ) {
-        const std::string &file = files_i;
-        // open the file as a stream
-        std::ifstream infile( file.c_str(), std::ifstream::in | std::ifstream::binary );
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                ( std::istreambuf_iterator<char>( infile ) ),
-                std::istreambuf_iterator<char>()
-            )
-        );
+
+    // Reading the files and finding the objects in them doesn't depend on anything else,
+    // so that is done in parallel. Only loading the objects has to happen in order.
+    auto start = std::chrono::steady_clock::now();
+    std::vector<parsed_json_file> parsed( files.size() );
+    parallel_for( files.size(), [&]( const size_t i ) {
+        parsed[i].parse( files[i] );
+    } );
+    timings.emplace_back( "Read " + path, microseconds_since( start ) );
+
+    start = std::chrono::steady_clock::now();
+    data_key.add_source( src );
+    for( size_t i = 0; i < files.size(); ++i ) {
+        parsed_json_file &file = parsed[i];
+        data_key.add_file( files[i], file.hash, file.size );
         try {
-            // parse it
-            JsonIn jsin( iss );
-            load_all_from_json( jsin, src, ui, path, file );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( file + ": " + err.what() );
+            for( JsonObject &jo : file.objects ) {
+                load_object( jo, src, path, files[i] );
+                jo.finish();
+            }
+            if( file.error ) {
+                std::rethrow_exception( file.error );
+            }
+        } catch( const std::runtime_error &err ) {
+            // JsonError is one of these too
+            throw std::runtime_error( files[i] + ": " + err.what() );
         }
+        // Release the memory of each file as soon as possible
+        file.clear();
     }
+    timings.emplace_back( "Load " + path, microseconds_since( start ) );
 }
 
 void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &,
@@ -487,6 +622,8 @@ void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src
 void DynamicDataLoader::unload_data()
 {
     finalized = false;
+    timings.clear();
+    data_key.clear();
 
     achievement::reset();
     activity_type::reset();
@@ -640,18 +777,71 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
 
     ui.show();
     for( const named_entry &e : entries ) {
+        const auto start = std::chrono::steady_clock::now();
         e.second();
+        timings.emplace_back( "Finalize " + e.first, microseconds_since( start ) );
         ui.proceed();
     }
 
     check_consistency( ui );
     finalized = true;
+
+    if( timing_enabled ) {
+        print_timings();
+    }
+}
+
+// Keys of the data sets that passed the checks, most recent last
+static std::vector<std::string> read_verified_data_keys()
+{
+    std::vector<std::string> keys;
+    read_from_file_optional_json( PATH_INFO::verified_data(), [&]( JsonIn & jsin ) {
+        JsonObject jo = jsin.get_object();
+        jo.allow_omitted_members();
+        if( jo.has_array( "keys" ) ) {
+            keys = jo.get_string_array( "keys" );
+        }
+    } );
+    return keys;
+}
+
+static void add_verified_data_key( const std::string &key )
+{
+    // Several worlds with different mods may be played in turns, remember a few of them
+    static constexpr size_t max_keys = 10;
+    std::vector<std::string> keys = read_verified_data_keys();
+    keys.erase( std::remove( keys.begin(), keys.end(), key ), keys.end() );
+    keys.push_back( key );
+    if( keys.size() > max_keys ) {
+        keys.erase( keys.begin(), keys.end() - max_keys );
+    }
+    try {
+        write_to_file( PATH_INFO::verified_data(), [&]( std::ostream & fout ) {
+            JsonOut jout( fout );
+            jout.start_object();
+            jout.member( "keys", keys );
+            jout.end_object();
+        } );
+    } catch( const std::exception &err ) {
+        // Not a problem, the data will just be checked again next time
+        DebugLog( D_WARNING, D_MAIN ) << "Failed to save verified data key: " << err.what();
+    }
 }
 
 void DynamicDataLoader::check_consistency( loading_ui &ui )
 {
     ui.new_context( _( "Verifying" ) );
 
+    // The checks only report problems, so they don't need to run again for exactly the same
+    // data and game version once it passed all of them. Tests and mod checks always run them.
+    const std::string key = data_key.str();
+    const std::vector<std::string> verified_keys = read_verified_data_keys();
+    const bool verified_before = !test_mode && std::find( verified_keys.begin(),
+                                 verified_keys.end(), key ) != verified_keys.end();
+    const bool error_before = debug_has_error_been_observed();
+    // Except this one, which also adds the base items to the install requirements of the parts
+    const std::string vehicle_parts = _( "Vehicle parts" );
+
     using named_entry = std::pair<std::string, std::function<void()>>;
     const std::vector<named_entry> entries = {{
             { _( "Flags" ), &json_flag::check_consistency },
@@ -661,12 +851,7 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
                     requirement_data::check_consistency();
                 }
             },
-            { _( "Vitamins" ), &vitamin::check_consistency },
             { _( "Weather types" ), &weather_types::check_consistency },
-            { _( "Field types" ), &field_types::check_consistency },
-            { _( "Ammo effects" ), &ammo_effects::check_consistency },
-            { _( "Emissions" ), &emit::check_consistency },
-            { _( "Activities" ), &activity_type::check_consistency },
             {
                 _( "Items" ), []()
                 {
@@ -675,7 +860,7 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
             },
             { _( "Materials" ), &materials::check },
             { _( "Engine faults" ), &fault::check_consistency },
-            { _( "Vehicle parts" ), &vpart_info::check },
+            { vehicle_parts, &vpart_info::check },
             { _( "Mapgen definitions" ), &check_mapgen_definitions },
             {
                 _( "Monster types" ), []()
@@ -690,20 +875,13 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
             { _( "Scenarios" ), &scenario::check_definitions },
             { _( "Martial arts" ), &check_martialarts },
             { _( "Mutations" ), &mutation_branch::check_consistency },
-            { _( "Mutation Categories" ), &mutation_category_trait::check_consistency },
-            { _( "Overmap land use codes" ), &overmap_land_use_codes::check_consistency },
-            { _( "Overmap connections" ), &overmap_connections::check_consistency },
             { _( "Overmap terrain" ), &overmap_terrains::check_consistency },
-            { _( "Overmap locations" ), &overmap_locations::check_consistency },
             { _( "Overmap specials" ), &overmap_specials::check_consistency },
             { _( "Map extras" ), &MapExtras::check_consistency },
-            { _( "Start locations" ), &start_locations::check_consistency },
-            { _( "Ammunition types" ), &ammunition_type::check_consistency },
             { _( "Traps" ), &trap::check_consistency },
             { _( "Bionics" ), &bionic_data::check_bionic_consistency },
             { _( "Gates" ), &gates::check },
             { _( "NPC classes" ), &npc_class::check_consistency },
-            { _( "Behaviors" ), &behavior::check_consistency },
             { _( "Mission types" ), &mission_type::check_consistency },
             {
                 _( "Item actions" ), []()
@@ -712,10 +890,27 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
                 }
             },
             { _( "Harvest lists" ), &harvest_list::check_consistency },
+            { _( "Spells" ), &spell_type::check_consistency },
+        }
+    };
+    // These only read finalized data and never look up item types (the item factory adds
+    // missing types when they are looked up), so they can run at the same time.
+    const std::vector<named_entry> independent_entries = {{
+            { _( "Vitamins" ), &vitamin::check_consistency },
+            { _( "Field types" ), &field_types::check_consistency },
+            { _( "Ammo effects" ), &ammo_effects::check_consistency },
+            { _( "Emissions" ), &emit::check_consistency },
+            { _( "Activities" ), &activity_type::check_consistency },
+            { _( "Mutation Categories" ), &mutation_category_trait::check_consistency },
+            { _( "Overmap land use codes" ), &overmap_land_use_codes::check_consistency },
+            { _( "Overmap connections" ), &overmap_connections::check_consistency },
+            { _( "Overmap locations" ), &overmap_locations::check_consistency },
+            { _( "Start locations" ), &start_locations::check_consistency },
+            { _( "Ammunition types" ), &ammunition_type::check_consistency },
+            { _( "Behaviors" ), &behavior::check_consistency },
             { _( "NPC templates" ), &npc_template::check_consistency },
             { _( "Body parts" ), &body_part_type::check_consistency },
             { _( "Anatomies" ), &anatomy::check_consistency },
-            { _( "Spells" ), &spell_type::check_consistency },
             { _( "Transformations" ), &event_transformation::check_consistency },
             { _( "Statistics" ), &event_statistic::check_consistency },
             { _( "Scent types" ), &scent_type::check_scent_consistency },
@@ -729,10 +924,68 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
     for( const named_entry &e : entries ) {
         ui.add_entry( e.first );
     }
+    for( const named_entry &e : independent_entries ) {
+        ui.add_entry( e.first );
+    }
 
     ui.show();
     for( const named_entry &e : entries ) {
+        if( verified_before && e.first != vehicle_parts ) {
+            ui.proceed();
+            continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
         e.second();
+        timings.emplace_back( "Check " + e.first, microseconds_since( start ) );
+        ui.proceed();
+    }
+
+    if( verified_before ) {
+        for( size_t i = 0; i < independent_entries.size(); ++i ) {
+            ui.proceed();
+        }
+        timings.emplace_back( "Checks skipped, data was verified before", 0 );
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<deferred_debugmsgs> messages( independent_entries.size() );
+    std::vector<std::exception_ptr> errors( independent_entries.size() );
+    std::vector<long long> durations( independent_entries.size() );
+    parallel_for( independent_entries.size(), [&]( const size_t i ) {
+        const auto entry_start = std::chrono::steady_clock::now();
+        deferred_debugmsgs::capture capture( messages[i] );
+        try {
+            independent_entries[i].second();
+        } catch( ... ) {
+            errors[i] = std::current_exception();
+        }
+        durations[i] = microseconds_since( entry_start );
+    } );
+    for( size_t i = 0; i < independent_entries.size(); ++i ) {
+        messages[i].replay();
+        if( errors[i] ) {
+            std::rethrow_exception( errors[i] );
+        }
+        timings.emplace_back( "Check " + independent_entries[i].first + " (parallel)", durations[i] );
         ui.proceed();
     }
+    timings.emplace_back( "Check in parallel", microseconds_since( start ) );
+
+    if( !test_mode && !error_before && !debug_has_error_been_observed() ) {
+        add_verified_data_key( key );
+    }
+}
+
+void DynamicDataLoader::print_timings() const
+{
+    long long total = 0;
+    for( const std::pair<std::string, long long> &t : timings ) {
+        // The parallel checks are already counted in their total
+        if( t.first.find( " (parallel)" ) == std::string::npos ) {
+            total += t.second;
+        }
+        printf( "%-60s %10.1f ms\n", t.first.c_str(), t.second / 1000.0 );
+    }
+    printf( "%-60s %10.1f ms\n", "Total", total / 1000.0 );
 }
@@ -2,6 +2,8 @@
 #ifndef CATA_SRC_INIT_H
 #define CATA_SRC_INIT_H
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <map>
@@ -13,6 +15,30 @@ class loading_ui;
 class JsonObject;
 class JsonIn;
 
+/**
+ * Identifies the data loaded by @ref DynamicDataLoader: the game version, the mods in load
+ * order and the name, size and content hash of every file they loaded. Any change to a data
+ * file changes the key.
+ */
+class loaded_data_key
+{
+    public:
+        /** Hash of the contents of one file, as passed to @ref add_file. */
+        static uint64_t hash_contents( const char *data, size_t size );
+
+        /** Adds mod @p src, the files added after it belong to that mod. */
+        void add_source( const std::string &src );
+        void add_file( const std::string &path, uint64_t contents_hash, size_t size );
+        void clear();
+
+        std::string str() const;
+
+    private:
+        std::vector<std::string> sources;
+        size_t file_count = 0;
+        uint64_t hash = hash_contents( nullptr, 0 );
+};
+
 /**
  * This class is used to load (and unload) the dynamic
  * (and moddable) data from json files.
@@ -65,6 +91,13 @@ class DynamicDataLoader
 
     private:
         bool finalized = false;
+        bool timing_enabled = false;
+        /** Name and duration (in microseconds) of each loading stage, in the order they ran. */
+        std::vector<std::pair<std::string, long long>> timings;
+        /** The data loaded since the last @ref unload_data, see @ref check_consistency. */
+        loaded_data_key data_key;
+
+        void print_timings() const;
 
     protected:
         /**
@@ -120,6 +153,8 @@ class DynamicDataLoader
         /**
          * Load all data from json files located in
          * the path (recursive).
+         * The files are read and split into objects on worker threads, the objects are
+         * then loaded on the calling thread in the order of the files.
          * @param path Either a folder (recursively load all
          * files with the extension .json), or a file (load only
          * that file, don't check extension).
@@ -155,6 +190,13 @@ class DynamicDataLoader
          */
         void load_deferred( deferred_json &data );
 
+        /**
+         * Print how long each stage of loading took to stdout once the data is finalized.
+         */
+        void enable_timing() {
+            timing_enabled = true;
+        }
+
         /**
          * Returns whether the data is finalized and ready to be utilized.
          */
@@ -158,115 +158,115 @@ static const trait_id trait_SMALL2( "SMALL2" );
 static const trait_id trait_TOLERANCE( "TOLERANCE" );
 static const trait_id trait_WOOLALLERGY( "WOOLALLERGY" );
 
-static const std::string flag_ALWAYS_TWOHAND( "ALWAYS_TWOHAND" );
-static const std::string flag_AURA( "AURA" );
-static const std::string flag_BELTED( "BELTED" );
-static const std::string flag_BIPOD( "BIPOD" );
-static const std::string flag_BYPRODUCT( "BYPRODUCT" );
-static const std::string flag_CABLE_SPOOL( "CABLE_SPOOL" );
-static const std::string flag_CANNIBALISM( "CANNIBALISM" );
-static const std::string flag_CHARGEDIM( "CHARGEDIM" );
-static const std::string flag_COLD( "COLD" );
-static const std::string flag_COLLAPSIBLE_STOCK( "COLLAPSIBLE_STOCK" );
-static const std::string flag_CONDUCTIVE( "CONDUCTIVE" );
-static const std::string flag_CONSUMABLE( "CONSUMABLE" );
-static const std::string flag_CORPSE( "CORPSE" );
-static const std::string flag_DANGEROUS( "DANGEROUS" );
-static const std::string flag_DEEP_WATER( "DEEP_WATER" );
-static const std::string flag_DIAMOND( "DIAMOND" );
-static const std::string flag_DISABLE_SIGHTS( "DISABLE_SIGHTS" );
-static const std::string flag_ETHEREAL_ITEM( "ETHEREAL_ITEM" );
-static const std::string flag_FAKE_MILL( "FAKE_MILL" );
-static const std::string flag_FAKE_SMOKE( "FAKE_SMOKE" );
-static const std::string flag_FIELD_DRESS( "FIELD_DRESS" );
-static const std::string flag_FIELD_DRESS_FAILED( "FIELD_DRESS_FAILED" );
-static const std::string flag_FILTHY( "FILTHY" );
-static const std::string flag_FIRE_100( "FIRE_100" );
-static const std::string flag_FIRE_20( "FIRE_20" );
-static const std::string flag_FIRE_50( "FIRE_50" );
-static const std::string flag_FIRE_TWOHAND( "FIRE_TWOHAND" );
-static const std::string flag_FIT( "FIT" );
-static const std::string flag_FLAMMABLE( "FLAMMABLE" );
-static const std::string flag_FLAMMABLE_ASH( "FLAMMABLE_ASH" );
-static const std::string flag_FREEZERBURN( "FREEZERBURN" );
-static const std::string flag_FROZEN( "FROZEN" );
-static const std::string flag_GIBBED( "GIBBED" );
-static const std::string flag_HELMET_COMPAT( "HELMET_COMPAT" );
-static const std::string flag_HIDDEN_HALLU( "HIDDEN_HALLU" );
-static const std::string flag_HIDDEN_POISON( "HIDDEN_POISON" );
-static const std::string flag_HOT( "HOT" );
-static const std::string flag_IRREMOVABLE( "IRREMOVABLE" );
-static const std::string flag_BURNOUT( "BURNOUT" );
-static const std::string flag_IS_ARMOR( "IS_ARMOR" );
-static const std::string flag_IS_PET_ARMOR( "IS_PET_ARMOR" );
-static const std::string flag_IS_UPS( "IS_UPS" );
-static const std::string flag_LEAK_ALWAYS( "LEAK_ALWAYS" );
-static const std::string flag_LEAK_DAM( "LEAK_DAM" );
-static const std::string flag_LIQUID( "LIQUID" );
-static const std::string flag_LIQUIDCONT( "LIQUIDCONT" );
-static const std::string flag_LITCIG( "LITCIG" );
-static const std::string flag_MAG_BELT( "MAG_BELT" );
-static const std::string flag_MELTS( "MELTS" );
-static const std::string flag_MUSHY( "MUSHY" );
-static const std::string flag_NANOFAB_TEMPLATE( "NANOFAB_TEMPLATE" );
-static const std::string flag_NEEDS_UNFOLD( "NEEDS_UNFOLD" );
-static const std::string flag_NEVER_JAMS( "NEVER_JAMS" );
-static const std::string flag_NONCONDUCTIVE( "NONCONDUCTIVE" );
-static const std::string flag_NO_DISPLAY( "NO_DISPLAY" );
-static const std::string flag_NO_DROP( "NO_DROP" );
-static const std::string flag_NO_PACKED( "NO_PACKED" );
-static const std::string flag_NO_PARASITES( "NO_PARASITES" );
-static const std::string flag_NO_RELOAD( "NO_RELOAD" );
-static const std::string flag_NO_REPAIR( "NO_REPAIR" );
-static const std::string flag_NO_SALVAGE( "NO_SALVAGE" );
-static const std::string flag_NO_STERILE( "NO_STERILE" );
-static const std::string flag_NO_UNLOAD( "NO_UNLOAD" );
-static const std::string flag_OUTER( "OUTER" );
-static const std::string flag_OVERSIZE( "OVERSIZE" );
-static const std::string flag_PERSONAL( "PERSONAL" );
-static const std::string flag_PROCESSING( "PROCESSING" );
-static const std::string flag_PROCESSING_RESULT( "PROCESSING_RESULT" );
-static const std::string flag_PULPED( "PULPED" );
-static const std::string flag_PUMP_ACTION( "PUMP_ACTION" );
-static const std::string flag_PUMP_RAIL_COMPATIBLE( "PUMP_RAIL_COMPATIBLE" );
-static const std::string flag_QUARTERED( "QUARTERED" );
-static const std::string flag_RADIOACTIVE( "RADIOACTIVE" );
-static const std::string flag_RADIOSIGNAL_1( "RADIOSIGNAL_1" );
-static const std::string flag_RADIOSIGNAL_2( "RADIOSIGNAL_2" );
-static const std::string flag_RADIOSIGNAL_3( "RADIOSIGNAL_3" );
-static const std::string flag_RADIO_ACTIVATION( "RADIO_ACTIVATION" );
-static const std::string flag_RADIO_INVOKE_PROC( "RADIO_INVOKE_PROC" );
-static const std::string flag_RADIO_MOD( "RADIO_MOD" );
-static const std::string flag_RAIN_PROTECT( "RAIN_PROTECT" );
-static const std::string flag_REACH3( "REACH3" );
-static const std::string flag_REACH_ATTACK( "REACH_ATTACK" );
-static const std::string flag_RECHARGE( "RECHARGE" );
-static const std::string flag_REDUCED_BASHING( "REDUCED_BASHING" );
-static const std::string flag_REDUCED_WEIGHT( "REDUCED_WEIGHT" );
-static const std::string flag_RELOAD_AND_SHOOT( "RELOAD_AND_SHOOT" );
-static const std::string flag_RELOAD_EJECT( "RELOAD_EJECT" );
-static const std::string flag_RELOAD_ONE( "RELOAD_ONE" );
-static const std::string flag_REVIVE_SPECIAL( "REVIVE_SPECIAL" );
-static const std::string flag_SILENT( "SILENT" );
-static const std::string flag_SKINNED( "SKINNED" );
-static const std::string flag_SKINTIGHT( "SKINTIGHT" );
-static const std::string flag_SLOW_WIELD( "SLOW_WIELD" );
-static const std::string flag_SPEEDLOADER( "SPEEDLOADER" );
-static const std::string flag_SPLINT( "SPLINT" );
-static const std::string flag_TOURNIQUET( "TOURNIQUET" );
-static const std::string flag_STR_DRAW( "STR_DRAW" );
-static const std::string flag_TOBACCO( "TOBACCO" );
-static const std::string flag_UNARMED_WEAPON( "UNARMED_WEAPON" );
-static const std::string flag_UNDERSIZE( "UNDERSIZE" );
-static const std::string flag_USES_BIONIC_POWER( "USES_BIONIC_POWER" );
-static const std::string flag_USE_UPS( "USE_UPS" );
-static const std::string flag_VARSIZE( "VARSIZE" );
-static const std::string flag_VEHICLE( "VEHICLE" );
-static const std::string flag_WAIST( "WAIST" );
-static const std::string flag_WATERPROOF_GUN( "WATERPROOF_GUN" );
-static const std::string flag_WATER_EXTINGUISH( "WATER_EXTINGUISH" );
-static const std::string flag_WET( "WET" );
-static const std::string flag_WIND_EXTINGUISH( "WIND_EXTINGUISH" );
+static const flag_id flag_ALWAYS_TWOHAND( "ALWAYS_TWOHAND" );
+static const flag_id flag_AURA( "AURA" );
+static const flag_id flag_BELTED( "BELTED" );
+static const flag_id flag_BIPOD( "BIPOD" );
+static const flag_id flag_BYPRODUCT( "BYPRODUCT" );
+static const flag_id flag_CABLE_SPOOL( "CABLE_SPOOL" );
+static const flag_id flag_CANNIBALISM( "CANNIBALISM" );
+static const flag_id flag_CHARGEDIM( "CHARGEDIM" );
+static const flag_id flag_COLD( "COLD" );
+static const flag_id flag_COLLAPSIBLE_STOCK( "COLLAPSIBLE_STOCK" );
+static const flag_id flag_CONDUCTIVE( "CONDUCTIVE" );
+static const flag_id flag_CONSUMABLE( "CONSUMABLE" );
+static const flag_id flag_CORPSE( "CORPSE" );
+static const flag_id flag_DANGEROUS( "DANGEROUS" );
+static const flag_id flag_DEEP_WATER( "DEEP_WATER" );
+static const flag_id flag_DIAMOND( "DIAMOND" );
+static const flag_id flag_DISABLE_SIGHTS( "DISABLE_SIGHTS" );
+static const flag_id flag_ETHEREAL_ITEM( "ETHEREAL_ITEM" );
+static const flag_id flag_FAKE_MILL( "FAKE_MILL" );
+static const flag_id flag_FAKE_SMOKE( "FAKE_SMOKE" );
+static const flag_id flag_FIELD_DRESS( "FIELD_DRESS" );
+static const flag_id flag_FIELD_DRESS_FAILED( "FIELD_DRESS_FAILED" );
+static const flag_id flag_FILTHY( "FILTHY" );
+static const flag_id flag_FIRE_100( "FIRE_100" );
+static const flag_id flag_FIRE_20( "FIRE_20" );
+static const flag_id flag_FIRE_50( "FIRE_50" );
+static const flag_id flag_FIRE_TWOHAND( "FIRE_TWOHAND" );
+static const flag_id flag_FIT( "FIT" );
+static const flag_id flag_FLAMMABLE( "FLAMMABLE" );
+static const flag_id flag_FLAMMABLE_ASH( "FLAMMABLE_ASH" );
+static const flag_id flag_FREEZERBURN( "FREEZERBURN" );
+static const flag_id flag_FROZEN( "FROZEN" );
+static const flag_id flag_GIBBED( "GIBBED" );
+static const flag_id flag_HELMET_COMPAT( "HELMET_COMPAT" );
+static const flag_id flag_HIDDEN_HALLU( "HIDDEN_HALLU" );
+static const flag_id flag_HIDDEN_POISON( "HIDDEN_POISON" );
+static const flag_id flag_HOT( "HOT" );
+static const flag_id flag_IRREMOVABLE( "IRREMOVABLE" );
+static const flag_id flag_BURNOUT( "BURNOUT" );
+static const flag_id flag_IS_ARMOR( "IS_ARMOR" );
+static const flag_id flag_IS_PET_ARMOR( "IS_PET_ARMOR" );
+static const flag_id flag_IS_UPS( "IS_UPS" );
+static const flag_id flag_LEAK_ALWAYS( "LEAK_ALWAYS" );
+static const flag_id flag_LEAK_DAM( "LEAK_DAM" );
+static const flag_id flag_LIQUID( "LIQUID" );
+static const flag_id flag_LIQUIDCONT( "LIQUIDCONT" );
+static const flag_id flag_LITCIG( "LITCIG" );
+static const flag_id flag_MAG_BELT( "MAG_BELT" );
+static const flag_id flag_MELTS( "MELTS" );
+static const flag_id flag_MUSHY( "MUSHY" );
+static const flag_id flag_NANOFAB_TEMPLATE( "NANOFAB_TEMPLATE" );
+static const flag_id flag_NEEDS_UNFOLD( "NEEDS_UNFOLD" );
+static const flag_id flag_NEVER_JAMS( "NEVER_JAMS" );
+static const flag_id flag_NONCONDUCTIVE( "NONCONDUCTIVE" );
+static const flag_id flag_NO_DISPLAY( "NO_DISPLAY" );
+static const flag_id flag_NO_DROP( "NO_DROP" );
+static const flag_id flag_NO_PACKED( "NO_PACKED" );
+static const flag_id flag_NO_PARASITES( "NO_PARASITES" );
+static const flag_id flag_NO_RELOAD( "NO_RELOAD" );
+static const flag_id flag_NO_REPAIR( "NO_REPAIR" );
+static const flag_id flag_NO_SALVAGE( "NO_SALVAGE" );
+static const flag_id flag_NO_STERILE( "NO_STERILE" );
+static const flag_id flag_NO_UNLOAD( "NO_UNLOAD" );
+static const flag_id flag_OUTER( "OUTER" );
+static const flag_id flag_OVERSIZE( "OVERSIZE" );
+static const flag_id flag_PERSONAL( "PERSONAL" );
+static const flag_id flag_PROCESSING( "PROCESSING" );
+static const flag_id flag_PROCESSING_RESULT( "PROCESSING_RESULT" );
+static const flag_id flag_PULPED( "PULPED" );
+static const flag_id flag_PUMP_ACTION( "PUMP_ACTION" );
+static const flag_id flag_PUMP_RAIL_COMPATIBLE( "PUMP_RAIL_COMPATIBLE" );
+static const flag_id flag_QUARTERED( "QUARTERED" );
+static const flag_id flag_RADIOACTIVE( "RADIOACTIVE" );
+static const flag_id flag_RADIOSIGNAL_1( "RADIOSIGNAL_1" );
+static const flag_id flag_RADIOSIGNAL_2( "RADIOSIGNAL_2" );
+static const flag_id flag_RADIOSIGNAL_3( "RADIOSIGNAL_3" );
+static const flag_id flag_RADIO_ACTIVATION( "RADIO_ACTIVATION" );
+static const flag_id flag_RADIO_INVOKE_PROC( "RADIO_INVOKE_PROC" );
+static const flag_id flag_RADIO_MOD( "RADIO_MOD" );
+static const flag_id flag_RAIN_PROTECT( "RAIN_PROTECT" );
+static const flag_id flag_REACH3( "REACH3" );
+static const flag_id flag_REACH_ATTACK( "REACH_ATTACK" );
+static const flag_id flag_RECHARGE( "RECHARGE" );
+static const flag_id flag_REDUCED_BASHING( "REDUCED_BASHING" );
+static const flag_id flag_REDUCED_WEIGHT( "REDUCED_WEIGHT" );
+static const flag_id flag_RELOAD_AND_SHOOT( "RELOAD_AND_SHOOT" );
+static const flag_id flag_RELOAD_EJECT( "RELOAD_EJECT" );
+static const flag_id flag_RELOAD_ONE( "RELOAD_ONE" );
+static const flag_id flag_REVIVE_SPECIAL( "REVIVE_SPECIAL" );
+static const flag_id flag_SILENT( "SILENT" );
+static const flag_id flag_SKINNED( "SKINNED" );
+static const flag_id flag_SKINTIGHT( "SKINTIGHT" );
+static const flag_id flag_SLOW_WIELD( "SLOW_WIELD" );
+static const flag_id flag_SPEEDLOADER( "SPEEDLOADER" );
+static const flag_id flag_SPLINT( "SPLINT" );
+static const flag_id flag_TOURNIQUET( "TOURNIQUET" );
+static const flag_id flag_STR_DRAW( "STR_DRAW" );
+static const flag_id flag_TOBACCO( "TOBACCO" );
+static const flag_id flag_UNARMED_WEAPON( "UNARMED_WEAPON" );
+static const flag_id flag_UNDERSIZE( "UNDERSIZE" );
+static const flag_id flag_USES_BIONIC_POWER( "USES_BIONIC_POWER" );
+static const flag_id flag_USE_UPS( "USE_UPS" );
+static const flag_id flag_VARSIZE( "VARSIZE" );
+static const flag_id flag_VEHICLE( "VEHICLE" );
+static const flag_id flag_WAIST( "WAIST" );
+static const flag_id flag_WATERPROOF_GUN( "WATERPROOF_GUN" );
+static const flag_id flag_WATER_EXTINGUISH( "WATER_EXTINGUISH" );
+static const flag_id flag_WET( "WET" );
+static const flag_id flag_WIND_EXTINGUISH( "WIND_EXTINGUISH" );
 
 static const matec_id RAPID( "RAPID" );
 
@@ -475,12 +475,12 @@ item::item( const recipe *rec, int qty, std::list<item> items, std::vector<item_
     }
 
     for( item &component : components ) {
-        for( const std::string &f : component.item_tags ) {
+        for( const flag_id &f : component.item_tags ) {
             if( json_flag::get( f ).craft_inherit() ) {
                 set_flag( f );
             }
         }
-        for( const std::string &f : component.type->item_tags ) {
+        for( const flag_id &f : component.type->item_tags ) {
             if( json_flag::get( f ).craft_inherit() ) {
                 set_flag( f );
             }
@@ -3752,13 +3752,16 @@ void item::final_info( std::vector<iteminfo> &info, const iteminfo_query *parts,
 
     if( parts->test( iteminfo_parts::DESCRIPTION_FLAGS ) ) {
         // concatenate base and acquired flags...
-        std::vector<std::string> flags;
+        std::vector<flag_id> flags;
         std::set_union( type->item_tags.begin(), type->item_tags.end(),
                         item_tags.begin(), item_tags.end(),
                         std::back_inserter( flags ) );
+        std::sort( flags.begin(), flags.end(), []( const flag_id & lhs, const flag_id & rhs ) {
+            return lhs.str() < rhs.str();
+        } );
 
         // ...and display those which have an info description
-        for( const std::string &e : flags ) {
+        for( const flag_id &e : flags ) {
             const json_flag &f = json_flag::get( e );
             if( !f.info().empty() ) {
                 info.emplace_back( "DESCRIPTION", string_format( "* %s", _( f.info() ) ) );
@@ -5280,7 +5283,7 @@ bool item::has_fault( const fault_id &fault ) const
     return faults.count( fault );
 }
 
-bool item::has_flag( const std::string &f ) const
+bool item::has_flag( const flag_id &f ) const
 {
     bool ret = false;
 
@@ -5304,6 +5307,12 @@ bool item::has_flag( const std::string &f ) const
     return ret;
 }
 
+bool item::has_flag( const std::string &f ) const
+{
+    const cata::optional<flag_id> id = flag_id::lookup( f );
+    return id && has_flag( *id );
+}
+
 bool item::has_any_flag( const std::vector<std::string> &flags ) const
 {
     for( const std::string &flag : flags ) {
@@ -5315,12 +5324,23 @@ bool item::has_any_flag( const std::vector<std::string> &flags ) const
     return false;
 }
 
-item &item::set_flag( const std::string &flag )
+item &item::set_flag( const flag_id &flag )
 {
     item_tags.insert( flag );
     return *this;
 }
 
+item &item::set_flag( const std::string &flag )
+{
+    return set_flag( flag_id( flag ) );
+}
+
+item &item::unset_flag( const flag_id &flag )
+{
+    item_tags.erase( flag );
+    return *this;
+}
+
 item &item::unset_flag( const std::string &flag )
 {
     item_tags.erase( flag );
@@ -5450,10 +5470,10 @@ int item::get_comestible_fun() const
         return 0;
     }
     int fun = get_comestible()->fun;
-    for( const std::string &flag : item_tags ) {
+    for( const flag_id &flag : item_tags ) {
         fun += json_flag::get( flag ).taste_mod();
     }
-    for( const std::string &flag : type->item_tags ) {
+    for( const flag_id &flag : type->item_tags ) {
         fun += json_flag::get( flag ).taste_mod();
     }
 
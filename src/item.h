@@ -18,7 +18,7 @@
 #include "cata_utility.h"
 #include "craft_command.h"
 #include "enums.h"
-#include "flat_set.h"
+#include "flag.h"
 #include "gun_mode.h"
 #include "io_tags.h"
 #include "item_contents.h"
@@ -1421,15 +1421,21 @@ class item : public visitable<item>
          * item itself (@ref item_tags). The item has the flag if it appears in either set.
          *
          * Gun mods that are attached to guns also contribute their flags to the gun item.
+         *
+         * Prefer the @ref flag_id overloads in hot code, the string ones have to look
+         * the flag up first.
          */
         /*@{*/
+        bool has_flag( const flag_id &flag ) const;
         bool has_flag( const std::string &flag ) const;
         bool has_any_flag( const std::vector<std::string> &flags ) const;
 
         /** Idempotent filter setting an item specific flag. */
+        item &set_flag( const flag_id &flag );
         item &set_flag( const std::string &flag );
 
         /** Idempotent filter removing an item specific flag */
+        item &unset_flag( const flag_id &flag );
         item &unset_flag( const std::string &flag );
 
         /** Idempotent filter recursively setting an item specific flag on this item and its components. */
@@ -2195,7 +2201,7 @@ class item : public visitable<item>
         std::list<item> components;
         /** What faults (if any) currently apply to this item */
         std::set<fault_id> faults;
-        cata::flat_set<std::string> item_tags; // generic item specific flags
+        flag_set item_tags; // generic item specific flags
 
     private:
         safe_reference_anchor anchor;
@@ -7,6 +7,7 @@
 #include "avatar.h"
 #include "character.h"
 #include "enums.h"
+#include "hash_utils.h"
 #include "item.h"
 #include "item_category.h"
 #include "item_factory.h"
@@ -1099,6 +1100,7 @@ void item_contents::update_modified_pockets(
     const cata::optional<const pocket_data *> &mag_or_mag_well,
     std::vector<const pocket_data *> container_pockets )
 {
+    pocket_changes++;
     for( auto pocket_iter = contents.begin(); pocket_iter != contents.end(); ) {
         item_pocket &pocket = *pocket_iter;
         if( pocket.is_type( item_pocket::pocket_type::CONTAINER ) ) {
@@ -1159,6 +1161,16 @@ void item_contents::update_modified_pockets(
 
 }
 
+size_t item_contents::changes() const
+{
+    size_t ret = pocket_changes;
+    for( const item_pocket &pocket : contents ) {
+        cata::hash_combine( ret, &pocket );
+        cata::hash_combine( ret, pocket.changes() );
+    }
+    return ret;
+}
+
 std::set<itype_id> item_contents::magazine_compatible() const
 {
     std::set<itype_id> ret;
@@ -3,6 +3,7 @@
 #define CATA_SRC_ITEM_CONTENTS_H
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <set>
@@ -89,6 +90,11 @@ class item_contents
 
         void update_modified_pockets( const cata::optional<const pocket_data *> &mag_or_mag_well,
                                       std::vector<const pocket_data *> container_pockets );
+        /**
+         * Changes whenever pockets are added or removed, or the contents of any pocket change.
+         * @see item_pocket::changes
+         */
+        size_t changes() const;
         // all magazines compatible with any pockets.
         // this only checks MAGAZINE_WELL
         std::set<itype_id> magazine_compatible() const;
@@ -263,6 +269,8 @@ class item_contents
         std::list<item *> all_items_top_recursive( item_pocket::pocket_type pk_type );
 
         std::list<item_pocket> contents;
+        // pockets added or removed, see changes()
+        uint64_t pocket_changes = 0;
 
         struct item_contents_helper;
         friend struct item_contents_helper;
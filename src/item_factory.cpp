@@ -211,7 +211,7 @@ void Item_factory::finalize_pre( itype &obj )
     if( obj.volume <= 0_ml ) {
         obj.volume = units::from_milliliter( 1 );
     }
-    for( const auto &tag : obj.item_tags ) {
+    for( const std::string &tag : obj.item_tags ) {
         if( tag.size() > 6 && tag.substr( 0, 6 ) == "LIGHT_" ) {
             obj.light_emission = std::max( atoi( tag.substr( 6 ).c_str() ), 0 );
         }
@@ -2738,7 +2738,11 @@ void Item_factory::load_basic_info( const JsonObject &jo, itype &def, const std:
         def.explosion = load_explosion_data( je );
     }
 
-    assign( jo, "flags", def.item_tags );
+    // Through a set of strings, for the "extend" and "delete" handling of assign
+    std::set<std::string> flags( def.item_tags.begin(), def.item_tags.end() );
+    if( assign( jo, "flags", flags ) ) {
+        def.item_tags = flag_set( flags );
+    }
     assign( jo, "faults", def.faults );
 
     if( jo.has_member( "qualities" ) ) {
@@ -2903,8 +2907,9 @@ void Item_factory::migrate_item( const itype_id &id, item &obj )
 {
     auto iter = migrations.find( id );
     if( iter != migrations.end() ) {
-        std::copy( iter->second.flags.begin(), iter->second.flags.end(), std::inserter( obj.item_tags,
-                   obj.item_tags.begin() ) );
+        for( const std::string &flag : iter->second.flags ) {
+            obj.item_tags.insert( flag );
+        }
         if( iter->second.charges > 0 ) {
             obj.charges = iter->second.charges;
         }
@@ -7,6 +7,7 @@
 #include "enums.h"
 #include "generic_factory.h"
 #include "handle_liquid.h"
+#include "hash_utils.h"
 #include "item.h"
 #include "item_category.h"
 #include "item_factory.h"
@@ -172,6 +173,7 @@ bool item_pocket::same_contents( const item_pocket &rhs ) const
 
 void item_pocket::restack()
 {
+    count_change();
     if( contents.size() <= 1 ) {
         return;
     }
@@ -196,6 +198,7 @@ void item_pocket::restack()
 
 item *item_pocket::restack( /*const*/ item *it )
 {
+    count_change();
     item *ret = it;
     if( contents.size() <= 1 ) {
         return ret;
@@ -523,6 +526,7 @@ itype_id item_pocket::magazine_default() const
 
 int item_pocket::ammo_consume( int qty )
 {
+    count_change();
     int need = qty;
     int used = 0;
     while( !contents.empty() ) {
@@ -561,6 +565,7 @@ std::set<ammotype> item_pocket::ammo_types() const
 
 void item_pocket::casings_handle( const std::function<bool( item & )> &func )
 {
+    count_change();
     for( auto it = contents.begin(); it != contents.end(); ) {
         if( it->has_flag( "CASING" ) ) {
             it->unset_flag( "CASING" );
@@ -577,6 +582,7 @@ void item_pocket::casings_handle( const std::function<bool( item & )> &func )
 
 void item_pocket::handle_liquid_or_spill( Character &guy, const item *avoid )
 {
+    count_change();
     for( auto iter = contents.begin(); iter != contents.end(); ) {
         if( iter->made_of( phase_id::LIQUID ) ) {
             item liquid( *iter );
@@ -670,6 +676,7 @@ bool item_pocket::detonate( const tripoint &pos, std::vector<item> &drops )
     } );
     if( new_end != contents.end() ) {
         contents.erase( new_end, contents.end() );
+        count_change();
         // If any of the contents explodes, so does the container
         return true;
     }
@@ -687,6 +694,7 @@ bool item_pocket::process( const itype &type, player *carrier, const tripoint &p
         }
         if( it->process( carrier, pos, type.insulation_factor * insulation, flag, spoil_multiplier ) ) {
             it = contents.erase( it );
+            count_change();
             processed = true;
         } else {
             ++it;
@@ -697,6 +705,7 @@ bool item_pocket::process( const itype &type, player *carrier, const tripoint &p
 
 void item_pocket::remove_all_ammo( Character &guy )
 {
+    count_change();
     for( auto iter = contents.begin(); iter != contents.end(); ) {
         if( iter->is_irremovable() ) {
             iter++;
@@ -709,6 +718,7 @@ void item_pocket::remove_all_ammo( Character &guy )
 
 void item_pocket::remove_all_mods( Character &guy )
 {
+    count_change();
     for( auto iter = contents.begin(); iter != contents.end(); ) {
         if( iter->is_toolmod() ) {
             guy.i_add_or_drop( *iter );
@@ -1060,6 +1070,7 @@ cata::optional<item> item_pocket::remove_item( const item &it )
     if( sz == contents.size() ) {
         return cata::nullopt;
     } else {
+        count_change();
         return ret;
     }
 }
@@ -1070,6 +1081,7 @@ bool item_pocket::remove_internal( const std::function<bool( item & )> &filter,
     for( auto it = contents.begin(); it != contents.end(); ) {
         if( filter( *it ) ) {
             res.splice( res.end(), contents, it++ );
+            count_change();
             if( --count == 0 ) {
                 return true;
             }
@@ -1091,6 +1103,7 @@ cata::optional<item> item_pocket::remove_item( const item_location &it )
 
 void item_pocket::overflow( const tripoint &pos )
 {
+    count_change();
     if( is_type( item_pocket::pocket_type::MOD ) || is_type( item_pocket::pocket_type::CORPSE ) ) {
         return;
     }
@@ -1186,6 +1199,7 @@ void item_pocket::on_contents_changed()
 
 bool item_pocket::spill_contents( const tripoint &pos )
 {
+    count_change();
     map &here = get_map();
     for( item &it : contents ) {
         here.add_item_or_charges( pos, it );
@@ -1197,6 +1211,7 @@ bool item_pocket::spill_contents( const tripoint &pos )
 
 void item_pocket::clear_items()
 {
+    count_change();
     contents.clear();
 }
 
@@ -1232,6 +1247,7 @@ void item_pocket::process( player *carrier, const tripoint &pos, float insulatio
                            // spoil multipliers on pockets are not additive or multiplicative, they choose the best
                            std::min( spoil_multiplier_parent, spoil_multiplier() ) ) ) {
             iter = contents.erase( iter );
+            count_change();
         } else {
             ++iter;
         }
@@ -1313,9 +1329,27 @@ bool item_pocket::can_unload_liquid() const
 
 std::list<item> &item_pocket::edit_contents()
 {
+    count_change();
     return contents;
 }
 
+void item_pocket::count_change()
+{
+    change_count++;
+}
+
+size_t item_pocket::changes() const
+{
+    size_t ret = change_count;
+    for( const item &it : contents ) {
+        // Charges are assigned directly all over the place, so they are compared instead of counted
+        cata::hash_combine( ret, &it );
+        cata::hash_combine( ret, it.charges );
+        cata::hash_combine( ret, it.contents.changes() );
+    }
+    return ret;
+}
+
 ret_val<item_pocket::contain_code> item_pocket::insert_item( const item &it )
 {
     const ret_val<item_pocket::contain_code> ret = !is_standard_type() ?
@@ -2,6 +2,8 @@
 #ifndef CATA_SRC_ITEM_POCKET_H
 #define CATA_SRC_ITEM_POCKET_H
 
+#include <cstddef>
+#include <cstdint>
 #include <list>
 
 #include "enums.h"
@@ -248,6 +250,12 @@ class item_pocket
         // only available to help with migration from previous usage of std::list<item>
         std::list<item> &edit_contents();
 
+        /**
+         * Changes whenever the items in this pocket, their charges or their own contents change,
+         * so caches of what a character carries can tell when they are out of date.
+         */
+        size_t changes() const;
+
         // cost of getting an item from this pocket
         // @TODO: make move cost vary based on other contained items
         int obtain_cost( const item &it ) const;
@@ -286,6 +294,9 @@ class item_pocket
         // the items inside the pocket
         std::list<item> contents;
         bool _sealed = false;
+        // changes made to contents through this pocket, see changes()
+        uint64_t change_count = 0;
+        void count_change();
 };
 
 /**
@@ -708,37 +708,194 @@ void add_array_to_set( std::set<std::string> &s, const JsonObject &json, const s
     }
 }
 
+inline bool JsonIn::buffer_sentry()
+{
+    if( buffer_eof || buffer_fail ) {
+        buffer_fail = true;
+        return false;
+    }
+    return true;
+}
+
+inline int JsonIn::peek_char()
+{
+    if( stream ) {
+        return stream->peek();
+    }
+    if( !buffer_sentry() ) {
+        return EOF;
+    }
+    if( buffer_pos == buffer_end ) {
+        buffer_eof = true;
+        return EOF;
+    }
+    return static_cast<unsigned char>( *buffer_pos );
+}
+
+inline int JsonIn::get_char()
+{
+    if( stream ) {
+        return stream->get();
+    }
+    if( !buffer_sentry() ) {
+        return EOF;
+    }
+    if( buffer_pos == buffer_end ) {
+        buffer_eof = true;
+        buffer_fail = true;
+        return EOF;
+    }
+    return static_cast<unsigned char>( *buffer_pos++ );
+}
+
+inline void JsonIn::get_char( char &ch )
+{
+    if( stream ) {
+        stream->get( ch );
+        return;
+    }
+    const int c = get_char();
+    if( c != EOF ) {
+        ch = static_cast<char>( c );
+    }
+}
+
+void JsonIn::get_text( char *text, int count )
+{
+    if( stream ) {
+        stream->get( text, count );
+        return;
+    }
+    text[0] = '\0';
+    if( !buffer_sentry() ) {
+        return;
+    }
+    int extracted = 0;
+    while( extracted < count - 1 && buffer_pos != buffer_end && *buffer_pos != '\n' ) {
+        text[extracted++] = *buffer_pos++;
+    }
+    text[extracted] = '\0';
+    // The stream looks at the next character, so it notices the end right away
+    if( buffer_pos == buffer_end ) {
+        buffer_eof = true;
+    }
+    if( extracted == 0 ) {
+        buffer_fail = true;
+    }
+}
+
+void JsonIn::read_text( char *text, size_t count )
+{
+    if( stream ) {
+        stream->read( text, count );
+        return;
+    }
+    if( !buffer_sentry() ) {
+        return;
+    }
+    const size_t available = std::min( count, static_cast<size_t>( buffer_end - buffer_pos ) );
+    std::copy( buffer_pos, buffer_pos + available, text );
+    buffer_pos += available;
+    if( available < count ) {
+        buffer_eof = true;
+        buffer_fail = true;
+    }
+}
+
+void JsonIn::unget_char()
+{
+    if( stream ) {
+        stream->unget();
+        return;
+    }
+    buffer_eof = false;
+    if( !buffer_sentry() ) {
+        return;
+    }
+    if( buffer_pos == buffer_begin ) {
+        buffer_fail = true;
+    } else {
+        --buffer_pos;
+    }
+}
+
+void JsonIn::seek_relative( int offset )
+{
+    if( stream ) {
+        stream->seekg( offset, std::istream::cur );
+        return;
+    }
+    buffer_eof = false;
+    if( buffer_fail ) {
+        return;
+    }
+    if( offset < buffer_begin - buffer_pos || offset > buffer_end - buffer_pos ) {
+        buffer_fail = true;
+    } else {
+        buffer_pos += offset;
+    }
+}
+
+bool JsonIn::source_eof() const
+{
+    return stream ? stream->eof() : buffer_eof;
+}
+
+bool JsonIn::source_fail() const
+{
+    return stream ? stream->fail() : buffer_fail;
+}
+
 int JsonIn::tell()
 {
-    return stream->tellg();
+    if( stream ) {
+        return stream->tellg();
+    }
+    return buffer_sentry() ? buffer_pos - buffer_begin : -1;
 }
 char JsonIn::peek()
 {
-    return static_cast<char>( stream->peek() );
+    return static_cast<char>( peek_char() );
 }
 bool JsonIn::good()
 {
-    return stream->good();
+    return stream ? stream->good() : !buffer_eof && !buffer_fail;
 }
 
 void JsonIn::seek( int pos )
 {
-    stream->clear();
-    stream->seekg( pos );
+    if( stream ) {
+        stream->clear();
+        stream->seekg( pos );
+    } else {
+        buffer_eof = false;
+        buffer_fail = pos < 0 || pos > buffer_end - buffer_begin;
+        if( !buffer_fail ) {
+            buffer_pos = buffer_begin + pos;
+        }
+    }
     ate_separator = false;
 }
 
 void JsonIn::eat_whitespace()
 {
+    if( !stream && good() ) {
+        while( buffer_pos != buffer_end && is_whitespace( *buffer_pos ) ) {
+            ++buffer_pos;
+        }
+        // Peeking at the end sets eof
+        buffer_eof = buffer_pos == buffer_end;
+        return;
+    }
     while( is_whitespace( peek() ) ) {
-        stream->get();
+        get_char();
     }
 }
 
 void JsonIn::uneat_whitespace()
 {
     while( tell() > 0 ) {
-        stream->seekg( -1, std::istream::cur );
+        seek_relative( -1 );
         if( !is_whitespace( peek() ) ) {
             break;
         }
@@ -766,7 +923,7 @@ void JsonIn::skip_separator()
         if( ate_separator ) {
             error( "duplicate separator" );
         }
-        stream->get();
+        get_char();
         ate_separator = true;
     } else if( ch == ']' || ch == '}' || ch == ':' ) {
         // okay
@@ -795,7 +952,7 @@ void JsonIn::skip_pair_separator()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch != ':' ) {
         std::stringstream err;
         err << "expected pair separator ':', not '" << ch << "'";
@@ -810,16 +967,16 @@ void JsonIn::skip_string()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch != '"' ) {
         std::stringstream err;
         err << "expecting string but found '" << ch << "'";
         error( err.str(), -1 );
     }
-    while( stream->good() ) {
-        stream->get( ch );
+    while( good() ) {
+        get_char( ch );
         if( ch == '\\' ) {
-            stream->get( ch );
+            get_char( ch );
             continue;
         } else if( ch == '"' ) {
             break;
@@ -884,7 +1041,7 @@ void JsonIn::skip_true()
 {
     char text[5];
     eat_whitespace();
-    stream->get( text, 5 );
+    get_text( text, 5 );
     if( strcmp( text, "true" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "true", but found ")" << text << "\"";
@@ -897,7 +1054,7 @@ void JsonIn::skip_false()
 {
     char text[6];
     eat_whitespace();
-    stream->get( text, 6 );
+    get_text( text, 6 );
     if( strcmp( text, "false" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "false", but found ")" << text << "\"";
@@ -910,7 +1067,7 @@ void JsonIn::skip_null()
 {
     char text[5];
     eat_whitespace();
-    stream->get( text, 5 );
+    get_text( text, 5 );
     if( strcmp( text, "null" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "null", but found ")" << text << "\"";
@@ -924,11 +1081,11 @@ void JsonIn::skip_number()
     char ch;
     eat_whitespace();
     // skip all of (+-0123456789.eE)
-    while( stream->good() ) {
-        stream->get( ch );
+    while( good() ) {
+        get_char( ch );
         if( ch != '+' && ch != '-' && ( ch < '0' || ch > '9' ) &&
             ch != 'e' && ch != 'E' && ch != '.' ) {
-            stream->unget();
+            unget_char();
             break;
         }
     }
@@ -951,16 +1108,33 @@ std::string JsonIn::get_string()
     eat_whitespace();
     int startpos = tell();
     // the first character had better be a '"'
-    stream->get( ch );
+    get_char( ch );
     if( ch != '"' ) {
         std::stringstream err;
         err << "expecting string but got '" << ch << "'";
         error( err.str(), -1 );
     }
+    if( !stream ) {
+        // Take everything up to the first escape (usually the whole string) in one go
+        const char *const begin = buffer_pos;
+        while( buffer_pos != buffer_end && *buffer_pos != '"' && *buffer_pos != '\\' &&
+               static_cast<unsigned char>( *buffer_pos ) >= 0x20 ) {
+            ++buffer_pos;
+        }
+        s.assign( begin, buffer_pos );
+        if( buffer_pos == buffer_end ) {
+            buffer_eof = true;
+            buffer_fail = true;
+        } else if( *buffer_pos == '"' ) {
+            ++buffer_pos;
+            end_value();
+            return s;
+        }
+    }
     // add chars to the string, one at a time, converting:
     // \", \\, \/, \b, \f, \n, \r, \t and \uxxxx according to JSON spec.
-    while( stream->good() ) {
-        stream->get( ch );
+    while( good() ) {
+        get_char( ch );
         if( ch == '\\' ) {
             if( backslash ) {
                 s += '\\';
@@ -987,7 +1161,7 @@ std::string JsonIn::get_string()
                 s += '\t';
             } else if( ch == 'u' ) {
                 // get the next four characters as hexadecimal
-                stream->get( unihex, 5 );
+                get_text( unihex, 5 );
                 // insert the appropriate unicode character in utf8
                 // TODO: verify that unihex is in fact 4 hex digits.
                 char **endptr = nullptr;
@@ -1014,11 +1188,10 @@ std::string JsonIn::get_string()
         }
     }
     // if we get to here, probably hit a premature EOF?
-    if( stream->eof() ) {
-        stream->clear();
+    if( source_eof() ) {
         seek( startpos );
         error( "couldn't find end of string, reached EOF." );
-    } else if( stream->fail() ) {
+    } else if( source_fail() ) {
         throw JsonError( "stream failure while reading string." );
     }
     throw JsonError( "something went wrong D:" );
@@ -1157,9 +1330,9 @@ number_sci_notation JsonIn::get_any_number()
     number_sci_notation ret;
     int mod_e = 0;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ( ret.negative = ch == '-' ) ) {
-        stream->get( ch );
+        get_char( ch );
     } else if( ch != '.' && ( ch < '0' || ch > '9' ) ) {
         // not a valid float
         std::stringstream err;
@@ -1168,7 +1341,7 @@ number_sci_notation JsonIn::get_any_number()
     }
     if( ch == '0' ) {
         // allow a single leading zero in front of a '.' or 'e'/'E'
-        stream->get( ch );
+        get_char( ch );
         if( ch >= '0' && ch <= '9' ) {
             error( "leading zeros not strictly allowed", -1 );
         }
@@ -1176,36 +1349,36 @@ number_sci_notation JsonIn::get_any_number()
     while( ch >= '0' && ch <= '9' ) {
         ret.number *= 10;
         ret.number += ( ch - '0' );
-        stream->get( ch );
+        get_char( ch );
     }
     if( ch == '.' ) {
-        stream->get( ch );
+        get_char( ch );
         while( ch >= '0' && ch <= '9' ) {
             ret.number *= 10;
             ret.number += ( ch - '0' );
             mod_e -= 1;
-            stream->get( ch );
+            get_char( ch );
         }
     }
     if( ch == 'e' || ch == 'E' ) {
-        stream->get( ch );
+        get_char( ch );
         bool neg;
         if( ( neg = ch == '-' ) ) {
-            stream->get( ch );
+            get_char( ch );
         } else if( ch == '+' ) {
-            stream->get( ch );
+            get_char( ch );
         }
         while( ch >= '0' && ch <= '9' ) {
             ret.exp *= 10;
             ret.exp += ( ch - '0' );
-            stream->get( ch );
+            get_char( ch );
         }
         if( neg ) {
             ret.exp *= -1;
         }
     }
     // unget the final non-number character (probably a separator)
-    stream->unget();
+    unget_char();
     end_value();
     ret.exp += mod_e;
     return ret;
@@ -1217,9 +1390,9 @@ bool JsonIn::get_bool()
     char text[5];
     std::stringstream err;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch == 't' ) {
-        stream->get( text, 4 );
+        get_text( text, 4 );
         if( strcmp( text, "rue" ) == 0 ) {
             end_value();
             return true;
@@ -1229,7 +1402,7 @@ bool JsonIn::get_bool()
             error( err.str(), -4 );
         }
     } else if( ch == 'f' ) {
-        stream->get( text, 5 );
+        get_text( text, 5 );
         if( strcmp( text, "alse" ) == 0 ) {
             end_value();
             return false;
@@ -1256,7 +1429,7 @@ void JsonIn::start_array()
 {
     eat_whitespace();
     if( peek() == '[' ) {
-        stream->get();
+        get_char();
         ate_separator = false;
         return;
     } else {
@@ -1276,7 +1449,7 @@ bool JsonIn::end_array()
             uneat_whitespace();
             error( "separator not strictly allowed at end of array" );
         }
-        stream->get();
+        get_char();
         end_value();
         return true;
     } else {
@@ -1289,7 +1462,7 @@ void JsonIn::start_object()
 {
     eat_whitespace();
     if( peek() == '{' ) {
-        stream->get();
+        get_char();
         ate_separator = false; // not that we want to
         return;
     } else {
@@ -1309,7 +1482,7 @@ bool JsonIn::end_object()
             uneat_whitespace();
             error( "separator not strictly allowed at end of object" );
         }
-        stream->get();
+        get_char();
         end_value();
         return true;
     } else {
@@ -1521,10 +1694,10 @@ bool JsonIn::read( JsonDeserializer &j, bool throw_on_error )
 // WARNING: for occasional use only.
 std::string JsonIn::line_number( int offset_modifier )
 {
-    if( !stream || stream->fail() ) {
+    if( source_fail() ) {
         return "???";
     }
-    if( stream->eof() ) {
+    if( source_eof() ) {
         return "EOF";
     } // else stream is fine
     int pos = tell();
@@ -1533,12 +1706,12 @@ std::string JsonIn::line_number( int offset_modifier )
     char ch;
     seek( 0 );
     for( int i = 0; i < pos; ++i ) {
-        stream->get( ch );
+        get_char( ch );
         if( ch == '\r' ) {
             offset = 1;
             ++line;
             if( peek() == '\n' ) {
-                stream->get();
+                get_char();
                 ++i;
             }
         } else if( ch == '\n' ) {
@@ -1558,17 +1731,17 @@ void JsonIn::error( const std::string &message, int offset )
     std::ostringstream err;
     err << line_number( offset ) << ": " << message;
     // if we can't get more info from the stream don't try
-    if( !stream->good() ) {
+    if( !good() ) {
         throw JsonError( err.str() );
     }
     // also print surrounding few lines of context, if not too large
     err << "\n\n";
-    stream->seekg( offset, std::istream::cur );
+    seek_relative( offset );
     size_t pos = tell();
     rewind( 3, 240 );
     size_t startpos = tell();
     std::string buffer( pos - startpos, '\0' );
-    stream->read( &buffer[0], pos - startpos );
+    read_text( &buffer[0], pos - startpos );
     auto it = buffer.begin();
     for( ; it < buffer.end() && ( *it == '\r' || *it == '\n' ); ++it ) {
         // skip starting newlines
@@ -1596,10 +1769,10 @@ void JsonIn::error( const std::string &message, int offset )
     err << "^\n";
     seek( pos );
     // if that wasn't the end of the line, continue underneath pointer
-    char ch = stream->get();
+    char ch = get_char();
     if( ch == '\r' ) {
         if( peek() == '\n' ) {
-            stream->get();
+            get_char();
         }
     } else if( ch == '\n' ) {
         // pass
@@ -1610,16 +1783,16 @@ void JsonIn::error( const std::string &message, int offset )
     }
     // print the next couple lines as well
     int line_count = 0;
-    for( int i = 0; line_count < 3 && stream->good() && i < 240; ++i ) {
-        stream->get( ch );
-        if( !stream->good() ) {
+    for( int i = 0; line_count < 3 && good() && i < 240; ++i ) {
+        get_char( ch );
+        if( !good() ) {
             break;
         }
         if( ch == '\r' ) {
             ch = '\n';
             ++line_count;
-            if( stream->peek() == '\n' ) {
-                stream->get( ch );
+            if( peek_char() == '\n' ) {
+                get_char( ch );
             }
         } else if( ch == '\n' ) {
             ++line_count;
@@ -1652,13 +1825,13 @@ void JsonIn::rewind( int max_lines, int max_chars )
         return;
     }
     int lines_found = 0;
-    stream->seekg( -1, std::istream::cur );
+    seek_relative( -1 );
     for( int i = 0; i < max_chars; ++i ) {
         size_t tellpos = tell();
         if( peek() == '\n' ) {
             ++lines_found;
             if( tellpos > 0 ) {
-                stream->seekg( -1, std::istream::cur );
+                seek_relative( -1 );
                 // note: does not update tellpos or count a character
                 if( peek() != '\r' ) {
                     continue;
@@ -1671,16 +1844,23 @@ void JsonIn::rewind( int max_lines, int max_chars )
             break;
         } else if( lines_found == max_lines ) {
             // don't include the last \n or \r
-            stream->seekg( 1, std::istream::cur );
+            seek_relative( 1 );
             break;
         }
-        stream->seekg( -1, std::istream::cur );
+        seek_relative( -1 );
     }
 }
 
 std::string JsonIn::substr( size_t pos, size_t len )
 {
     std::string ret;
+    if( !stream ) {
+        const size_t size = buffer_end - buffer_begin;
+        pos = std::min( pos, size );
+        ret.assign( buffer_begin + pos, std::min( len, size - pos ) );
+        buffer_pos = buffer_begin + pos + ret.size();
+        return ret;
+    }
     if( len == std::string::npos ) {
         stream->seekg( 0, std::istream::end );
         size_t end = tell();
@@ -91,6 +91,8 @@ struct number_sci_notation {
  *
  * The JsonIn class provides a wrapper around a std::istream,
  * with methods for reading JSON data directly from the stream.
+ * It can also read straight from a buffer in memory (e.g. a @ref mapped_file),
+ * which avoids the overhead of the stream for every character.
  *
  * JsonObject and JsonArray provide higher-level wrappers,
  * and are a little easier to use in most cases,
@@ -169,15 +171,38 @@ struct number_sci_notation {
 class JsonIn
 {
     private:
-        std::istream *stream;
+        // Either stream is set, or the data is read from [buffer_begin, buffer_end).
+        std::istream *stream = nullptr;
+        const char *buffer_begin = nullptr;
+        const char *buffer_pos = nullptr;
+        const char *buffer_end = nullptr;
+        // Behave like the eofbit and failbit of a stream, so both sources give the same errors
+        bool buffer_eof = false;
+        bool buffer_fail = false;
         bool ate_separator = false;
 
         void skip_separator();
         void skip_pair_separator();
         void end_value();
 
+        // Character access with the semantics of the std::istream functions of the same name
+        int peek_char();
+        int get_char();
+        void get_char( char &ch );
+        void get_text( char *text, int count );
+        void read_text( char *text, size_t count );
+        void unget_char();
+        void seek_relative( int offset );
+        bool source_eof() const;
+        bool source_fail() const;
+        // Like the sentry of an unformatted input function of a stream
+        bool buffer_sentry();
+
     public:
         JsonIn( std::istream &s ) : stream( &s ) {}
+        /** Reads from size bytes at data, which must stay valid as long as this is used. */
+        JsonIn( const char *data, size_t size ) :
+            buffer_begin( data ), buffer_pos( data ), buffer_end( data + size ) {}
         JsonIn( const JsonIn & ) = delete;
         JsonIn &operator=( const JsonIn & ) = delete;
 
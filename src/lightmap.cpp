@@ -30,6 +30,7 @@
 #include "string_formatter.h"
 #include "submap.h"
 #include "tileray.h"
+#include "turn_profiler.h"
 #include "type_id.h"
 #include "veh_type.h"
 #include "vehicle.h"
@@ -74,7 +75,7 @@ void map::add_light_from_items( const tripoint &p, const item_stack::iterator &b
 }
 
 // TODO: Consider making this just clear the cache and dynamically fill it in as is_transparent() is called
-bool map::build_transparency_cache( const int zlev )
+bool map::build_transparency_cache( const int zlev, const float sight_penalty )
 {
     auto &map_cache = get_cache( zlev );
     auto &transparency_cache = map_cache.transparency_cache;
@@ -89,8 +90,6 @@ bool map::build_transparency_cache( const int zlev )
         &transparency_cache[0][0], MAPSIZE_X * MAPSIZE_Y,
         static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
 
-    const float sight_penalty = get_weather().weather_id->sight_penalty;
-
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
@@ -277,10 +276,12 @@ void map::build_sunlight_cache( int zlev )
 
 void map::generate_lightmap( const int zlev )
 {
+    TURN_PROFILER_ZONE( "map::generate_lightmap" );
     auto &map_cache = get_cache( zlev );
     auto &lm = map_cache.lm;
     auto &sm = map_cache.sm;
     auto &outside_cache = map_cache.outside_cache;
+    auto &transparency_cache = map_cache.transparency_cache;
     std::memset( lm, 0, sizeof( lm ) );
     std::memset( sm, 0, sizeof( sm ) );
 
@@ -322,6 +323,16 @@ void map::generate_lightmap( const int zlev )
         apply_character_light( guy );
     }
 
+    /* Light from stationary sources is the bulk of the work in a well lit base, and usually
+       doesn't change from one turn to the next. All lights combine by taking the maximum, so
+       it is cast onto an empty lightmap, kept and merged into the full one. Only when one of
+       its inputs changes (sources, transparency, natural light) is it cast again.
+     */
+    if( !stationary_light ) {
+        stationary_light = std::make_unique<stationary_lightmap>();
+    }
+    stationary_lightmap &stationary = *stationary_light;
+    std::vector<stationary_lightmap::light_arc> arcs;
     std::vector<std::pair<tripoint, float>> lm_override;
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
@@ -333,33 +344,22 @@ void map::generate_lightmap( const int zlev )
                     const int x = sx + smx * SEEX;
                     const int y = sy + smy * SEEY;
                     const tripoint p( x, y, zlev );
-                    // Project light into any openings into buildings.
-                    if( !outside_cache[p.x][p.y] ) {
-                        // Apply light sources for external/internal divide
-                        for( int i = 0; i < 4; ++i ) {
-                            point neighbour = p.xy() + point( dir_x[i], dir_y[i] );
-                            if( lightmap_boundaries.contains( neighbour )
-                                && outside_cache[neighbour.x][neighbour.y]
-                              ) {
-                                if( light_transparency( p ) > LIGHT_TRANSPARENCY_SOLID ) {
-                                    update_light_quadrants(
-                                        lm[p.x][p.y], natural_light, quadrant::default_ );
-                                    apply_directional_light( p, dir_d[i], natural_light );
+
+                    if( cur_submap->get_lum( { sx, sy } ) && has_items( p ) ) {
+                        for( const item &it : i_at( p ) ) {
+                            float ilum = 0.0; // brightness
+                            int iwidth = 0; // 0-360 degrees. 0 is a circular light_source
+                            int idir = 0;   // otherwise, it's a light_arc pointed in this direction
+                            if( it.getlight( ilum, iwidth, idir ) ) {
+                                if( iwidth > 0 ) {
+                                    arcs.push_back( { p, idir, ilum, iwidth } );
                                 } else {
-                                    update_light_quadrants(
-                                        lm[p.x][p.y], natural_light, dir_quadrants[i][0] );
-                                    update_light_quadrants(
-                                        lm[p.x][p.y], natural_light, dir_quadrants[i][1] );
+                                    add_light_source( p, ilum );
                                 }
                             }
                         }
                     }
 
-                    if( cur_submap->get_lum( { sx, sy } ) && has_items( p ) ) {
-                        map_stack items = i_at( p );
-                        add_light_from_items( p, items.begin(), items.end() );
-                    }
-
                     const ter_id terrain = cur_submap->get_ter( { sx, sy } );
                     if( terrain->light_emitted > 0 ) {
                         add_light_source( p, terrain->light_emitted );
@@ -385,6 +385,90 @@ void map::generate_lightmap( const int zlev )
         }
     }
 
+    const bool stationary_light_changed = !stationary.valid || stationary.zlev != zlev ||
+                                          stationary.natural_light != natural_light || stationary.trigdist != trigdist ||
+                                          stationary.arcs != arcs ||
+                                          std::memcmp( stationary.light_source_buffer, light_source_buffer,
+                                                  sizeof( light_source_buffer ) ) != 0 ||
+                                          std::memcmp( stationary.transparency_cache, transparency_cache,
+                                                  sizeof( transparency_cache ) ) != 0 ||
+                                          std::memcmp( stationary.outside_cache, outside_cache, sizeof( outside_cache ) ) != 0;
+    if( stationary_light_changed ) {
+        // Set aside the sunlight and character light, and cast onto an empty lightmap
+        std::unique_ptr<four_quadrants[]> saved_lm = std::make_unique<four_quadrants[]>
+                ( MAPSIZE_X * MAPSIZE_Y );
+        std::unique_ptr<float[]> saved_sm = std::make_unique<float[]>( MAPSIZE_X * MAPSIZE_Y );
+        std::copy_n( &lm[0][0], MAPSIZE_X * MAPSIZE_Y, saved_lm.get() );
+        std::copy_n( &sm[0][0], MAPSIZE_X * MAPSIZE_Y, saved_sm.get() );
+        std::memset( lm, 0, sizeof( lm ) );
+        std::memset( sm, 0, sizeof( sm ) );
+
+        // Project light into any openings into buildings.
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                const tripoint p( x, y, zlev );
+                if( outside_cache[p.x][p.y] ) {
+                    continue;
+                }
+                // Apply light sources for external/internal divide
+                for( int i = 0; i < 4; ++i ) {
+                    point neighbour = p.xy() + point( dir_x[i], dir_y[i] );
+                    if( lightmap_boundaries.contains( neighbour )
+                        && outside_cache[neighbour.x][neighbour.y]
+                      ) {
+                        if( light_transparency( p ) > LIGHT_TRANSPARENCY_SOLID ) {
+                            update_light_quadrants(
+                                lm[p.x][p.y], natural_light, quadrant::default_ );
+                            apply_directional_light( p, dir_d[i], natural_light );
+                        } else {
+                            update_light_quadrants(
+                                lm[p.x][p.y], natural_light, dir_quadrants[i][0] );
+                            update_light_quadrants(
+                                lm[p.x][p.y], natural_light, dir_quadrants[i][1] );
+                        }
+                    }
+                }
+            }
+        }
+
+        for( const stationary_lightmap::light_arc &arc : arcs ) {
+            apply_light_arc( arc.p, arc.angle, arc.luminance, arc.wideangle );
+        }
+
+        /* Now that we have position and intensity of all bulk light sources, apply_ them
+          This may seem like extra work, but take a 12x12 raging inferno:
+            unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
+            buffered:   (12*4)*(160)   = apply_light_ray x 7680
+        */
+        const tripoint cache_start( 0, 0, zlev );
+        const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
+        for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
+            if( light_source_buffer[p.x][p.y] > 0.0 ) {
+                apply_light_source( p, light_source_buffer[p.x][p.y] );
+            }
+        }
+
+        stationary.valid = true;
+        stationary.zlev = zlev;
+        stationary.natural_light = natural_light;
+        stationary.trigdist = trigdist;
+        stationary.arcs = arcs;
+        std::memcpy( stationary.light_source_buffer, light_source_buffer, sizeof( light_source_buffer ) );
+        std::memcpy( stationary.transparency_cache, transparency_cache, sizeof( transparency_cache ) );
+        std::memcpy( stationary.outside_cache, outside_cache, sizeof( outside_cache ) );
+        std::memcpy( stationary.lm, lm, sizeof( lm ) );
+        std::memcpy( stationary.sm, sm, sizeof( sm ) );
+
+        std::copy_n( saved_lm.get(), MAPSIZE_X * MAPSIZE_Y, &lm[0][0] );
+        std::copy_n( saved_sm.get(), MAPSIZE_X * MAPSIZE_Y, &sm[0][0] );
+    }
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            lm[x][y] = elementwise_max( lm[x][y], stationary.lm[x][y] );
+            sm[x][y] = std::max( sm[x][y], stationary.sm[x][y] );
+        }
+    }
+
     for( monster &critter : g->all_monsters() ) {
         if( critter.is_hallucination() ) {
             continue;
@@ -473,15 +557,11 @@ void map::generate_lightmap( const int zlev )
         }
     }
 
-    /* Now that we have position and intensity of all bulk light sources, apply_ them
-      This may seem like extra work, but take a 12x12 raging inferno:
-        unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
-        buffered:   (12*4)*(160)   = apply_light_ray x 7680
-    */
+    // Bulk light sources added by vehicles, the stationary ones have been applied already
     const tripoint cache_start( 0, 0, zlev );
     const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
     for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x][p.y] > 0.0 ) {
+        if( light_source_buffer[p.x][p.y] > stationary.light_source_buffer[p.x][p.y] ) {
             apply_light_source( p, light_source_buffer[p.x][p.y] );
         }
     }
@@ -751,6 +831,8 @@ void cast_zlight_segment(
         delta.y = distance;
         bool started_block = false;
         T current_transparency = 0.0f;
+        // Same as in castLight, the intensity only changes with the distance within a row
+        int intensity_dist = -1;
 
         // TODO: Precalculate min/max delta.z based on start/end and distance
         for( delta.z = 0; delta.z <= std::min( fov_3d_z_range, distance ); delta.z++ ) {
@@ -804,7 +886,10 @@ void cast_zlight_segment(
                 }
 
                 const int dist = rl_dist( tripoint_zero, delta ) + offset_distance;
-                last_intensity = calc( numerator, cumulative_transparency, dist );
+                if( dist != intensity_dist ) {
+                    intensity_dist = dist;
+                    last_intensity = calc( numerator, cumulative_transparency, dist );
+                }
 
                 if( !floor_block ) {
                     ( *output_caches[z_index] )[current.x][current.y] =
@@ -1013,6 +1098,8 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
         delta.y = -distance;
         bool started_row = false;
         T current_transparency = 0.0;
+        // Distance that last_intensity was calculated for, see below
+        int intensity_dist = -1;
         float away = start - ( -distance + 0.5f ) / ( -distance -
                      0.5f ); //The distance between our first leadingEdge and start
 
@@ -1035,8 +1122,14 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                 current_transparency = input_array[ current.x ][ current.y ];
             }
 
+            // The cumulative transparency only changes between rows, so the intensity only
+            // changes along a row if the distance does. Without trigdist it never does, which
+            // saves calling calc(), and with it the exp(), for all but the first square.
             const int dist = rl_dist( tripoint_zero, delta ) + offsetDistance;
-            last_intensity = calc( numerator, cumulative_transparency, dist );
+            if( dist != intensity_dist ) {
+                intensity_dist = dist;
+                last_intensity = calc( numerator, cumulative_transparency, dist );
+            }
 
             T new_transparency = input_array[ current.x ][ current.y ];
 
@@ -3,6 +3,7 @@
 #define CATA_SRC_LIGHTMAP_H
 
 #include <cmath>
+#include <cstdint>
 #include <ostream>
 
 static constexpr float LIGHT_SOURCE_LOCAL = 0.1f;
@@ -26,7 +27,8 @@ static constexpr float LIGHT_TRANSPARENCY_CLEAR = 1.0f;
 
 #define LIGHT_RANGE(b) static_cast<int>( -std::log(LIGHT_AMBIENT_LOW / static_cast<float>(b)) * (1.0 / LIGHT_TRANSPARENCY_OPEN_AIR) )
 
-enum class lit_level : int {
+// Stored per square in level_cache::visibility_cache, so kept to a byte
+enum class lit_level : uint8_t {
     DARK = 0,
     LOW, // Hard to see
     BRIGHT_ONLY, // bright but indistinct
@@ -11,8 +11,11 @@
 #include <map>
 #include <array>
 #include <exception>
+#include <fstream>
 #include <functional>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,12 +25,14 @@
 #include <csignal>
 #endif
 #include "color.h"
+#include "cata_utility.h"
 #include "crash.h"
 #include "cursesdef.h"
 #include "debug.h"
 #include "filesystem.h"
 #include "game.h"
 #include "game_ui.h"
+#include "init.h"
 #include "input.h"
 #include "loading_ui.h"
 #include "main_menu.h"
@@ -36,6 +41,7 @@
 #include "output.h"
 #include "path_info.h"
 #include "rng.h"
+#include "submap_quad.h"
 #include "translations.h"
 #include "type_id.h"
 #include "ui_manager.h"
@@ -218,6 +224,9 @@ struct cli_opts {
     dump_mode dmode = dump_mode::TSV;
     std::vector<std::string> opts;
     std::string world; /** if set try to load first save in this world on startup */
+    std::string convert_maps; /** if set convert the map quads below this directory and exit */
+    bool convert_to_binary = true;
+    bool timing = false; /** if set print how long loading the game data took */
 };
 
 cli_opts parse_commandline( int argc, const char **argv )
@@ -227,7 +236,7 @@ cli_opts parse_commandline( int argc, const char **argv )
     const char *section_default = nullptr;
     const char *section_map_sharing = "Map sharing";
     const char *section_user_directory = "User directories";
-    const std::array<arg_handler, 12> first_pass_arguments = {{
+    const std::array<arg_handler, 14> first_pass_arguments = {{
             {
                 "--seed", "<string of letters and or numbers>",
                 "Sets the random number generator's seed value",
@@ -291,6 +300,16 @@ cli_opts parse_commandline( int argc, const char **argv )
                     return 0;
                 }
             },
+            {
+                "--timing", nullptr,
+                "Prints how long each stage of loading the game data takes",
+                section_default,
+                0,
+                [&result]( int, const char ** ) -> int {
+                    result.timing = true;
+                    return 0;
+                }
+            },
             {
                 "--world", "<name>",
                 "Load world",
@@ -301,6 +320,26 @@ cli_opts parse_commandline( int argc, const char **argv )
                     return 1;
                 }
             },
+            {
+                "--convert-maps", "<directory> <binary|json>",
+                "Converts the map savefiles below directory to the given format",
+                section_default,
+                2,
+                [&result]( int, const char **params ) -> int {
+                    result.convert_maps = params[0];
+                    if( !strcmp( params[1], "binary" ) )
+                    {
+                        result.convert_to_binary = true;
+                    } else if( !strcmp( params[1], "json" ) )
+                    {
+                        result.convert_to_binary = false;
+                    } else
+                    {
+                        return -1;
+                    }
+                    return 2;
+                }
+            },
             {
                 "--basepath", "<path>",
                 "Base path for all game data subdirectories",
@@ -492,6 +531,40 @@ cli_opts parse_commandline( int argc, const char **argv )
     return result;
 }
 
+// Converts the map quads below dir, see quad_file::convert. Returns false if any of them failed.
+bool convert_map_quads( const std::string &dir, const bool to_binary )
+{
+    int converted = 0;
+    int skipped = 0;
+    int failed = 0;
+    for( const std::string &path : get_files_from_path( ".map", dir, true, true ) ) {
+        try {
+            std::ifstream fin( path, std::ios::binary );
+            if( !fin ) {
+                throw std::runtime_error( "can't open file" );
+            }
+            std::ostringstream buffer;
+            buffer << fin.rdbuf();
+            fin.close();
+            std::string data = buffer.str();
+            if( !quad_file::convert( data, to_binary ) ) {
+                skipped++;
+                continue;
+            }
+            write_to_file( path, [&data]( std::ostream & fout ) {
+                fout << data;
+            } );
+            converted++;
+        } catch( const std::exception &err ) {
+            printf( "Failed to convert %s: %s\n", path.c_str(), err.what() );
+            failed++;
+        }
+    }
+    printf( "Converted %d map files, %d were already %s, %d failed.\n", converted, skipped,
+            to_binary ? "binary" : "JSON", failed );
+    return failed == 0;
+}
+
 }  // namespace
 
 #if defined(USE_WINMAIN)
@@ -546,6 +619,11 @@ int main( int argc, const char *argv[] )
 
     cli_opts cli = parse_commandline( argc, const_cast<const char **>( argv ) );
 
+    if( !cli.convert_maps.empty() ) {
+        // Doesn't need the game data, quads from before version 22 are left alone
+        exit( convert_map_quads( cli.convert_maps, cli.convert_to_binary ) ? 0 : 1 );
+    }
+
     if( !dir_exist( PATH_INFO::datadir() ) ) {
         printf( "Fatal: Can't find data directory \"%s\"\nPlease ensure the current working directory is correct or specify data directory with --datadir.  Perhaps you meant to start \"cataclysm-launcher\"?\n",
                 PATH_INFO::datadir().c_str() );
@@ -628,6 +706,10 @@ int main( int argc, const char *argv[] )
 
     rng_set_engine_seed( cli.seed );
 
+    if( cli.timing ) {
+        DynamicDataLoader::get_instance().enable_timing();
+    }
+
     g = std::make_unique<game>();
     // First load and initialize everything that does not
     // depend on the mods.
@@ -8,10 +8,13 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <mutex>
 #include <ostream>
 #include <queue>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 #include "active_item_cache.h"
 #include "ammo.h"
@@ -29,6 +32,8 @@
 #include "construction.h"
 #include "coordinate_conversions.h"
 #include "creature.h"
+#include "creature_tracker.h"
+#include "cuboid_rectangle.h"
 #include "cursesdef.h"
 #include "damage.h"
 #include "debug.h"
@@ -67,10 +72,12 @@
 #include "monster.h"
 #include "morale_types.h"
 #include "mtype.h"
+#include "npc.h"
 #include "optional.h"
 #include "options.h"
 #include "output.h"
 #include "overmapbuffer.h"
+#include "parallel.h"
 #include "pathfinding.h"
 #include "player.h"
 #include "projectile.h"
@@ -85,6 +92,7 @@
 #include "timed_event.h"
 #include "translations.h"
 #include "trap.h"
+#include "turn_profiler.h"
 #include "ui_manager.h"
 #include "value_ptr.h"
 #include "veh_type.h"
@@ -236,6 +244,7 @@ void map::add_vehicle_to_cache( vehicle *veh )
         debugmsg( "Tried to add null vehicle to cache" );
         return;
     }
+    veh->invalidate_power_grid( true );
 
     // Get parts
     for( const vpart_reference &vpr : veh->get_all_parts() ) {
@@ -273,14 +282,13 @@ void map::clear_vehicle_point_from_cache( vehicle *veh, const tripoint &pt )
 void map::clear_vehicle_cache( const int zlev )
 {
     level_cache &ch = get_cache( zlev );
-    while( !ch.veh_cached_parts.empty() ) {
-        const auto part = ch.veh_cached_parts.begin();
-        const auto &p = part->first;
+    for( const auto &part : ch.veh_cached_parts ) {
+        const tripoint &p = part.first;
         if( inbounds( p ) ) {
             ch.veh_exists_at[p.x][p.y] = false;
         }
-        ch.veh_cached_parts.erase( part );
     }
+    ch.veh_cached_parts.clear();
     ch.veh_in_active_range = false;
 }
 
@@ -309,6 +317,7 @@ std::unique_ptr<vehicle> map::detach_vehicle( vehicle *veh )
         debugmsg( "map::detach_vehicle was passed nullptr" );
         return std::unique_ptr<vehicle>();
     }
+    veh->invalidate_power_grid( false );
 
     int z = veh->sm_pos.z;
     if( z < -OVERMAP_DEPTH || z > OVERMAP_HEIGHT ) {
@@ -362,6 +371,7 @@ void map::on_vehicle_moved( const int smz )
 
 void map::vehmove()
 {
+    TURN_PROFILER_ZONE( "map::vehmove" );
     // give vehicles movement points
     VehicleList vehicle_list;
     int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
@@ -1058,6 +1068,8 @@ void map::unboard_vehicle( const tripoint &p, bool dead_passenger )
 bool map::displace_vehicle( vehicle &veh, const tripoint &dp, const bool adjust_pos,
                             const std::set<int> &parts_to_move )
 {
+    // Cables leading to this vehicle won't find it at its old position.
+    veh.invalidate_power_grid( true );
     const tripoint src = veh.global_pos3();
     // handle vehicle ramps
     int ramp_offset = 0;
@@ -4535,6 +4547,7 @@ std::vector<tripoint> map::check_submap_active_item_consistency()
 
 void map::process_items()
 {
+    TURN_PROFILER_ZONE( "map::process_items" );
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
     for( int gz = minz; gz <= maxz; ++gz ) {
@@ -6023,6 +6036,14 @@ void map::draw_from_above( const catacurses::window &w, const player &u, const t
     }
 }
 
+// Guards the line of sight memo of every map while its skew_vision_cache_threaded is set.
+static std::mutex skew_vision_cache_mutex;
+
+void map::allow_sees_from_threads( const bool allowed )
+{
+    skew_vision_cache_threaded = allowed;
+}
+
 bool map::sees( const tripoint &F, const tripoint &T, const int range ) const
 {
     int dummy = 0;
@@ -6040,18 +6061,43 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         bresenham_slope = 0;
         return false; // Out of range!
     }
+    std::unique_lock<std::mutex> memo_lock( skew_vision_cache_mutex, std::defer_lock );
+    if( skew_vision_cache_threaded ) {
+        memo_lock.lock();
+    }
+    if( skew_vision_cache_dirty || skew_vision_cache_turn != calendar::turn ) {
+        if( skew_vision_cache_dirty ) {
+            ++skew_vision_cache_stats.invalidations;
+        }
+        skew_vision_cache.clear();
+        skew_vision_cache_dirty = false;
+        skew_vision_cache_turn = calendar::turn;
+    }
     // Cannonicalize the order of the tripoints so the cache is reflexive.
+    // The range is not part of the key, it was checked above and doesn't change the line.
     const tripoint &min = F < T ? F : T;
     const tripoint &max = !( F < T ) ? F : T;
-    // A little gross, just pack the values into a point.
-    const point key(
-        min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
-        max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH )
-    );
-    char cached = skew_vision_cache.get( key, -1 );
-    if( cached >= 0 ) {
-        return cached > 0;
-    }
+    const auto pack = []( const tripoint & p ) {
+        return static_cast<uint64_t>( static_cast<uint32_t>( p.x << 16 | p.y << 8 |
+                                      ( p.z + OVERMAP_DEPTH ) ) );
+    };
+    const uint64_t key = pack( min ) << 32 | pack( max );
+    const auto cached = skew_vision_cache.find( key );
+    if( cached != skew_vision_cache.end() ) {
+        ++skew_vision_cache_stats.hits;
+        return cached->second;
+    }
+    ++skew_vision_cache_stats.misses;
+    if( memo_lock.owns_lock() ) {
+        // Other threads can look up lines while this one is traced.
+        memo_lock.unlock();
+    }
+    const auto remember = [&]( const bool visible ) {
+        if( skew_vision_cache_threaded ) {
+            memo_lock.lock();
+        }
+        skew_vision_cache.emplace( key, visible );
+    };
     bool visible = true;
 
     // Ugly `if` for now
@@ -6068,7 +6114,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
             }
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        remember( visible );
         return visible;
     }
 
@@ -6101,7 +6147,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    remember( visible );
     return visible;
 }
 
@@ -6689,6 +6735,28 @@ static void generate_uniform( const tripoint &p, const ter_id &terrain_type )
     }
 }
 
+void map::prefetch_submaps( const point &dir, const int distance )
+{
+    const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
+    const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+    const half_open_rectangle<point> loaded( point_zero, point( my_MAPSIZE, my_MAPSIZE ) );
+    std::vector<tripoint> ahead;
+    for( int gridx = 0; gridx < my_MAPSIZE; gridx++ ) {
+        for( int gridy = 0; gridy < my_MAPSIZE; gridy++ ) {
+            for( int i = 1; i <= distance; i++ ) {
+                const point shifted = point( gridx, gridy ) + dir * i;
+                if( loaded.contains( shifted ) ) {
+                    continue;
+                }
+                for( int z = minz; z <= maxz; z++ ) {
+                    ahead.emplace_back( abs_sub.xy() + shifted, z );
+                }
+            }
+        }
+    }
+    MAPBUFFER.prefetch( ahead );
+}
+
 void map::loadn( const tripoint &grid, const bool update_vehicles )
 {
     // Cache empty overmap types
@@ -7603,6 +7671,7 @@ void map::build_outside_cache( const int zlev )
     if( zlev < 0 ) {
         std::uninitialized_fill_n(
             &outside_cache[0][0], ( MAPSIZE_X ) * ( MAPSIZE_Y ), false );
+        ch.outside_cache_dirty = false;
         return;
     }
 
@@ -7795,21 +7864,48 @@ void map::do_vehicle_caching( int z )
     }
 }
 
+bool map::build_level_caches( const int minz, const int maxz )
+{
+    std::vector<int> dirty_levels;
+    for( int z = minz; z <= maxz; z++ ) {
+        const level_cache &ch = get_cache( z );
+        if( ch.outside_cache_dirty || ch.transparency_cache_dirty || ch.floor_cache_dirty ) {
+            dirty_levels.push_back( z );
+        }
+    }
+    // Each level only reads its own submaps and writes its own caches, so levels can be built
+    // independently. The transparency cache depends on the outside cache of the same level.
+    // The weather is looked up here, resolving its id isn't safe on the worker threads.
+    const float sight_penalty = get_weather().weather_id->sight_penalty;
+    // Not std::vector<bool>, its elements can't be written from different threads
+    std::vector<char> level_seen_cache_dirty( dirty_levels.size(), 0 );
+    parallel_for( dirty_levels.size(), [&]( const size_t i ) {
+        const int z = dirty_levels[i];
+        build_outside_cache( z );
+        bool dirty = build_transparency_cache( z, sight_penalty );
+        dirty |= build_floor_cache( z );
+        level_seen_cache_dirty[i] = dirty;
+    } );
+    return std::any_of( level_seen_cache_dirty.begin(), level_seen_cache_dirty.end(),
+    []( const char dirty ) {
+        return dirty != 0;
+    } );
+}
+
 void map::build_map_cache( const int zlev, bool skip_lightmap )
 {
+    TURN_PROFILER_ZONE( "map::build_map_cache" );
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
-    bool seen_cache_dirty = false;
+    bool seen_cache_dirty = build_level_caches( minz, maxz );
+    // Vehicles write into the caches built above, so this has to wait until all levels are done
     for( int z = minz; z <= maxz; z++ ) {
-        build_outside_cache( z );
-        seen_cache_dirty |= build_transparency_cache( z );
-        seen_cache_dirty |= build_floor_cache( z );
         do_vehicle_caching( z );
     }
     seen_cache_dirty |= build_vision_transparency_cache( zlev );
 
     if( seen_cache_dirty ) {
-        skew_vision_cache.clear();
+        skew_vision_cache_dirty = true;
     }
     // Initial value is illegal player position.
     const tripoint &p = get_player_character().pos();
@@ -8134,27 +8230,42 @@ void map::scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &bl
                           std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &reduces_scent,
                           const point &min, const point &max )
 {
-    auto reduce = TFLAG_REDUCE_SCENT;
-    auto block = TFLAG_NO_SCENT;
-    auto fill_values = [&]( const tripoint & gp, const submap * sm, const point & lp ) {
-        // We need to generate the x/y coordinates, because we can't get them "for free"
-        const point p = lp + sm_to_ms_copy( gp.xy() );
-        if( sm->get_ter( lp ).obj().has_flag( block ) ) {
-            blocks_scent[p.x][p.y] = true;
-            reduces_scent[p.x][p.y] = false;
-        } else if( sm->get_ter( lp ).obj().has_flag( reduce ) ||
-                   sm->get_furn( lp ).obj().has_flag( reduce ) ) {
-            blocks_scent[p.x][p.y] = false;
-            reduces_scent[p.x][p.y] = true;
-        } else {
-            blocks_scent[p.x][p.y] = false;
-            reduces_scent[p.x][p.y] = false;
-        }
+    if( !scent_blockers_cache ) {
+        scent_blockers_cache = std::make_unique<scent_blocker_cache>();
+    }
+    scent_blocker_cache &cache = *scent_blockers_cache;
+    if( !cache.valid || cache.zlev != abs_sub.z ) {
+        auto reduce = TFLAG_REDUCE_SCENT;
+        auto block = TFLAG_NO_SCENT;
+        auto fill_values = [&]( const tripoint & gp, const submap * sm, const point & lp ) {
+            // We need to generate the x/y coordinates, because we can't get them "for free"
+            const point p = lp + sm_to_ms_copy( gp.xy() );
+            if( sm->get_ter( lp ).obj().has_flag( block ) ) {
+                cache.blocks[p.x][p.y] = true;
+                cache.reduces[p.x][p.y] = false;
+            } else if( sm->get_ter( lp ).obj().has_flag( reduce ) ||
+                       sm->get_furn( lp ).obj().has_flag( reduce ) ) {
+                cache.blocks[p.x][p.y] = false;
+                cache.reduces[p.x][p.y] = true;
+            } else {
+                cache.blocks[p.x][p.y] = false;
+                cache.reduces[p.x][p.y] = false;
+            }
 
-        return ITER_CONTINUE;
-    };
+            return ITER_CONTINUE;
+        };
 
-    function_over( tripoint( min, abs_sub.z ), tripoint( max, abs_sub.z ), fill_values );
+        function_over( tripoint( 0, 0, abs_sub.z ),
+                       tripoint( SEEX * my_MAPSIZE - 1, SEEY * my_MAPSIZE - 1, abs_sub.z ), fill_values );
+        cache.zlev = abs_sub.z;
+        cache.valid = true;
+    }
+    for( int x = min.x; x <= max.x; ++x ) {
+        std::copy( cache.blocks[x].begin() + min.y, cache.blocks[x].begin() + max.y + 1,
+                   blocks_scent[x].begin() + min.y );
+        std::copy( cache.reduces[x].begin() + min.y, cache.reduces[x].begin() + max.y + 1,
+                   reduces_scent[x].begin() + min.y );
+    }
 
     const inclusive_rectangle<point> local_bounds( min, max );
 
@@ -8283,13 +8394,49 @@ std::list<tripoint> map::find_furnitures_with_flag_in_radius( const tripoint &ce
 std::list<Creature *> map::get_creatures_in_radius( const tripoint &center, size_t radius,
         size_t radiusz )
 {
-    std::list<Creature *> creatures;
-    for( const auto &loc : points_in_radius( center, radius, radiusz ) ) {
-        Creature *tmp_critter = g->critter_at( loc );
-        if( tmp_critter != nullptr ) {
-            creatures.push_back( tmp_critter );
+    const tripoint offset( radius, radius, radiusz );
+    const tripoint min = center - offset;
+    const tripoint max = center + offset;
+    const auto in_box = [&]( const tripoint & p ) {
+        return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y &&
+               p.z >= min.z && p.z <= max.z;
+    };
+    // Same creatures as calling critter_at for each point: a monster hides everyone else
+    // on its square (and a hallucination hides everyone, itself included), then the avatar
+    // comes before the NPCs.
+    std::vector<std::pair<tripoint, Creature *>> found;
+    const Creature_tracker &tracker = *g->critter_tracker;
+    for( monster *mon : tracker.find_in_rectangle( min, max ) ) {
+        if( !mon->is_hallucination() ) {
+            found.emplace_back( mon->pos(), mon );
+        }
+    }
+    const size_t monster_count = found.size();
+    const auto add_character = [&]( Character & who ) {
+        const tripoint &p = who.pos();
+        if( !in_box( p ) || tracker.find( p ) ) {
+            return;
         }
-
+        for( size_t i = monster_count; i < found.size(); ++i ) {
+            if( found[i].first == p ) {
+                return;
+            }
+        }
+        found.emplace_back( p, &who );
+    };
+    add_character( get_avatar() );
+    for( npc &guy : g->all_npcs() ) {
+        add_character( guy );
+    }
+    // Monsters come sorted already, merge the characters in the way the points would be visited.
+    std::stable_sort( found.begin(), found.end(), []( const std::pair<tripoint, Creature *> &lhs,
+    const std::pair<tripoint, Creature *> &rhs ) {
+        return std::tie( lhs.first.z, lhs.first.y, lhs.first.x ) <
+               std::tie( rhs.first.z, rhs.first.y, rhs.first.x );
+    } );
+    std::list<Creature *> creatures;
+    for( const std::pair<tripoint, Creature *> &e : found ) {
+        creatures.push_back( e.second );
     }
     return creatures;
 }
@@ -8352,6 +8499,10 @@ void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
         get_pathfinding_cache( zlev ).dirty = true;
+        flow_fields.clear();
+        if( scent_blockers_cache && scent_blockers_cache->zlev == zlev ) {
+            scent_blockers_cache->valid = false;
+        }
     }
 }
 
@@ -8446,6 +8597,7 @@ void map::update_pathfinding_cache( int zlev ) const
     }
 
     cache.dirty = false;
+    cache.cluster_graph.dirty = true;
 }
 
 void map::clip_to_bounds( tripoint &p ) const
@@ -14,6 +14,7 @@
 #include <set>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -92,6 +93,7 @@ class map;
 
 enum ter_bitflags : int;
 struct pathfinding_cache;
+struct pathfinding_flow_field;
 struct pathfinding_settings;
 template<typename T>
 struct weighted_int_list;
@@ -182,13 +184,58 @@ struct level_cache {
 
     bool veh_in_active_range;
     bool veh_exists_at[MAPSIZE_X][MAPSIZE_Y];
-    std::map< tripoint, std::pair<vehicle *, int> > veh_cached_parts;
+    // Looked up by map::veh_at_internal, which is called a lot, so hashed
+    std::unordered_map< tripoint, std::pair<vehicle *, int> > veh_cached_parts;
     std::set<vehicle *> vehicle_list;
     std::set<vehicle *> zone_vehicles;
 
     int max_populated_zlev;
 };
 
+/**
+ * The terrain and furniture part of map::scent_blockers for one z-level. Only changes with terrain
+ * or furniture, so it is kept until the pathfinding cache goes dirty, which happens on every such
+ * change.
+ */
+struct scent_blocker_cache {
+    bool valid = false;
+    int zlev = 0;
+    std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> blocks;
+    std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> reduces;
+};
+
+/**
+ * Light cast by stationary sources during the last map::generate_lightmap: terrain, furniture,
+ * fields, items on the ground and natural light falling into buildings.
+ * The result only depends on the inputs stored here, so it is reused until one of them changes.
+ */
+struct stationary_lightmap {
+    struct light_arc {
+        tripoint p;
+        int angle;
+        float luminance;
+        int wideangle;
+
+        bool operator==( const light_arc &rhs ) const {
+            return p == rhs.p && angle == rhs.angle && luminance == rhs.luminance &&
+                   wideangle == rhs.wideangle;
+        }
+    };
+
+    bool valid = false;
+    // Inputs
+    int zlev = 0;
+    float natural_light = 0.0f;
+    bool trigdist = false;
+    float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
+    float transparency_cache[MAPSIZE_X][MAPSIZE_Y];
+    bool outside_cache[MAPSIZE_X][MAPSIZE_Y];
+    std::vector<light_arc> arcs;
+    // Results
+    four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+    float sm[MAPSIZE_X][MAPSIZE_Y];
+};
+
 /**
  * Manage and cache data about a part of the map.
  *
@@ -234,6 +281,7 @@ class map
         void set_transparency_cache_dirty( const int zlev ) {
             if( inbounds_z( zlev ) ) {
                 get_cache( zlev ).transparency_cache_dirty = true;
+                skew_vision_cache_dirty = true;
             }
         }
 
@@ -246,6 +294,7 @@ class map
         void set_floor_cache_dirty( const int zlev ) {
             if( inbounds_z( zlev ) ) {
                 get_cache( zlev ).floor_cache_dirty = true;
+                skew_vision_cache_dirty = true;
             }
         }
 
@@ -268,6 +317,11 @@ class map
             }
         }
 
+        // Drops the light of stationary sources kept between lightmaps, so the next one casts it again
+        void invalidate_stationary_light() {
+            stationary_light.reset();
+        }
+
         bool check_seen_cache( const tripoint &p ) const {
             std::bitset<MAPSIZE_X *MAPSIZE_Y> &memory_seen_cache =
                 get_cache( p.z ).map_memory_seen_cache;
@@ -371,6 +425,11 @@ class map
          * Note: the map must have been loaded before this can be called.
          */
         void shift( const point &s );
+        /**
+         * Start reading the submaps that a @ref shift in direction dir would load from disk,
+         * up to distance submaps beyond the edge of the map, see @ref mapbuffer::prefetch.
+         */
+        void prefetch_submaps( const point &dir, int distance );
         /**
          * Moves the map vertically to (not by!) newz.
          * Does not actually shift anything, only forces cache updates.
@@ -466,6 +525,21 @@ class map
         * Returns whether `F` sees `T` with a view range of `range`.
         */
         bool sees( const tripoint &F, const tripoint &T, int range ) const;
+        /** Counts of lookups in the memo of line of sight results used by @ref sees. */
+        struct sight_memo_stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            /** How often the memo was emptied early because transparency or floors changed. */
+            uint64_t invalidations = 0;
+        };
+        const sight_memo_stats &get_sight_memo_stats() const {
+            return skew_vision_cache_stats;
+        }
+        /**
+         * While allowed, @ref sees may be called from several threads at once and guards its
+         * memo with a lock. Only change this while no other thread is using the map.
+         */
+        void allow_sees_from_threads( bool allowed );
     private:
         /**
          * Don't expose the slope adjust outside map functions.
@@ -544,6 +618,37 @@ class map
         std::vector<tripoint> route( const tripoint &f, const tripoint &t,
                                      const pathfinding_settings &settings,
         const std::set<tripoint> &pre_closed = {{ }} ) const;
+        /**
+         * Plan a route over the cluster graph of the pathfinding cache (one cluster per submap)
+         * and refine each leg of it with a local search.
+         * Faster than a full search over long distances, but the route may be slightly longer.
+         * Returns an empty route if the start and destination share a cluster or if no route
+         * could be found this way, which doesn't mean there is none.
+         * Parameters are the same as for @ref route.
+         */
+        std::vector<tripoint> route_hierarchical( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings,
+                const std::set<tripoint> &pre_closed = {{ }} ) const;
+        /**
+         * Same as @ref route without pre-closed squares, but reads the route from a flow field
+         * shared by every caller with the same destination and settings during this turn.
+         * Cheap for many creatures chasing the same target, like a horde chasing the player.
+         */
+        std::vector<tripoint> route_flow_field( const tripoint &f, const tripoint &t,
+                                                const pathfinding_settings &settings ) const;
+        /**
+         * Flow field towards t on its z-level, computed on first use and kept until the end
+         * of the turn or until the pathfinding cache is dirtied.
+         */
+        const pathfinding_flow_field &get_flow_field( const tripoint &t,
+                const pathfinding_settings &settings ) const;
+        /**
+         * Full A* search between f and t, without the straight line, distance and
+         * cluster graph shortcuts of @ref route.
+         */
+        std::vector<tripoint> route_astar( const tripoint &f, const tripoint &t,
+                                           const pathfinding_settings &settings,
+                                           const std::set<tripoint> &pre_closed = {{ }} ) const;
 
         // Vehicles: Common to 2D and 3D
         VehicleList get_vehicles();
@@ -1293,6 +1398,8 @@ class map
         /**
          * Build the map of scent-resistant tiles.
          * Should be way faster than if done in `game.cpp` using public map functions.
+         * Terrain and furniture are looked up once and remembered until they change,
+         * vehicles are checked on every call.
          */
         void scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &blocks_scent,
                              std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &reduces_scent,
@@ -1575,9 +1682,14 @@ class map
 
         // Builds a transparency cache and returns true if the cache was invalidated.
         // Used to determine if seen cache should be rebuilt.
-        bool build_transparency_cache( int zlev );
+        // sight_penalty is the penalty of the current weather to sight outdoors
+        bool build_transparency_cache( int zlev, float sight_penalty );
         bool build_vision_transparency_cache( int zlev );
         void build_sunlight_cache( int zlev );
+        // Builds the outside, transparency and floor caches of all dirty levels from minz to maxz,
+        // spread over worker threads with parallel_for.
+        // Returns true if any of them invalidated the seen cache.
+        bool build_level_caches( int minz, int maxz );
     public:
         void build_outside_cache( int zlev );
         // Builds a floor cache and returns true if the cache was invalidated.
@@ -1669,6 +1781,11 @@ class map
         int bash_rating_internal( int str, const furn_t &furniture,
                                   const ter_t &terrain, bool allow_floor,
                                   const vehicle *veh, int part ) const;
+        /**
+         * Cost of walking onto p as estimated by route_astar, for the flow fields.
+         * -1 if the square can't be entered.
+         */
+        int flow_field_enter_cost( const tripoint &p, const pathfinding_settings &settings ) const;
 
         /**
          * Internal version of the drawsq. Keeps a cached maptile for less re-getting.
@@ -1767,17 +1884,35 @@ class map
          * Holds caches for visibility, light, transparency and vehicles
          */
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
+        /**
+         * Stationary light of the last lightmap, see @ref generate_lightmap.
+         */
+        std::unique_ptr<stationary_lightmap> stationary_light;
+        /** See @ref scent_blockers. */
+        std::unique_ptr<scent_blocker_cache> scent_blockers_cache;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        /**
+         * Flow fields requested during the turn flow_fields_turn, see @ref get_flow_field.
+         */
+        mutable std::vector<std::unique_ptr<pathfinding_flow_field>> flow_fields;
+        mutable time_point flow_fields_turn = calendar::before_time_starts;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
         std::set<tripoint> submaps_with_active_items;
 
         /**
-         * Cache of coordinate pairs recently checked for visibility.
+         * Results of the line of sight checks in @ref sees during the turn skew_vision_cache_turn,
+         * by pair of end points. Emptied early when skew_vision_cache_dirty is set.
          */
-        mutable lru_cache<point, char> skew_vision_cache;
+        mutable std::unordered_map<uint64_t, bool> skew_vision_cache;
+        mutable time_point skew_vision_cache_turn = calendar::before_time_starts;
+        /** Set when transparency or floors change, which can change any line of sight. */
+        mutable bool skew_vision_cache_dirty = false;
+        mutable sight_memo_stats skew_vision_cache_stats;
+        /** Whether the members above are guarded by a lock, see @ref allow_sees_from_threads. */
+        bool skew_vision_cache_threaded = false;
 
         // Note: no bounds check
         level_cache &get_cache( int zlev ) const {
@@ -1796,6 +1931,8 @@ class map
         const pathfinding_cache &get_pathfinding_cache_ref( int zlev ) const;
 
         void update_pathfinding_cache( int zlev ) const;
+        /** Rebuilds the clusters of the pathfinding cluster graph that went stale. */
+        void update_pathfinding_cluster_graph( int zlev ) const;
 
         void update_visibility_cache( int zlev );
         const visibility_variables &get_visibility_variables_cache() const;
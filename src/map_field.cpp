@@ -54,6 +54,7 @@
 #include "submap.h"
 #include "teleport.h"
 #include "translations.h"
+#include "turn_profiler.h"
 #include "type_id.h"
 #include "units.h"
 #include "vehicle.h"
@@ -139,6 +140,7 @@ int map::burn_body_part( player &u, field_entry &cur, body_part bp, const int sc
 
 bool map::process_fields()
 {
+    TURN_PROFILER_ZONE( "map::process_fields" );
     bool dirty_transparency_cache = false;
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
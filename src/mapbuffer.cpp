@@ -1,10 +1,15 @@
 #include "mapbuffer.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <exception>
+#include <fstream>
 #include <functional>
+#include <mutex>
 #include <set>
 #include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -16,14 +21,20 @@
 #include "game_constants.h"
 #include "json.h"
 #include "map.h"
+#include "options.h"
 #include "output.h"
 #include "path_info.h"
 #include "popup.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "submap_quad.h"
 #include "translations.h"
 #include "ui_manager.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
 #define dbg(x) DebugLog((x),D_MAP) << __FILE__ << ":" << __LINE__ << ": "
 
 static std::string find_quad_path( const std::string &dirname, const tripoint &om_addr )
@@ -40,7 +51,177 @@ static std::string find_dirname( const tripoint &om_addr )
 
 mapbuffer MAPBUFFER;
 
-mapbuffer::mapbuffer() = default;
+/**
+ * Reads the savefiles requested by @ref mapbuffer::prefetch on a background thread, which is
+ * started on first use and kept until the mapbuffer is destroyed.
+ * Everything but the file reading itself happens under @ref mutex.
+ */
+class mapbuffer::prefetcher
+{
+    public:
+        ~prefetcher() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                stopping = true;
+            }
+            file_queued.notify_all();
+            if( reader.joinable() ) {
+                reader.join();
+            }
+        }
+
+        // Queues the files that aren't known yet and drops the ones not in quad_paths.
+        // Never waits for the reader, a file it is reading when dropped is thrown away after.
+        void request( const std::set<std::string> &quad_paths ) {
+            std::lock_guard<std::mutex> lock( mutex );
+            for( auto it = quads.begin(); it != quads.end(); ) {
+                if( quad_paths.count( it->first ) == 0 ) {
+                    if( it->second.state == quad_state::queued ) {
+                        queue.erase( std::find( queue.begin(), queue.end(), it->first ) );
+                    }
+                    it = quads.erase( it );
+                } else {
+                    ++it;
+                }
+            }
+            if( !start_reader() ) {
+                return;
+            }
+            for( const std::string &quad_path : quad_paths ) {
+                if( quads.emplace( quad_path, quad() ).second ) {
+                    queue.push_back( quad_path );
+                }
+            }
+            file_queued.notify_one();
+        }
+
+        // Hands out the contents of a file that has been read. Waits if it is being read right
+        // now, returns false if it is only queued, it is then quicker to read it directly.
+        bool take( const std::string &quad_path, std::string &contents ) {
+            std::unique_lock<std::mutex> lock( mutex );
+            auto it = quads.find( quad_path );
+            if( it == quads.end() ) {
+                return false;
+            }
+            if( it->second.state == quad_state::queued ) {
+                queue.erase( std::find( queue.begin(), queue.end(), quad_path ) );
+                quads.erase( it );
+                return false;
+            }
+            file_read.wait( lock, [&]() {
+                it = quads.find( quad_path );
+                return it == quads.end() || it->second.state == quad_state::done;
+            } );
+            if( it == quads.end() || !it->second.found ) {
+                if( it != quads.end() ) {
+                    quads.erase( it );
+                }
+                return false;
+            }
+            contents = std::move( it->second.contents );
+            quads.erase( it );
+            return true;
+        }
+
+        // Waits until all queued files have been read
+        void finish() {
+            std::unique_lock<std::mutex> lock( mutex );
+            file_read.wait( lock, [this]() {
+                return queue.empty() && !reading;
+            } );
+        }
+
+        // Drops all files and waits until the one being read, if any, is closed again
+        void clear() {
+            std::unique_lock<std::mutex> lock( mutex );
+            queue.clear();
+            quads.clear();
+            file_read.wait( lock, [this]() {
+                return !reading;
+            } );
+        }
+
+    private:
+        enum class quad_state : int {
+            queued,
+            reading,
+            done
+        };
+        struct quad {
+            quad_state state = quad_state::queued;
+            bool found = false;
+            std::string contents;
+        };
+
+        bool start_reader() {
+            if( !reader.joinable() && !start_failed ) {
+                try {
+                    reader = std::thread( &prefetcher::read_queued, this );
+                } catch( const std::system_error &err ) {
+                    // Not a problem, the files will be read when they are needed
+                    dbg( D_WARNING ) << "Failed to start submap prefetch thread: " << err.what();
+                    start_failed = true;
+                }
+            }
+            return !start_failed;
+        }
+
+        void read_queued() {
+            std::unique_lock<std::mutex> lock( mutex );
+            while( true ) {
+                file_queued.wait( lock, [this]() {
+                    return stopping || !queue.empty();
+                } );
+                if( stopping ) {
+                    return;
+                }
+                const std::string quad_path = queue.front();
+                queue.pop_front();
+                quads[quad_path].state = quad_state::reading;
+                reading = true;
+                lock.unlock();
+
+                bool found = false;
+                std::string contents;
+                std::ifstream fin( quad_path, std::ios::binary );
+                if( fin ) {
+                    std::ostringstream buffer;
+                    buffer << fin.rdbuf();
+                    if( !fin.bad() ) {
+                        contents = buffer.str();
+                        found = true;
+                    }
+                }
+                fin.close();
+
+                lock.lock();
+                reading = false;
+                // Dropped while it was being read, or dropped and queued again
+                const auto it = quads.find( quad_path );
+                if( it != quads.end() && it->second.state == quad_state::reading ) {
+                    it->second.state = quad_state::done;
+                    it->second.found = found;
+                    it->second.contents = std::move( contents );
+                }
+                file_read.notify_all();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable file_queued;
+        std::condition_variable file_read;
+        std::thread reader;
+        bool start_failed = false;
+        bool stopping = false;
+        // Whether the reader has a file open
+        bool reading = false;
+        std::deque<std::string> queue;
+        std::map<std::string, quad> quads;
+};
+
+mapbuffer::mapbuffer() : prefetched_quads( std::make_unique<prefetcher>() )
+{
+}
 
 mapbuffer::~mapbuffer()
 {
@@ -49,12 +230,40 @@ mapbuffer::~mapbuffer()
 
 void mapbuffer::reset()
 {
+    discard_prefetched_quads();
     for( auto &elem : submaps ) {
         delete elem.second;
     }
     submaps.clear();
 }
 
+void mapbuffer::prefetch( const std::vector<tripoint> &submap_addrs )
+{
+    std::set<std::string> wanted;
+    for( const tripoint &p : submap_addrs ) {
+        if( submaps.count( p ) == 0 ) {
+            const tripoint om_addr = sm_to_omt_copy( p );
+            wanted.insert( find_quad_path( find_dirname( om_addr ), om_addr ) );
+        }
+    }
+    prefetched_quads->request( wanted );
+}
+
+void mapbuffer::finish_prefetch()
+{
+    prefetched_quads->finish();
+}
+
+bool mapbuffer::take_prefetched_quad( const std::string &quad_path, std::string &contents )
+{
+    return prefetched_quads->take( quad_path, contents );
+}
+
+void mapbuffer::discard_prefetched_quads()
+{
+    prefetched_quads->clear();
+}
+
 bool mapbuffer::add_submap( const tripoint &p, submap *sm )
 {
     if( submaps.count( p ) != 0 ) {
@@ -105,6 +314,8 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
 
 void mapbuffer::save( bool delete_after_save )
 {
+    // Files read ahead of time may be overwritten below
+    discard_prefetched_quads();
     assure_dir_exist( PATH_INFO::world_base_save_path() + "/maps" );
 
     int num_saved_submaps = 0;
@@ -113,6 +324,7 @@ void mapbuffer::save( bool delete_after_save )
     map &here = get_map();
     const tripoint map_origin = sm_to_omt_copy( here.get_abs_sub() );
     const bool map_has_zlevels = g != nullptr && here.has_zlevels();
+    const bool compact = get_option<std::string>( "MAP_SAVE_FORMAT" ) != "json";
 
     static_popup popup;
 
@@ -149,7 +361,7 @@ void mapbuffer::save( bool delete_after_save )
         // delete_on_save deletes everything, otherwise delete submaps
         // outside the current map.
         const bool zlev_del = !map_has_zlevels && om_addr.z != get_map().get_abs_sub().z;
-        save_quad( dirname, quad_path, om_addr, submaps_to_delete,
+        save_quad( dirname, quad_path, om_addr, submaps_to_delete, compact,
                    delete_after_save || zlev_del ||
                    om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
                    om_addr.x > map_origin.x + HALF_MAPSIZE ||
@@ -163,7 +375,7 @@ void mapbuffer::save( bool delete_after_save )
 
 void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
                            const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                           bool delete_after_save )
+                           bool compact, bool delete_after_save )
 {
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
@@ -197,43 +409,29 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         return;
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
-        for( auto &submap_addr : submap_addrs ) {
-            if( submaps.count( submap_addr ) == 0 ) {
-                continue;
-            }
-
-            submap *sm = submaps[submap_addr];
-
-            if( sm == nullptr ) {
-                continue;
-            }
-
-            jsout.start_object();
-
-            jsout.member( "version", savegame_version );
-            jsout.member( "coordinates" );
+    std::vector<submap_record> records;
+    for( auto &submap_addr : submap_addrs ) {
+        if( submaps.count( submap_addr ) == 0 ) {
+            continue;
+        }
 
-            jsout.start_array();
-            jsout.write( submap_addr.x );
-            jsout.write( submap_addr.y );
-            jsout.write( submap_addr.z );
-            jsout.end_array();
+        submap *sm = submaps[submap_addr];
 
-            sm->store( jsout );
+        if( sm == nullptr ) {
+            continue;
+        }
 
-            jsout.end_object();
+        records.emplace_back( *sm, submap_addr, savegame_version );
 
-            if( delete_after_save ) {
-                submaps_to_delete.push_back( submap_addr );
-            }
+        if( delete_after_save ) {
+            submaps_to_delete.push_back( submap_addr );
         }
+    }
 
-        jsout.end_array();
+    // Don't create the directory if it would be empty
+    assure_dir_exist( dirname );
+    write_to_file( filename, [&]( std::ostream & fout ) {
+        fout << ( compact ? quad_file::write_binary( records ) : quad_file::write_json( records ) );
     } );
 }
 
@@ -246,21 +444,34 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     const std::string dirname = find_dirname( om_addr );
     std::string quad_path = find_quad_path( dirname, om_addr );
 
-    if( !file_exist( quad_path ) ) {
-        // Fix for old saves where the path was generated using std::stringstream, which
-        // did format the number using the current locale. That formatting may insert
-        // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
-        // of "map/1234.7.8.map".
-        std::ostringstream buffer;
-        buffer << dirname << "/" << om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
-        if( file_exist( buffer.str() ) ) {
-            quad_path = buffer.str();
+    std::string data;
+    if( !take_prefetched_quad( quad_path, data ) ) {
+        if( !file_exist( quad_path ) ) {
+            // Fix for old saves where the path was generated using std::stringstream, which
+            // did format the number using the current locale. That formatting may insert
+            // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
+            // of "map/1234.7.8.map".
+            std::ostringstream buffer;
+            buffer << dirname << "/" << om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
+            if( file_exist( buffer.str() ) ) {
+                quad_path = buffer.str();
+            }
         }
-    }
 
-    using namespace std::placeholders;
-    if( !read_from_file_optional_json( quad_path, std::bind( &mapbuffer::deserialize, this, _1 ) ) ) {
-        // If it doesn't exist, trigger generating it.
+        const auto read_quad = [&data]( std::istream & fin ) {
+            std::ostringstream buffer;
+            buffer << fin.rdbuf();
+            data = buffer.str();
+        };
+        if( !read_from_file_optional( quad_path, read_quad ) ) {
+            // If it doesn't exist, trigger generating it.
+            return nullptr;
+        }
+    }
+    try {
+        deserialize( data );
+    } catch( const std::exception &err ) {
+        debugmsg( "failed to read submaps from \"%s\": %s", quad_path, err.what() );
         return nullptr;
     }
     if( submaps.count( p ) == 0 ) {
@@ -299,3 +510,22 @@ void mapbuffer::deserialize( JsonIn &jsin )
         }
     }
 }
+
+void mapbuffer::deserialize( const std::string &data )
+{
+    if( !quad_file::is_binary( data ) ) {
+        // Saved before the binary format, or converted back with --convert-maps
+        std::istringstream fin( data );
+        JsonIn jsin( fin );
+        deserialize( jsin );
+        return;
+    }
+    for( const submap_record &rec : quad_file::read_binary( data ) ) {
+        std::unique_ptr<submap> sm = std::make_unique<submap>();
+        rec.apply( *sm );
+        if( !add_submap( rec.coordinates, sm ) ) {
+            debugmsg( "submap %d,%d,%d was already loaded", rec.coordinates.x, rec.coordinates.y,
+                      rec.coordinates.z );
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "point.h"
 
@@ -54,7 +55,26 @@ class mapbuffer
          */
         submap *lookup_submap( const tripoint &p );
 
+        /** Start reading the savefiles of the given submaps on a background thread.
+         *
+         * A later @ref lookup_submap of one of them then only has to parse the file.
+         * Submaps that are already in the buffer are skipped, as are files still queued or
+         * read from an earlier call. Files of earlier calls that are not requested again are
+         * dropped without waiting for the reader.
+         *
+         * @param submap_addrs Absolute world positions in submap coordinates.
+         */
+        void prefetch( const std::vector<tripoint> &submap_addrs );
+        /** Waits until the files requested by @ref prefetch have been read. */
+        void finish_prefetch();
+
     private:
+        class prefetcher;
+        // Hands out the contents of a prefetched savefile, waiting if it is being read.
+        // Returns false if the file hasn't been read.
+        bool take_prefetched_quad( const std::string &quad_path, std::string &contents );
+        void discard_prefetched_quads();
+
         using submap_map_t = std::map<tripoint, submap *>;
 
     public:
@@ -71,10 +91,15 @@ class mapbuffer
         void remove_submap( tripoint addr );
         submap *unserialize_submaps( const tripoint &p );
         void deserialize( JsonIn &jsin );
+        // Loads a quad savefile in either format, see @ref quad_file
+        void deserialize( const std::string &data );
+        // Writes the quad in the binary format if compact is true, otherwise as JSON
         void save_quad( const std::string &dirname, const std::string &filename,
                         const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                        bool delete_after_save );
+                        bool compact, bool delete_after_save );
         submap_map_t submaps;
+        // Savefiles requested by @ref prefetch
+        std::unique_ptr<prefetcher> prefetched_quads;
 };
 
 extern mapbuffer MAPBUFFER;
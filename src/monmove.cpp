@@ -11,6 +11,8 @@
 #include <memory>
 #include <ostream>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "behavior.h"
 #include "bionics.h"
@@ -33,6 +35,7 @@
 #include "monster_oracle.h"
 #include "mtype.h"
 #include "npc.h"
+#include "parallel.h"
 #include "pathfinding.h"
 #include "pimpl.h"
 #include "rng.h"
@@ -365,7 +368,7 @@ void monster::plan()
             }
         }
     } else if( friendly != 0 && !docile ) {
-        for( monster &tmp : g->all_monsters() ) {
+        const auto rate_hostile = [&]( monster & tmp ) {
             if( tmp.friendly == 0 ) {
                 float rating = rate_target( tmp, dist, smart_planning );
                 if( rating < dist ) {
@@ -373,6 +376,17 @@ void monster::plan()
                     dist = rating;
                 }
             }
+        };
+        if( smart_planning ) {
+            for( monster &tmp : g->all_monsters() ) {
+                rate_hostile( tmp );
+            }
+        } else {
+            // Without smart planning, only monsters closer than dist can be rated.
+            const int range = static_cast<int>( std::ceil( dist ) );
+            for( monster *tmp : g->critter_tracker->find_in_radius( pos(), range, range ) ) {
+                rate_hostile( *tmp );
+            }
         }
     }
 
@@ -478,12 +492,7 @@ void monster::plan()
     }
     swarms = swarms && target == nullptr; // Only swarm if we have no target
     if( group_morale || swarms ) {
-        for( const weak_ptr_fast<monster> &weak : myfaction_iter->second ) {
-            const shared_ptr_fast<monster> shared = weak.lock();
-            if( !shared ) {
-                continue;
-            }
-            monster &mon = *shared;
+        const auto rate_ally = [&]( monster & mon ) {
             float rating = rate_target( mon, dist, smart_planning );
             if( group_morale && rating <= 10 ) {
                 morale += 10 - rating;
@@ -500,6 +509,23 @@ void monster::plan()
                     dist = rating;
                 }
             }
+        };
+        if( smart_planning ) {
+            for( const weak_ptr_fast<monster> &weak : myfaction_iter->second ) {
+                const shared_ptr_fast<monster> shared = weak.lock();
+                if( shared ) {
+                    rate_ally( *shared );
+                }
+            }
+        } else {
+            // Without smart planning a rating is the distance and only allies rated
+            // 10 or less change anything, so the faction members further away can be skipped.
+            static const mfaction_str_id playerfaction( "player" );
+            for( monster *mon : g->critter_tracker->find_in_radius( pos(), 10, 10 ) ) {
+                if( ( mon->friendly == 0 ? mon->faction : playerfaction ) == actual_faction ) {
+                    rate_ally( *mon );
+                }
+            }
         }
     }
 
@@ -572,6 +598,48 @@ void monster::plan()
     }
 }
 
+void monster::trace_plan_sight_lines( const std::vector<const monster *> &critters )
+{
+    // The end points are picked here, the threads only trace the lines between them.
+    std::vector<std::pair<tripoint, tripoint>> lines;
+    for( const monster *critter : critters ) {
+        const tripoint &from = critter->pos();
+        const int range = std::max( critter->type->vision_day, critter->type->vision_night );
+        const auto look_at = [&]( const Creature &other ) {
+            const int dist = rl_dist( from, other.pos() );
+            // Adjacent creatures and the avatar are seen without tracing a line.
+            if( dist > 1 && dist <= range && ( fov_3d || other.posz() == from.z ) &&
+                !other.is_avatar() ) {
+                lines.emplace_back( from, other.pos() );
+            }
+        };
+        // The same candidates plan() rates, minus the ones it can tell apart by distance alone.
+        for( const npc &who : g->all_npcs() ) {
+            look_at( who );
+        }
+        const int range_z = fov_3d ? fov_3d_z_range : 0;
+        for( const monster *other : g->critter_tracker->find_in_radius( from, range, range_z ) ) {
+            if( critter->friendly != 0 ) {
+                if( other->friendly == 0 ) {
+                    look_at( *other );
+                }
+            } else {
+                const mf_attitude att = critter->faction.obj().attitude( other->faction );
+                if( att != MFA_NEUTRAL && att != MFA_FRIENDLY ) {
+                    look_at( *other );
+                }
+            }
+        }
+    }
+
+    map &here = get_map();
+    here.allow_sees_from_threads( true );
+    parallel_for( lines.size(), [&]( const size_t i ) {
+        here.sees( lines[i].first, lines[i].second, -1 );
+    } );
+    here.allow_sees_from_threads( false );
+}
+
 /**
  * Method to make monster movement speed consistent in the face of staggering behavior and
  * differing distance metrics.
@@ -806,8 +874,9 @@ void monster::move()
         const auto &pf_settings = get_pathfinding_settings();
         if( pf_settings.max_dist >= rl_dist( pos(), goal ) &&
             ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != goal ) ) {
-            // We need a new path
-            path = here.route( pos(), goal, pf_settings, get_path_avoid() );
+            // We need a new path. Monsters don't avoid any squares, so they can share
+            // the flow field towards their goal with everything else chasing it.
+            path = here.route_flow_field( pos(), goal, pf_settings );
         }
 
         // Try to respect old paths, even if we can't pathfind at the moment
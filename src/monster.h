@@ -216,6 +216,12 @@ class monster : public Creature
         // How good of a target is given creature (checks for visibility)
         float rate_target( Creature &c, float best, bool smart = false ) const;
         void plan();
+        /**
+         * Traces the lines of sight that @ref plan of each of @p critters is going to check on
+         * worker threads, so the plans find them in the memo of map::sees when the monsters take
+         * their turns. Only fills that memo, the plans themselves don't change.
+         */
+        static void trace_plan_sight_lines( const std::vector<const monster *> &critters );
         void move(); // Actual movement
         void footsteps( const tripoint &p ); // noise made by movement
         void shove_vehicle( const tripoint &remote_destination,
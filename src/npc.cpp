@@ -682,10 +682,14 @@ void npc::set_known_to_u( bool known )
 void npc::setpos( const tripoint &pos )
 {
     position = pos;
+    const point old_submap_coords = submap_coords;
     const point_abs_om pos_om_old( sm_to_om_copy( submap_coords ) );
     submap_coords = get_map().get_abs_sub().xy() + point( pos.x / SEEX, pos.y / SEEY );
     // TODO: fix point types
     const point_abs_om pos_om_new( sm_to_om_copy( submap_coords ) );
+    if( submap_coords != old_submap_coords ) {
+        overmap_buffer.npc_moved( *this, point_abs_sm( old_submap_coords ) );
+    }
     if( !is_fake() && pos_om_old != pos_om_new ) {
         overmap &om_old = overmap_buffer.get( pos_om_old );
         overmap &om_new = overmap_buffer.get( pos_om_new );
@@ -728,12 +732,16 @@ void npc::spawn_at_sm( const tripoint &p )
 
 void npc::spawn_at_precise( const point &submap_offset, const tripoint &square )
 {
+    const point old_submap_coords = submap_coords;
     submap_coords = submap_offset;
     submap_coords.x += square.x / SEEX;
     submap_coords.y += square.y / SEEY;
     position.x = square.x % SEEX;
     position.y = square.y % SEEY;
     position.z = square.z;
+    if( submap_coords != old_submap_coords ) {
+        overmap_buffer.npc_moved( *this, point_abs_sm( old_submap_coords ) );
+    }
 }
 
 tripoint npc::global_square_location() const
@@ -58,6 +58,8 @@ bool tile_iso;
 std::map<std::string, std::string> TILESETS; // All found tilesets: <name, tileset_dir>
 std::map<std::string, std::string> SOUNDPACKS; // All found soundpacks: <name, soundpack_dir>
 
+int options_manager::values_generation_ = 0;
+
 options_manager &get_options()
 {
     static options_manager single_instance;
@@ -734,6 +736,7 @@ int options_manager::cOpt::getMaxLength() const
 //set to next item
 void options_manager::cOpt::setNext()
 {
+    values_changed();
     if( sType == "string_select" ) {
         int iNext = getItemPos( sSet ) + 1;
         if( iNext >= static_cast<int>( vItems.size() ) ) {
@@ -777,6 +780,7 @@ void options_manager::cOpt::setNext()
 //set to previous item
 void options_manager::cOpt::setPrev()
 {
+    values_changed();
     if( sType == "string_select" ) {
         int iPrev = static_cast<int>( getItemPos( sSet ) ) - 1;
         if( iPrev < 0 ) {
@@ -815,6 +819,7 @@ void options_manager::cOpt::setPrev()
 //set value
 void options_manager::cOpt::setValue( float fSetIn )
 {
+    values_changed();
     if( sType != "float" ) {
         debugmsg( "tried to set a float value to a %s option", sType );
         return;
@@ -828,6 +833,7 @@ void options_manager::cOpt::setValue( float fSetIn )
 //set value
 void options_manager::cOpt::setValue( int iSetIn )
 {
+    values_changed();
     if( sType != "int" ) {
         debugmsg( "tried to set an int value to a %s option", sType );
         return;
@@ -841,6 +847,7 @@ void options_manager::cOpt::setValue( int iSetIn )
 //set value
 void options_manager::cOpt::setValue( const std::string &sSetIn )
 {
+    values_changed();
     if( sType == "string_select" ) {
         if( getItemPos( sSetIn ) != -1 ) {
             sSet = sSetIn;
@@ -1277,6 +1284,12 @@ void options_manager::add_options_general()
 
     get_option( "AUTOSAVE_MINUTES" ).setPrerequisite( "AUTOSAVE" );
 
+    add( "MAP_SAVE_FORMAT", "general", translate_marker( "Map save format" ),
+         translate_marker( "Format the map is saved in.  Compact: binary and compressed, smaller and faster to load.  JSON: plain text that can be read and edited by hand.  Maps in either format are loaded regardless of this setting." ),
+    { { "compact", translate_marker( "Compact" ) }, { "json", translate_marker( "JSON" ) } },
+    "compact"
+       );
+
     add_empty_line();
 
     add( "AUTO_NOTES", "general", translate_marker( "Auto notes" ),
@@ -1319,6 +1332,18 @@ void options_manager::add_options_general()
 
     add_empty_line();
 
+    add( "OVERMAP_PREGENERATION", "general", translate_marker( "Overmap pregeneration distance" ),
+         translate_marker( "When you get this many overmap tiles close to the edge of the generated world, the next overmap is generated in the background, so crossing into it doesn't pause the game.  Set to 0 to disable." ),
+         0, OMAPX / 2, 30
+       );
+
+    add( "PARALLEL_MONSTER_PLANNING", "general", translate_marker( "Plan monster moves in parallel" ),
+         translate_marker( "If true, the lines of sight monsters check when they decide where to go are traced on several threads before they take their turns.  Monsters behave exactly the same, but turns with many monsters take less time on computers with several cores." ),
+         false
+       );
+
+    add_empty_line();
+
     add( "SOUND_ENABLED", "general", translate_marker( "Sound Enabled" ),
          translate_marker( "If true, music and sound are enabled." ),
          true, COPT_NO_SOUND_HIDE
@@ -2926,6 +2951,7 @@ std::string options_manager::show( bool ingame, const bool world_options_only,
             if( ingame && world_options_changed ) {
                 ACTIVE_WORLD_OPTIONS = WOPTIONS_OLD;
             }
+            values_changed();
         }
     }
 
@@ -3137,6 +3163,7 @@ options_manager::options_container options_manager::get_world_defaults() const
 
 void options_manager::set_world_options( options_container *options )
 {
+    values_changed();
     if( options == nullptr ) {
         world_options.reset();
     } else {
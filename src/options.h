@@ -220,6 +220,21 @@ class options_manager
 
         void set_world_options( options_container *options );
 
+        /**
+         * Changes whenever the value of any option may have changed, so code that keeps option
+         * values around (see @ref option_handle) knows when to read them again.
+         */
+        static int values_generation() {
+            return values_generation_;
+        }
+        /**
+         * Must be called after option values were replaced without going through the cOpt
+         * setters, e.g. by assigning a whole options container.
+         */
+        static void values_changed() {
+            ++values_generation_;
+        }
+
         /** Check if an option exists? */
         bool has_option( const std::string &name ) const;
 
@@ -273,6 +288,8 @@ class options_manager
         options_container options;
         cata::optional<options_container *> world_options;
 
+        static int values_generation_;
+
         /**
          * A page (or tab) to be displayed in the options UI.
          * It contains a @ref id that is used to detect what options should go into this
@@ -325,4 +342,34 @@ inline T get_option( const std::string &name )
     return get_options().get_option( name ).value_as<T>();
 }
 
+/**
+ * Typed handle to a single option that keeps its value, so code that runs every turn or frame
+ * doesn't have to look the option up by name each time. The value is read again after any option
+ * changed (options menu, loading options or switching the active world). Not thread safe, use
+ * it from the main thread only.
+ * \code
+ * static const option_handle<bool> autosave( "AUTOSAVE" );
+ * if( autosave.get() ) { ...
+ * \endcode
+ */
+template<typename T>
+class option_handle
+{
+    public:
+        explicit option_handle( const std::string &name ) : name( name ) {}
+
+        const T &get() const {
+            if( generation != options_manager::values_generation() ) {
+                value = get_option<T>( name );
+                generation = options_manager::values_generation();
+            }
+            return value;
+        }
+
+    private:
+        std::string name;
+        mutable T value = T();
+        mutable int generation = -1;
+};
+
 #endif // CATA_SRC_OPTIONS_H
@@ -2012,7 +2012,8 @@ void scrollingcombattext::add( const point &pos, direction p_oDir,
                                const std::string &p_sText2, const game_message_type p_gmt2,
                                const std::string &p_sType )
 {
-    if( get_option<bool>( "ANIMATION_SCT" ) ) {
+    static const option_handle<bool> animation_sct( "ANIMATION_SCT" );
+    if( animation_sct.get() ) {
 
         int iCurStep = 0;
 
@@ -2375,13 +2376,15 @@ std::string format_volume( const units::volume &volume, int width, bool *out_tru
 #   if !defined(_WIN32)
 int get_terminal_width()
 {
-    int width = get_option<int>( "TERMINAL_X" );
+    static const option_handle<int> terminal_x( "TERMINAL_X" );
+    const int width = terminal_x.get();
     return width < FULL_SCREEN_WIDTH ? FULL_SCREEN_WIDTH : width;
 }
 
 int get_terminal_height()
 {
-    return get_option<int>( "TERMINAL_Y" );
+    static const option_handle<int> terminal_y( "TERMINAL_Y" );
+    return terminal_y.get();
 }
 #   endif
 
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cmath>
 #include <cstring>
 #include <exception>
@@ -11,6 +12,8 @@
 #include <numeric>
 #include <ostream>
 #include <set>
+#include <stdexcept>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -1034,6 +1037,13 @@ overmap::overmap( const point_abs_om &p ) : loc( p )
     }
     settings = rsit->second;
 
+    gen_options.world_seed = g->get_seed();
+    gen_options.defense_game = g->gametype() == special_game_type::DEFENSE;
+    gen_options.city_size = get_option<int>( "CITY_SIZE" );
+    gen_options.city_spacing = get_option<int>( "CITY_SPACING" );
+    gen_options.wander_spawns = get_option<bool>( "WANDER_SPAWNS" );
+    gen_options.disable_animal_clash = get_option<bool>( "DISABLE_ANIMAL_CLASH" );
+
     init_layers();
 }
 
@@ -1049,6 +1059,12 @@ void overmap::populate( overmap_special_batch &enabled_specials )
 }
 
 void overmap::populate()
+{
+    overmap_special_batch enabled_specials = default_specials();
+    populate( enabled_specials );
+}
+
+overmap_special_batch overmap::default_specials() const
 {
     overmap_special_batch enabled_specials = overmap_specials::get_default_batch( loc );
 
@@ -1092,7 +1108,7 @@ void overmap::populate()
         }
     }
 
-    populate( enabled_specials );
+    return enabled_specials;
 }
 
 oter_id overmap::get_default_terrain( int z ) const
@@ -1207,6 +1223,7 @@ bool overmap::monster_check( const std::pair<tripoint_om_sm, monster> &candidate
 void overmap::insert_npc( const shared_ptr_fast<npc> &who )
 {
     npcs.push_back( who );
+    add_to_npc_cells( who );
     g->set_npcs_dirty();
 }
 
@@ -1220,11 +1237,110 @@ shared_ptr_fast<npc> overmap::erase_npc( const character_id &id )
         return nullptr;
     }
     auto ptr = *iter;
+    remove_from_npc_cells( *ptr );
     npcs.erase( iter );
     g->set_npcs_dirty();
     return ptr;
 }
 
+point overmap::npc_cell( const point_abs_sm &p ) const
+{
+    return divide_xy_round_to_minus_infinity( ( p - project_to<coords::sm>( loc ) ).raw(),
+            npc_cell_size );
+}
+
+void overmap::add_to_npc_cells( const shared_ptr_fast<npc> &who )
+{
+    // TODO: fix point types
+    const point cell = npc_cell( point_abs_sm( who->global_sm_location().xy() ) );
+    npc_cells[cell].push_back( who );
+    npc_cell_of[who->getID()] = cell;
+}
+
+void overmap::remove_from_npc_cells( const npc &who )
+{
+    const auto filed = npc_cell_of.find( who.getID() );
+    if( filed == npc_cell_of.end() ) {
+        return;
+    }
+    const auto cell = npc_cells.find( filed->second );
+    if( cell != npc_cells.end() ) {
+        std::vector<shared_ptr_fast<npc>> &cell_npcs = cell->second;
+        cell_npcs.erase( std::remove_if( cell_npcs.begin(), cell_npcs.end(),
+        [&who]( const shared_ptr_fast<npc> &n ) {
+            return n.get() == &who;
+        } ), cell_npcs.end() );
+        if( cell_npcs.empty() ) {
+            npc_cells.erase( cell );
+        }
+    }
+    npc_cell_of.erase( filed );
+}
+
+void overmap::npc_moved( const npc &who )
+{
+    const auto filed = npc_cell_of.find( who.getID() );
+    if( filed == npc_cell_of.end() ) {
+        return;
+    }
+    // TODO: fix point types
+    if( npc_cell( point_abs_sm( who.global_sm_location().xy() ) ) == filed->second ) {
+        return;
+    }
+    const auto cell = npc_cells.find( filed->second );
+    if( cell == npc_cells.end() ) {
+        return;
+    }
+    const auto iter = std::find_if( cell->second.begin(), cell->second.end(),
+    [&who]( const shared_ptr_fast<npc> &n ) {
+        return n.get() == &who;
+    } );
+    if( iter == cell->second.end() ) {
+        return;
+    }
+    const shared_ptr_fast<npc> ptr = *iter;
+    remove_from_npc_cells( who );
+    add_to_npc_cells( ptr );
+}
+
+std::vector<shared_ptr_fast<npc>> overmap::get_npcs_near( const point_abs_sm &p, const int radius,
+                               const std::function<bool( const npc & )> &predicate ) const
+{
+    std::vector<shared_ptr_fast<npc>> result;
+    const auto matches = [&]( const npc & guy ) {
+        // TODO: fix point types
+        return square_dist( p, point_abs_sm( guy.global_sm_location().xy() ) ) <= radius &&
+               predicate( guy );
+    };
+    const point min_cell = npc_cell( p - point( radius, radius ) );
+    const point max_cell = npc_cell( p + point( radius, radius ) );
+    const size_t cells_in_range = static_cast<size_t>( max_cell.x - min_cell.x + 1 ) *
+                                  ( max_cell.y - min_cell.y + 1 );
+    if( cells_in_range >= npcs.size() ) {
+        // Checking every NPC is cheaper than looking up that many squares.
+        for( const shared_ptr_fast<npc> &guy : npcs ) {
+            if( matches( *guy ) ) {
+                result.push_back( guy );
+            }
+        }
+        return result;
+    }
+    for( int x = min_cell.x; x <= max_cell.x; ++x ) {
+        for( int y = min_cell.y; y <= max_cell.y; ++y ) {
+            const auto cell = npc_cells.find( point( x, y ) );
+            if( cell == npc_cells.end() ) {
+                continue;
+            }
+            for( const shared_ptr_fast<npc> &guy : cell->second ) {
+                if( matches( *guy ) ) {
+                    result.push_back( guy );
+                }
+            }
+        }
+    }
+    return result;
+}
+
 std::vector<shared_ptr_fast<npc>> overmap::get_npcs( const
                                std::function<bool( const npc & )>
                                &predicate ) const
@@ -1445,12 +1561,14 @@ void overmap::generate( const overmap *north, const overmap *east,
                         const overmap *south, const overmap *west,
                         overmap_special_batch &enabled_specials )
 {
-    if( g->gametype() == special_game_type::DEFENSE ) {
+    if( gen_options.defense_game ) {
         dbg( D_INFO ) << "overmap::generate skipped in Defense special game mode!";
         return;
     }
 
-    dbg( D_INFO ) << "overmap::generate start…";
+    // Everything below only depends on the world seed, our position and the neighbors, so it
+    // gives the same result whenever (and on whichever thread) it runs, see overmapbuffer.
+    const scoped_rng_engine rng_scope( generation_seed() );
 
     populate_connections_out_from_neighbors( north, east, south, west );
 
@@ -1487,7 +1605,23 @@ void overmap::generate( const overmap *north, const overmap *east,
     // Place the monsters, now that the terrain is laid out
     place_mongroups();
     place_radios();
-    dbg( D_INFO ) << "overmap::generate done";
+}
+
+unsigned int overmap::generation_seed() const
+{
+    unsigned int seed = gen_options.world_seed;
+    seed ^= static_cast<unsigned int>( loc.x() ) * 73856093U;
+    seed ^= static_cast<unsigned int>( loc.y() ) * 19349663U;
+    return seed;
+}
+
+std::unique_ptr<overmap> overmap::neighbor_snapshot() const
+{
+    std::unique_ptr<overmap> result = std::make_unique<overmap>( loc );
+    // Generating a neighbor only looks at our connections and at the terrain of the ground level.
+    result->layer[OVERMAP_DEPTH] = layer[OVERMAP_DEPTH];
+    result->connections_out = connections_out;
+    return result;
 }
 
 bool overmap::generate_sub( const int z )
@@ -1958,15 +2092,32 @@ void mongroup::wander( const overmap &om )
 
 void overmap::move_hordes()
 {
-    // Prevent hordes to be moved twice by putting them in here after moving.
-    decltype( zg ) tmpzg;
+    // Find the hordes in one walk over the tree, everything below works on this list.
+    std::vector<decltype( zg )::iterator> hordes;
+    for( auto it = zg.begin(); it != zg.end(); ++it ) {
+        if( it->second.horde ) {
+            hordes.push_back( it );
+        }
+    }
+
+    // Hordes that haven't spawned any monsters yet all move as fast as their group type.
+    std::unordered_map<mongroup_id, float> group_speeds;
+    const auto avg_speed = [&group_speeds]( const mongroup & mg ) {
+        if( !mg.monsters.empty() ) {
+            return mg.avg_speed();
+        }
+        auto speed = group_speeds.find( mg.type );
+        if( speed == group_speeds.end() ) {
+            speed = group_speeds.emplace( mg.type, mg.avg_speed() ).first;
+        }
+        return speed->second;
+    };
+
+    // Decide which hordes move. They are moved afterwards, so none gets to move twice.
+    std::vector<decltype( zg )::iterator> moving;
     //MOVE ZOMBIE GROUPS
-    for( auto it = zg.begin(); it != zg.end(); ) {
+    for( const auto &it : hordes ) {
         mongroup &mg = it->second;
-        if( !mg.horde ) {
-            ++it;
-            continue;
-        }
 
         if( mg.horde_behaviour.empty() ) {
             mg.horde_behaviour = one_in( 2 ) ? "city" : "roam";
@@ -1998,30 +2149,32 @@ void overmap::move_hordes()
         // 200 or over will move at max speed, and slower hordes will move less
         // frequently. The average horde speed for regular Z's is around 100,
         // or one space per 5 minutes.
-        if( one_in( movement_chance ) && rng( 0, 100 ) < mg.interest && rng( 0, 200 ) < mg.avg_speed() ) {
-            // TODO: Handle moving to adjacent overmaps.
-            if( mg.pos.x() > mg.target.x() ) {
-                mg.pos.x()--;
-            }
-            if( mg.pos.x() < mg.target.x() ) {
-                mg.pos.x()++;
-            }
-            if( mg.pos.y() > mg.target.y() ) {
-                mg.pos.y()--;
-            }
-            if( mg.pos.y() < mg.target.y() ) {
-                mg.pos.y()++;
-            }
+        if( one_in( movement_chance ) && rng( 0, 100 ) < mg.interest && rng( 0, 200 ) < avg_speed( mg ) ) {
+            moving.push_back( it );
+        }
+    }
 
-            // Erase the group at it's old location, add the group with the new location
-            tmpzg.insert( std::pair<tripoint_om_sm, mongroup>( mg.pos, mg ) );
-            zg.erase( it++ );
-        } else {
-            ++it;
+    for( const auto &it : moving ) {
+        mongroup &mg = it->second;
+        // TODO: Handle moving to adjacent overmaps.
+        if( mg.pos.x() > mg.target.x() ) {
+            mg.pos.x()--;
+        }
+        if( mg.pos.x() < mg.target.x() ) {
+            mg.pos.x()++;
+        }
+        if( mg.pos.y() > mg.target.y() ) {
+            mg.pos.y()--;
         }
+        if( mg.pos.y() < mg.target.y() ) {
+            mg.pos.y()++;
+        }
+
+        // File the group under its new location, moving (not copying) its monsters along.
+        const tripoint_om_sm new_pos = mg.pos;
+        zg.emplace( new_pos, std::move( mg ) );
+        zg.erase( it );
     }
-    // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
 
     if( get_option<bool>( "WANDER_SPAWNS" ) ) {
 
@@ -2099,8 +2252,12 @@ void overmap::move_hordes()
 void overmap::signal_hordes( const tripoint_rel_sm &p_rel, const int sig_power )
 {
     tripoint_om_sm p( p_rel.raw() );
-    for( auto &elem : zg ) {
-        mongroup &mg = elem.second;
+    // Groups further than sig_power away on the x axis can't be in range, and the groups are
+    // sorted by x first, so only look at the ones in between.
+    const auto first = zg.lower_bound( tripoint_om_sm( p.x() - sig_power, INT_MIN, INT_MIN ) );
+    const auto last = zg.upper_bound( tripoint_om_sm( p.x() + sig_power, INT_MAX, INT_MAX ) );
+    for( auto it = first; it != last; ++it ) {
+        mongroup &mg = it->second;
         if( !mg.horde ) {
             continue;
         }
@@ -2307,8 +2464,7 @@ void overmap::place_forest_trails()
 void overmap::place_forest_trailheads()
 {
     // No trailheads if there are no cities.
-    const int city_size = get_option<int>( "CITY_SIZE" );
-    if( city_size <= 0 ) {
+    if( gen_options.city_size <= 0 ) {
         return;
     }
 
@@ -2360,7 +2516,7 @@ void overmap::place_forests()
     const oter_id forest( "forest" );
     const oter_id forest_thick( "forest_thick" );
 
-    const om_noise::om_noise_layer_forest f( global_base_point(), g->get_seed() );
+    const om_noise::om_noise_layer_forest f( global_base_point(), gen_options.world_seed );
 
     for( int x = 0; x < OMAPX; x++ ) {
         for( int y = 0; y < OMAPY; y++ ) {
@@ -2387,7 +2543,7 @@ void overmap::place_forests()
 
 void overmap::place_lakes()
 {
-    const om_noise::om_noise_layer_lake f( global_base_point(), g->get_seed() );
+    const om_noise::om_noise_layer_lake f( global_base_point(), gen_options.world_seed );
 
     const auto is_lake = [&]( const point_om_omt & p ) {
         return f.noise_at( p ) > settings.overmap_lake.noise_threshold_lake;
@@ -2704,7 +2860,7 @@ void overmap::place_swamps()
     const oter_id forest_water( "forest_water" );
 
     // Get a layer of noise to use in conjunction with our river buffered floodplain.
-    const om_noise::om_noise_layer_floodplain f( global_base_point(), g->get_seed() );
+    const om_noise::om_noise_layer_floodplain f( global_base_point(), gen_options.world_seed );
 
     for( int x = 0; x < OMAPX; x++ ) {
         for( int y = 0; y < OMAPY; y++ ) {
@@ -2888,11 +3044,11 @@ spawns happen at... <cue Clue music>
 20:56 <kevingranade>: game:pawn_mon() in game.cpp:7380*/
 void overmap::place_cities()
 {
-    int op_city_size = get_option<int>( "CITY_SIZE" );
+    const int op_city_size = gen_options.city_size;
     if( op_city_size <= 0 ) {
         return;
     }
-    int op_city_spacing = get_option<int>( "CITY_SPACING" );
+    const int op_city_spacing = gen_options.city_spacing;
 
     // spacing dictates how much of the map is covered in cities
     //   city  |  cities  |   size N cities per overmap
@@ -4186,6 +4342,11 @@ void overmap::place_specials( overmap_special_batch &enabled_specials )
     return placement.instances_placed <
            placement.special_details->occurrences.min;
 } ) ) {
+        if( speculative ) {
+            // Only the main thread may look at or create other overmaps. Give up, this overmap
+            // gets generated again (with the same result) when it's actually needed.
+            throw std::runtime_error( "speculative generation needs to create another overmap" );
+        }
         // Randomly select from among the nearest uninitialized overmap positions.
         int previous_distance = 0;
         std::vector<point_abs_om> nearest_candidates;
@@ -4258,7 +4419,7 @@ void overmap::place_mongroups()
 {
     // Cities are full of zombies
     for( city &elem : cities ) {
-        if( get_option<bool>( "WANDER_SPAWNS" ) ) {
+        if( gen_options.wander_spawns ) {
             if( !one_in( 16 ) || elem.size > 5 ) {
                 mongroup m( GROUP_ZOMBIE,
                             tripoint_om_sm( project_to<coords::sm>( elem.pos ), 0 ),
@@ -4272,7 +4433,7 @@ void overmap::place_mongroups()
         }
     }
 
-    if( get_option<bool>( "DISABLE_ANIMAL_CLASH" ) ) {
+    if( gen_options.disable_animal_clash ) {
         // Figure out where swamps are, and place swamp monsters
         for( int x = 3; x < OMAPX - 3; x += 7 ) {
             for( int y = 3; y < OMAPY - 3; y += 7 ) {
@@ -4385,7 +4546,9 @@ void overmap::open( overmap_special_batch &enabled_specials )
         }
 
         // pointers looks like (north, south, west, east)
+        dbg( D_INFO ) << "overmap::generate start…";
         generate( pointers[0], pointers[3], pointers[1], pointers[2], enabled_specials );
+        dbg( D_INFO ) << "overmap::generate done";
     }
 }
 
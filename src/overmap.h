@@ -10,12 +10,14 @@
 #include <iosfwd>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "basecamp.h"
+#include "character_id.h"
 #include "coordinates.h"
 #include "enums.h"
 #include "game_constants.h"
@@ -34,7 +36,6 @@
 class JsonIn;
 class JsonObject;
 class JsonOut;
-class character_id;
 class map_extra;
 class npc;
 class overmap_connection;
@@ -210,6 +211,8 @@ class overmap
          **/
         void populate( overmap_special_batch &enabled_specials );
         void populate();
+        /** The specials this overmap may contain, filtered by its region settings. */
+        overmap_special_batch default_specials() const;
 
         const point_abs_om &pos() const {
             return loc;
@@ -315,6 +318,14 @@ class overmap
     private:
         std::multimap<tripoint_om_sm, mongroup> zg;
     public:
+        const std::multimap<tripoint_om_sm, mongroup> &get_mongroups() const {
+            return zg;
+        }
+        void add_mon_group( const mongroup &group );
+        /** Lets the hordes within @p sig_power of @p p (relative to this overmap) take an interest in it. */
+        void signal_hordes( const tripoint_rel_sm &p, int sig_power );
+        void move_hordes();
+
         /** Unit test enablers to check if a given mongroup is present. */
         bool mongroup_check( const mongroup &candidate ) const;
         bool monster_check( const std::pair<tripoint_om_sm, monster> &candidate ) const;
@@ -342,13 +353,35 @@ class overmap
         std::vector<shared_ptr_fast<npc>> get_npcs( const std::function<bool( const npc & )>
                                        &predicate )
                                        const;
+        /**
+         * The NPCs within @p radius (square distance, in submaps) of @p p that also pass
+         * @p predicate. Only looks at NPCs filed near @p p, see @ref npc_cells.
+         */
+        std::vector<shared_ptr_fast<npc>> get_npcs_near( const point_abs_sm &p, int radius,
+                                       const std::function<bool( const npc & )> &predicate ) const;
+        /**
+         * Files @p who under its current submap again. Must be called when the submap of an NPC
+         * changes, does nothing for NPCs that aren't on this overmap.
+         */
+        void npc_moved( const npc &who );
 
     private:
         friend class overmapbuffer;
 
         std::vector<shared_ptr_fast<npc>> npcs;
+        // Side length (in submaps) of the squares @ref npc_cells groups the NPCs by.
+        static constexpr int npc_cell_size = 12;
+        // Same NPCs as npcs, grouped by the square of the overmap they are in (see npc_cell).
+        std::unordered_map<point, std::vector<shared_ptr_fast<npc>>> npc_cells;
+        // Key under which each NPC is currently filed in npc_cells.
+        std::map<character_id, point> npc_cell_of;
+        point npc_cell( const point_abs_sm &p ) const;
+        void add_to_npc_cells( const shared_ptr_fast<npc> &who );
+        void remove_from_npc_cells( const npc &who );
 
         bool nullbool = false;
+        // Generated off the main thread by overmapbuffer, must not touch other overmaps.
+        bool speculative = false;
         point_abs_om loc;
 
         std::array<map_layer, OVERMAP_LAYERS> layer;
@@ -361,6 +394,20 @@ class overmap
 
         regional_settings settings;
 
+        /**
+         * Options and world seed that generate depends on, read when the overmap is created so
+         * generating it doesn't need to look at the game (maybe from another thread).
+         */
+        struct generation_options {
+            unsigned int world_seed = 0;
+            bool defense_game = false;
+            int city_size = 0;
+            int city_spacing = 0;
+            bool wander_spawns = false;
+            bool disable_animal_clash = false;
+        };
+        generation_options gen_options;
+
         oter_id get_default_terrain( int z ) const;
 
         // Initialize
@@ -389,6 +436,13 @@ class overmap
         void generate( const overmap *north, const overmap *east,
                        const overmap *south, const overmap *west,
                        overmap_special_batch &enabled_specials );
+        /** Seed of the PRNG used by generate, derived from the world seed and our position. */
+        unsigned int generation_seed() const;
+        /**
+         * Copy of the parts of this overmap that generating an adjacent overmap reads, so that
+         * can happen on another thread while this one keeps changing.
+         */
+        std::unique_ptr<overmap> neighbor_snapshot() const;
         bool generate_sub( int z );
         bool generate_over( int z );
         // Check and put bridgeheads
@@ -396,9 +450,7 @@ class overmap
 
         const city &get_nearest_city( const tripoint_om_omt &p ) const;
 
-        void signal_hordes( const tripoint_rel_sm &p, int sig_power );
         void process_mongroups();
-        void move_hordes();
 
         static bool obsolete_terrain( const std::string &ter );
         void convert_terrain(
@@ -499,8 +551,6 @@ class overmap
         void place_mongroups();
         void place_radios();
 
-        void add_mon_group( const mongroup &group );
-
         void load_monster_groups( JsonIn &jsin );
         void load_legacy_monstergroups( JsonIn &jsin );
         void save_monster_groups( JsonOut &jo ) const;
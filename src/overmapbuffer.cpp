@@ -3,9 +3,14 @@
 #include <algorithm>
 #include <cassert>
 #include <climits>
+#include <condition_variable>
+#include <exception>
 #include <iterator>
 #include <list>
 #include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
 
 #include "basecamp.h"
 #include "calendar.h"
@@ -26,6 +31,7 @@
 #include "mongroup.h"
 #include "monster.h"
 #include "npc.h"
+#include "options.h"
 #include "optional.h"
 #include "overmap.h"
 #include "overmap_connection.h"
@@ -38,15 +44,131 @@
 #include "translations.h"
 #include "vehicle.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
 class map_extra;
 
 overmapbuffer overmap_buffer;
 
+/**
+ * An overmap generated on a background thread before anything needs it. Everything the
+ * worker touches is owned by this object, the main thread only looks at it once it's done.
+ */
+struct overmapbuffer::pregeneration {
+    const point_abs_om pos;
+    std::unique_ptr<overmap> om;
+    // Snapshots of the neighbors in the order generate takes them: north, east, south, west.
+    std::array<std::unique_ptr<overmap>, 4> neighbors;
+    overmap_special_batch specials;
+    deferred_debugmsgs messages;
+    bool failed = false;
+
+    explicit pregeneration( std::unique_ptr<overmap> new_om ) : pos( new_om->pos() ),
+        om( std::move( new_om ) ), specials( om->default_specials() ) {
+    }
+
+    // Runs on the worker thread
+    void generate() {
+        const deferred_debugmsgs::capture capture( messages );
+        try {
+            om->generate( neighbors[0].get(), neighbors[1].get(), neighbors[2].get(),
+                          neighbors[3].get(), specials );
+        } catch( const std::exception & ) {
+            // Generating it again on the main thread reports the problem, if there is one.
+            failed = true;
+        }
+    }
+};
+
+/** The thread overmaps are pregenerated on, started the first time one is. */
+class overmapbuffer::pregenerator
+{
+    public:
+        ~pregenerator() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                stopping = true;
+            }
+            job_started.notify_all();
+            if( worker.joinable() ) {
+                worker.join();
+            }
+        }
+
+        // Hands the job to the worker, returns false if there is no worker to do it.
+        bool start( pregeneration &new_job ) {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( !worker.joinable() && !start_failed ) {
+                try {
+                    worker = std::thread( &pregenerator::work, this );
+                } catch( const std::system_error &err ) {
+                    // Not a problem, the overmaps are generated when they are needed
+                    DebugLog( D_WARNING, D_MAIN ) << "Failed to start overmap generation thread: "
+                                                  << err.what();
+                    start_failed = true;
+                }
+            }
+            if( start_failed ) {
+                return false;
+            }
+            job = &new_job;
+            job_started.notify_one();
+            return true;
+        }
+
+        bool busy() {
+            std::lock_guard<std::mutex> lock( mutex );
+            return job != nullptr;
+        }
+
+        // Waits until the job is done
+        void wait() {
+            std::unique_lock<std::mutex> lock( mutex );
+            job_done.wait( lock, [this]() {
+                return job == nullptr;
+            } );
+        }
+
+    private:
+        void work() {
+            std::unique_lock<std::mutex> lock( mutex );
+            while( true ) {
+                job_started.wait( lock, [this]() {
+                    return stopping || job != nullptr;
+                } );
+                if( stopping ) {
+                    return;
+                }
+                lock.unlock();
+                job->generate();
+                lock.lock();
+                job = nullptr;
+                job_done.notify_all();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable job_started;
+        std::condition_variable job_done;
+        std::thread worker;
+        bool start_failed = false;
+        bool stopping = false;
+        // Set by the main thread, cleared by the worker when it is done with it
+        pregeneration *job = nullptr;
+};
+
 overmapbuffer::overmapbuffer()
-    : last_requested_overmap( nullptr )
+    : last_requested_overmap( nullptr ), pregeneration_worker( std::make_unique<pregenerator>() )
 {
 }
 
+overmapbuffer::~overmapbuffer()
+{
+    cancel_pregeneration();
+}
+
 const city_reference city_reference::invalid{ nullptr, tripoint_abs_sm(), -1 };
 
 int city_reference::get_distance_from_bounds() const
@@ -82,6 +204,13 @@ overmap &overmapbuffer::get( const point_abs_om &p )
         return *( last_requested_overmap = it->second.get() );
     }
 
+    // The overmap may be the one being generated in the background, or next to it.
+    finish_pregeneration();
+    const auto pregenerated = overmaps.find( p );
+    if( pregenerated != overmaps.end() ) {
+        return *( last_requested_overmap = pregenerated->second.get() );
+    }
+
     // That constructor loads an existing overmap or creates a new one.
     overmap &new_om = *( overmaps[ p ] = std::make_unique<overmap>( p ) );
     new_om.populate();
@@ -102,10 +231,107 @@ void overmapbuffer::create_custom_overmap( const point_abs_om &p, overmap_specia
             last_requested_overmap = nullptr;
         }
     }
+    if( pending_pregeneration != nullptr && pending_pregeneration->pos == p ) {
+        // Replaced by this one
+        cancel_pregeneration();
+    }
+    finish_pregeneration();
     overmap &new_om = *( overmaps[ p ] = std::make_unique<overmap>( p ) );
     new_om.populate( specials );
 }
 
+void overmapbuffer::pregenerate_near( const tripoint_abs_omt &p )
+{
+    static const option_handle<int> pregeneration_distance( "OVERMAP_PREGENERATION" );
+    if( pending_pregeneration != nullptr ) {
+        if( pregeneration_worker->busy() ) {
+            return;
+        }
+        finish_pregeneration();
+    }
+    const int distance = pregeneration_distance.get();
+    if( distance <= 0 || g->gametype() == special_game_type::DEFENSE ) {
+        return;
+    }
+
+    point_abs_om om_pos;
+    point_om_omt local;
+    std::tie( om_pos, local ) = project_remain<coords::om>( p.xy() );
+    point edge;
+    if( local.x() < distance ) {
+        edge.x = -1;
+    } else if( local.x() >= OMAPX - distance ) {
+        edge.x = 1;
+    }
+    if( local.y() < distance ) {
+        edge.y = -1;
+    } else if( local.y() >= OMAPY - distance ) {
+        edge.y = 1;
+    }
+    if( edge == point_zero ) {
+        return;
+    }
+
+    // Near a corner all three overmaps around it are candidates, the straight ones first.
+    for( const point &dir : {
+             point( edge.x, 0 ), point( 0, edge.y ), edge
+         } ) {
+        if( dir == point_zero ) {
+            continue;
+        }
+        const point_abs_om target = om_pos + dir;
+        if( overmaps.count( target ) > 0 || known_on_disk.count( target ) > 0 ) {
+            // Already there, or loading it will be quick.
+            continue;
+        }
+        if( known_non_existing.count( target ) == 0 && file_exist( terrain_filename( target ) ) ) {
+            known_on_disk.insert( target );
+            continue;
+        }
+
+        std::unique_ptr<pregeneration> job = std::make_unique<pregeneration>(
+                std::make_unique<overmap>( target ) );
+        job->om->speculative = true;
+        // Same neighbors as overmap::open would use, if this was generated right now.
+        const std::array<point, 4> offsets = {{ point_north, point_east, point_south, point_west }};
+        for( size_t i = 0; i < offsets.size(); ++i ) {
+            if( const overmap *neighbor = get_existing( target + offsets[i] ) ) {
+                job->neighbors[i] = neighbor->neighbor_snapshot();
+            }
+        }
+
+        if( pregeneration_worker->start( *job ) ) {
+            pending_pregeneration = std::move( job );
+        }
+        return;
+    }
+}
+
+void overmapbuffer::finish_pregeneration()
+{
+    if( pending_pregeneration == nullptr ) {
+        return;
+    }
+    const std::unique_ptr<pregeneration> job = std::move( pending_pregeneration );
+    pregeneration_worker->wait();
+    if( job->failed ) {
+        return;
+    }
+    job->messages.replay();
+    job->om->speculative = false;
+    overmap &new_om = *( overmaps[ job->om->pos() ] = std::move( job->om ) );
+    fix_mongroups( new_om );
+    fix_npcs( new_om );
+}
+
+void overmapbuffer::cancel_pregeneration()
+{
+    if( pending_pregeneration != nullptr ) {
+        pregeneration_worker->wait();
+        pending_pregeneration.reset();
+    }
+}
+
 void overmapbuffer::fix_mongroups( overmap &new_overmap )
 {
     for( auto it = new_overmap.zg.begin(); it != new_overmap.zg.end(); ) {
@@ -156,6 +382,7 @@ void overmapbuffer::fix_npcs( overmap &new_overmap )
             continue;
         }
         to_relocate.push_back( *it );
+        new_overmap.remove_from_npc_cells( np );
         it = new_overmap.npcs.erase( it );
     }
     // Second step: put them back where they belong. This step involves loading
@@ -183,6 +410,7 @@ void overmapbuffer::fix_npcs( overmap &new_overmap )
             // TODO: fix point types
             np.spawn_at_sm( tripoint_abs_sm( npc_sm, np.posz() ).raw() );
             new_overmap.npcs.push_back( ptr );
+            new_overmap.add_to_npc_cells( ptr );
             continue;
         }
 
@@ -201,8 +429,10 @@ void overmapbuffer::save()
 
 void overmapbuffer::clear()
 {
+    cancel_pregeneration();
     overmaps.clear();
     known_non_existing.clear();
+    known_on_disk.clear();
     last_requested_overmap = nullptr;
 }
 
@@ -257,6 +487,13 @@ overmap *overmapbuffer::get_existing( const point_abs_om &p )
     if( it != overmaps.end() ) {
         return last_requested_overmap = it->second.get();
     }
+    if( pending_pregeneration != nullptr && pending_pregeneration->pos == p ) {
+        finish_pregeneration();
+        const auto pregenerated = overmaps.find( p );
+        if( pregenerated != overmaps.end() ) {
+            return last_requested_overmap = pregenerated->second.get();
+        }
+    }
     if( known_non_existing.count( p ) > 0 ) {
         // This overmap does not exist on disk (this has already been
         // checked in a previous call of this function).
@@ -279,6 +516,10 @@ overmap *overmapbuffer::get_existing( const point_abs_om &p )
 
 bool overmapbuffer::has( const point_abs_om &p )
 {
+    if( pending_pregeneration != nullptr && pending_pregeneration->pos == p ) {
+        // Not done yet, but it will be there.
+        return true;
+    }
     return get_existing( p ) != nullptr;
 }
 
@@ -1161,14 +1402,8 @@ std::vector<shared_ptr_fast<npc>> overmapbuffer::get_npcs_near( const tripoint_a
 {
     std::vector<shared_ptr_fast<npc>> result;
     for( auto &it : get_overmaps_near( p.xy(), radius ) ) {
-        auto temp = it->get_npcs( [&]( const npc & guy ) {
-            // Global position of NPC, in submap coordinates
-            // TODO: fix point types
-            const tripoint_abs_sm pos( guy.global_sm_location() );
-            if( p.z() != INT_MIN && pos.z() != p.z() ) {
-                return false;
-            }
-            return square_dist( p.xy(), pos.xy() ) <= radius;
+        auto temp = it->get_npcs_near( p.xy(), radius, [&]( const npc & guy ) {
+            return p.z() == INT_MIN || guy.posz() == p.z();
         } );
         result.insert( result.end(), temp.begin(), temp.end() );
     }
@@ -1180,8 +1415,11 @@ std::vector<shared_ptr_fast<npc>> overmapbuffer::get_npcs_near_omt( const tripoi
                                int radius )
 {
     std::vector<shared_ptr_fast<npc>> result;
-    for( auto &it : get_overmaps_near( project_to<coords::sm>( p.xy() ), radius ) ) {
-        auto temp = it->get_npcs( [&]( const npc & guy ) {
+    // Any submap of an overmap terrain within radius of p is at most this far from its corner.
+    const point_abs_sm p_sm = project_to<coords::sm>( p.xy() );
+    const int radius_sm = omt_to_sm_copy( radius ) + 1;
+    for( auto &it : get_overmaps_near( p_sm, radius_sm ) ) {
+        auto temp = it->get_npcs_near( p_sm, radius_sm, [&]( const npc & guy ) {
             // Global position of NPC, in submap coordinates
             tripoint_abs_omt pos = guy.global_omt_location();
             if( p.z() != INT_MIN && pos.z() != p.z() ) {
@@ -1271,6 +1509,15 @@ std::vector<shared_ptr_fast<npc>> overmapbuffer::get_overmap_npcs()
     return result;
 }
 
+void overmapbuffer::npc_moved( const npc &who, const point_abs_sm &old_pos )
+{
+    // Only the overmap it was on knows it, that one is already loaded (or it has none yet).
+    const auto it = overmaps.find( project_to<coords::om>( old_pos ) );
+    if( it != overmaps.end() ) {
+        it->second->npc_moved( who );
+    }
+}
+
 std::vector<city_reference> overmapbuffer::get_cities_near( const tripoint_abs_sm &location,
         int radius )
 {
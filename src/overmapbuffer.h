@@ -124,6 +124,7 @@ class overmapbuffer
 {
     public:
         overmapbuffer();
+        ~overmapbuffer();
 
         static std::string terrain_filename( const point_abs_om & );
         static std::string player_filename( const point_abs_om & );
@@ -136,6 +137,12 @@ class overmapbuffer
         void save();
         void clear();
         void create_custom_overmap( const point_abs_om &, overmap_special_batch &specials );
+        /**
+         * Starts generating the overmap next to @p p on a background thread if @p p is within
+         * the "OVERMAP_PREGENERATION" distance of the edge of its overmap and that neighbor
+         * does not exist yet. The result is the same as generating it when it's first needed.
+         */
+        void pregenerate_near( const tripoint_abs_omt &p );
 
         /**
          * Uses global overmap terrain coordinates, creates the
@@ -259,6 +266,11 @@ class overmapbuffer
          * Get all NPCs active on the overmap
          */
         std::vector<shared_ptr_fast<npc>> get_overmap_npcs();
+        /**
+         * Tells the overmap of @p who that it moved from the submap @p old_pos (global submap
+         * coordinates) to another one, see @ref overmap::npc_moved.
+         */
+        void npc_moved( const npc &who, const point_abs_sm &old_pos );
         /**
          * Find npc by id and if found, erase it from the npc list
          * and return it ( or return nullptr if not found ).
@@ -487,9 +499,24 @@ class overmapbuffer
          * to not exist on disk. See @ref get_existing for usage.
          */
         mutable std::set<point_abs_om> known_non_existing;
+        // Overmaps not loaded yet that are known to exist on disk, see pregenerate_near
+        std::set<point_abs_om> known_on_disk;
         // Cached result of previous call to overmapbuffer::get_existing
         overmap mutable *last_requested_overmap;
 
+        struct pregeneration;
+        class pregenerator;
+        // Overmap being generated in the background, see pregenerate_near
+        std::unique_ptr<pregeneration> pending_pregeneration;
+        std::unique_ptr<pregenerator> pregeneration_worker;
+        /**
+         * Waits for the background generation to finish and adds its overmap. Must be called
+         * before creating any other overmap, which would otherwise not know about that one.
+         */
+        void finish_pregeneration();
+        // Waits for the background generation to finish and throws its overmap away.
+        void cancel_pregeneration();
+
         /**
          * Get a list of notes in the (loaded) overmaps.
          * @param z only this specific z-level is search for notes.
@@ -49,6 +49,7 @@
 #include "string_id.h"
 #include "tileray.h"
 #include "translations.h"
+#include "turn_profiler.h"
 #include "type_id.h"
 #include "ui_manager.h"
 #include "units.h"
@@ -1819,6 +1820,35 @@ static void draw_ai_goal( const avatar &u, const catacurses::window &w )
     wnoutrefresh( w );
 }
 
+static void draw_turn_profile( const avatar &, const catacurses::window &w )
+{
+    werase( w );
+    if( !turn_profiler::enabled() ) {
+        // NOLINTNEXTLINE(cata-use-named-point-constants)
+        mvwprintz( w, point( 1, 0 ), c_light_gray, _( "Turn profiler is off" ) );
+        wnoutrefresh( w );
+        return;
+    }
+    const int width = getmaxx( w );
+    const int name_width = width - 17;
+    // NOLINTNEXTLINE(cata-use-named-point-constants)
+    mvwprintz( w, point( 1, 0 ), c_white, _( "Zone" ) );
+    mvwprintz( w, point( width - 16, 0 ), c_white, "%7s %7s", _( "avg ms" ), _( "last ms" ) );
+    int row = 1;
+    for( const turn_profiler::zone_report &zone : turn_profiler::report() ) {
+        if( row >= getmaxy( w ) ) {
+            break;
+        }
+        const std::string name = std::string( zone.depth, ' ' ) + zone.name;
+        mvwprintz( w, point( 1, row ), zone.depth == 0 ? c_light_gray : c_dark_gray, "%s",
+                   utf8_truncate( name, name_width ) );
+        mvwprintz( w, point( width - 16, row ), c_light_gray, "%7.2f %7.2f", zone.average_ms,
+                   zone.last_ms );
+        ++row;
+    }
+    wnoutrefresh( w );
+}
+
 static void draw_location_classic( const avatar &u, const catacurses::window &w )
 {
     werase( w );
@@ -2001,6 +2031,7 @@ static std::vector<window_panel> initialize_default_classic_panels()
                                     default_render, true ) );
 #endif // TILES
     ret.emplace_back( window_panel( draw_ai_goal, "AI Needs", 1, 44, false ) );
+    ret.emplace_back( window_panel( draw_turn_profile, "Turn profile", 10, 44, false ) );
     return ret;
 }
 
@@ -2025,6 +2056,7 @@ static std::vector<window_panel> initialize_default_compact_panels()
                                     default_render, true ) );
 #endif // TILES
     ret.emplace_back( window_panel( draw_ai_goal, "AI Needs", 1, 32, false ) );
+    ret.emplace_back( window_panel( draw_turn_profile, "Turn profile", 10, 32, false ) );
 
     return ret;
 }
@@ -2055,6 +2087,7 @@ static std::vector<window_panel> initialize_default_label_narrow_panels()
                                     default_render, true ) );
 #endif // TILES
     ret.emplace_back( window_panel( draw_ai_goal, "AI Needs", 1, 32, false ) );
+    ret.emplace_back( window_panel( draw_turn_profile, "Turn profile", 10, 32, false ) );
 
     return ret;
 }
@@ -2086,6 +2119,7 @@ static std::vector<window_panel> initialize_default_label_panels()
                                     default_render, true ) );
 #endif // TILES
     ret.emplace_back( window_panel( draw_ai_goal, "AI Needs", 1, 44, false ) );
+    ret.emplace_back( window_panel( draw_turn_profile, "Turn profile", 10, 44, false ) );
 
     return ret;
 }
@@ -0,0 +1,176 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "debug.h"
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+namespace
+{
+
+// Threads parallel_for uses, 0 for one per core
+std::atomic<size_t> thread_count_override( 0 );
+
+// Set on the pool threads and on a thread running parallel_for, so nested calls run serially
+thread_local bool in_parallel_for = false;
+
+class worker_pool
+{
+    public:
+        ~worker_pool();
+        /**
+         * Calls func for every index in [0, count) on the calling thread and up to extra_threads
+         * pool threads, starting threads as needed.
+         */
+        void run( size_t count, const std::function<void( size_t )> &func, size_t extra_threads );
+
+        // Held while a thread runs a job, the pool works on one job at a time
+        std::mutex dispatch_mutex;
+
+    private:
+        void work( unsigned int seen_generation );
+        void process();
+
+        std::mutex mutex;
+        std::condition_variable job_ready;
+        std::condition_variable job_done;
+        std::vector<std::thread> threads;
+        bool start_failed = false;
+        bool stopping = false;
+
+        // The current job, guarded by mutex except for next_index
+        unsigned int generation = 0;
+        const std::function<void( size_t )> *func = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> next_index;
+        // Pool threads allowed to join the job, the ones that did and the ones still working
+        size_t participants = 0;
+        size_t claimed = 0;
+        size_t running = 0;
+};
+
+worker_pool::~worker_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    job_ready.notify_all();
+    for( std::thread &t : threads ) {
+        t.join();
+    }
+}
+
+void worker_pool::process()
+{
+    for( size_t i = next_index++; i < count; i = next_index++ ) {
+        ( *func )( i );
+    }
+}
+
+void worker_pool::work( unsigned int seen_generation )
+{
+    in_parallel_for = true;
+    std::unique_lock<std::mutex> lock( mutex );
+    while( true ) {
+        job_ready.wait( lock, [&]() {
+            return stopping || generation != seen_generation;
+        } );
+        if( stopping ) {
+            return;
+        }
+        seen_generation = generation;
+        if( claimed >= participants ) {
+            continue;
+        }
+        ++claimed;
+        ++running;
+        lock.unlock();
+        process();
+        lock.lock();
+        if( --running == 0 ) {
+            job_done.notify_all();
+        }
+    }
+}
+
+void worker_pool::run( const size_t count, const std::function<void( size_t )> &func,
+                       const size_t extra_threads )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        while( threads.size() < extra_threads && !start_failed ) {
+            try {
+                const unsigned int current = generation;
+                threads.emplace_back( [this, current]() {
+                    work( current );
+                } );
+            } catch( const std::system_error &err ) {
+                // Not fatal, the threads that did start do the work
+                DebugLog( D_WARNING, D_MAIN ) << "Failed to start worker thread: " << err.what();
+                start_failed = true;
+            }
+        }
+        this->func = &func;
+        this->count = count;
+        next_index = 0;
+        participants = std::min( extra_threads, threads.size() );
+        claimed = 0;
+        ++generation;
+    }
+    job_ready.notify_all();
+    process();
+
+    std::unique_lock<std::mutex> lock( mutex );
+    // Threads that haven't woken up by now would find no work left
+    participants = claimed;
+    job_done.wait( lock, [this]() {
+        return running == 0;
+    } );
+}
+
+worker_pool &get_worker_pool()
+{
+    static worker_pool pool;
+    return pool;
+}
+
+} // namespace
+
+void parallel_for( const size_t count, const std::function<void( size_t )> &func )
+{
+    const size_t wanted_threads = thread_count_override != 0 ? thread_count_override.load() :
+                                  std::thread::hardware_concurrency();
+    const size_t num_threads = std::min<size_t>( wanted_threads, count );
+    worker_pool &pool = get_worker_pool();
+    std::unique_lock<std::mutex> dispatch_lock( pool.dispatch_mutex, std::defer_lock );
+    if( num_threads < 2 || in_parallel_for || !dispatch_lock.try_lock() ) {
+        for( size_t i = 0; i < count; i++ ) {
+            func( i );
+        }
+        return;
+    }
+
+    in_parallel_for = true;
+    pool.run( count, func, num_threads - 1 );
+    in_parallel_for = false;
+}
+
+scoped_parallel_threads::scoped_parallel_threads( const size_t threads ) :
+    previous( thread_count_override.exchange( threads ) )
+{
+}
+
+scoped_parallel_threads::~scoped_parallel_threads()
+{
+    thread_count_override = previous;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#ifndef CATA_SRC_PARALLEL_H
+#define CATA_SRC_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Calls @p func once for every index in [0, count), spread over up to
+ * std::thread::hardware_concurrency() threads. The calling thread does its share of the work and
+ * the function returns once all calls have finished.
+ *
+ * The other threads belong to a pool that is started on first use and kept for the rest of the
+ * program, so calling this every turn doesn't start threads every turn. Calls made from inside
+ * @p func, or while another thread is using the pool, run on the calling thread only.
+ *
+ * The calls run in no particular order and at the same time, so @p func must not write anything
+ * another call reads or writes, and must not throw. Errors it reports with debugmsg must be
+ * captured with @ref deferred_debugmsgs. If a thread can't be started, the threads that did
+ * start do the remaining work.
+ */
+void parallel_for( size_t count, const std::function<void( size_t )> &func );
+
+/**
+ * While alive, parallel_for on any thread uses @p threads threads, including the calling one,
+ * instead of one per core. 1 makes it run serially. Used by tests to compare results of threaded
+ * and serial runs on any machine.
+ */
+class scoped_parallel_threads
+{
+    public:
+        explicit scoped_parallel_threads( size_t threads );
+        ~scoped_parallel_threads();
+        scoped_parallel_threads( const scoped_parallel_threads & ) = delete;
+        scoped_parallel_threads &operator=( const scoped_parallel_threads & ) = delete;
+    private:
+        size_t previous;
+};
+
+#endif // CATA_SRC_PARALLEL_H
@@ -260,6 +260,10 @@ std::string PATH_INFO::lastworld()
 {
     return config_dir_value + "lastworld.json";
 }
+std::string PATH_INFO::verified_data()
+{
+    return config_dir_value + "verified_data.json";
+}
 std::string PATH_INFO::legacy_autopickup()
 {
     return "data/auto_pickup.txt";
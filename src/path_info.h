@@ -54,6 +54,7 @@ std::string templatedir();
 std::string user_dir();
 std::string user_keybindings();
 std::string user_moddir();
+std::string verified_data();
 std::string world_base_save_path();
 std::string worldoptions();
 std::string crash();
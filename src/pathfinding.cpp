@@ -2,13 +2,17 @@
 
 #include <cstdlib>
 #include <algorithm>
+#include <bitset>
 #include <queue>
 #include <set>
 #include <array>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "cata_utility.h"
 #include "coordinates.h"
 #include "debug.h"
@@ -145,6 +149,330 @@ bool vertical_move_destination( const map &m, tripoint &t )
     return false;
 }
 
+// Routes shorter than this are always searched directly.
+// Must stay above the size of a cluster, so that the local refinement of a hierarchical
+// route never recurses into the cluster graph.
+static constexpr int hierarchical_route_min_dist = 2 * SEEX;
+
+static_assert( hierarchical_route_min_dist >= SEEX && hierarchical_route_min_dist >= SEEY,
+               "Refinement of hierarchical routes would recurse" );
+
+static int cluster_index( const point &cluster )
+{
+    return cluster.x + cluster.y * MAPSIZE;
+}
+
+static point cluster_of( const point &p )
+{
+    return point( p.x / SEEX, p.y / SEEY );
+}
+
+// Index of p inside of its cluster
+static int cluster_local_index( const point &p )
+{
+    return ( p.x % SEEX ) * SEEY + ( p.y % SEEY );
+}
+
+// Cheapest walking cost from `from` to every square of its cluster, without leaving the cluster.
+// Unreachable squares get -1.
+static void cluster_distances( const pathfinding_cluster_graph &graph, const point &from,
+                               std::array<int, SEEX *SEEY> &dist )
+{
+    const point cluster = cluster_of( from );
+    const point min( cluster.x * SEEX, cluster.y * SEEY );
+    const point max( min.x + SEEX - 1, min.y + SEEY - 1 );
+    dist.fill( -1 );
+    dist[cluster_local_index( from )] = 0;
+    std::priority_queue< std::pair<int, point>, std::vector< std::pair<int, point> >, pair_greater_cmp_first >
+    open;
+    open.emplace( 0, from );
+    while( !open.empty() ) {
+        const std::pair<int, point> cur = open.top();
+        open.pop();
+        if( cur.first > dist[cluster_local_index( cur.second )] ) {
+            continue;
+        }
+        for( const tripoint &d : eight_horizontal_neighbors ) {
+            const point p = cur.second + d.xy();
+            if( p.x < min.x || p.x > max.x || p.y < min.y || p.y > max.y ) {
+                continue;
+            }
+            const int cost = graph.cost[p.x][p.y];
+            if( cost == 0 ) {
+                continue;
+            }
+            // Same diagonal penalty as the full search
+            const int newg = cur.first + cost + ( d.x != 0 && d.y != 0 ? 1 : 0 );
+            int &best = dist[cluster_local_index( p )];
+            if( best < 0 || newg < best ) {
+                best = newg;
+                open.emplace( newg, p );
+            }
+        }
+    }
+}
+
+// Adds the portals on the edge between the cluster and its neighbor in direction dir.
+// Every open stretch of the edge gets one portal in its middle, or one at each end if it is long.
+// Both clusters sharing an edge find the same portals.
+static void add_cluster_portals( const pathfinding_cluster_graph &graph, const point &cluster,
+                                 const point &dir, pathfinding_cluster_graph::cluster &out )
+{
+    const bool vertical_edge = dir.x != 0;
+    const int length = vertical_edge ? SEEY : SEEX;
+    const point first( cluster.x * SEEX + ( dir.x > 0 ? SEEX - 1 : 0 ),
+                       cluster.y * SEEY + ( dir.y > 0 ? SEEY - 1 : 0 ) );
+    const point step = vertical_edge ? point_south : point_east;
+    const auto add_portal = [&]( int i ) {
+        const point here = first + step * i;
+        const point there = here + dir;
+        const auto iter = std::find( out.entrances.begin(), out.entrances.end(), here );
+        if( iter == out.entrances.end() ) {
+            out.entrances.push_back( here );
+            out.exits.emplace_back( 1, there );
+        } else {
+            out.exits[iter - out.entrances.begin()].push_back( there );
+        }
+    };
+    int run_start = -1;
+    for( int i = 0; i <= length; i++ ) {
+        const point here = first + step * i;
+        const point there = here + dir;
+        const bool open = i < length && graph.cost[here.x][here.y] != 0 &&
+                          graph.cost[there.x][there.y] != 0;
+        if( open && run_start < 0 ) {
+            run_start = i;
+        } else if( !open && run_start >= 0 ) {
+            const int run_end = i - 1;
+            if( run_end - run_start + 1 > 6 ) {
+                add_portal( run_start );
+                add_portal( run_end );
+            } else {
+                add_portal( ( run_start + run_end ) / 2 );
+            }
+            run_start = -1;
+        }
+    }
+}
+
+void map::update_pathfinding_cluster_graph( const int zlev ) const
+{
+    // Make sure the squares are up to date first, this might dirty the graph
+    get_pathfinding_cache_ref( zlev );
+    pathfinding_cluster_graph &graph = get_pathfinding_cache( zlev ).cluster_graph;
+    if( !graph.dirty ) {
+        return;
+    }
+
+    const pathfinding_cache &pf_cache = get_pathfinding_cache( zlev );
+    std::bitset<MAPSIZE *MAPSIZE> changed;
+    for( int cx = 0; cx < my_MAPSIZE; cx++ ) {
+        for( int cy = 0; cy < my_MAPSIZE; cy++ ) {
+            for( int x = cx * SEEX; x < ( cx + 1 ) * SEEX; x++ ) {
+                for( int y = cy * SEEY; y < ( cy + 1 ) * SEEY; y++ ) {
+                    const pf_special special = pf_cache.special[x][y];
+                    uint8_t cost = 2;
+                    if( special & PF_WALL ) {
+                        // Doors are assumed to be openable, the local search will sort it out
+                        const maptile tile = maptile_at_internal( tripoint( x, y, zlev ) );
+                        cost = tile.get_ter_t().open || tile.get_furn_t().open ? 6 : 0;
+                    } else if( special & PF_SLOW ) {
+                        cost = 4;
+                    }
+                    if( graph.cost[x][y] != cost ) {
+                        graph.cost[x][y] = cost;
+                        changed.set( cluster_index( point( cx, cy ) ) );
+                    }
+                }
+            }
+        }
+    }
+
+    // A change in a cluster moves the portals on its edges, so the neighbors need rebuilding too
+    std::bitset<MAPSIZE *MAPSIZE> rebuild = changed;
+    for( int cx = 0; cx < my_MAPSIZE; cx++ ) {
+        for( int cy = 0; cy < my_MAPSIZE; cy++ ) {
+            if( !changed[cluster_index( point( cx, cy ) )] ) {
+                continue;
+            }
+            for( const point &d : four_adjacent_offsets ) {
+                const point neighbor = point( cx, cy ) + d;
+                if( neighbor.x >= 0 && neighbor.x < my_MAPSIZE && neighbor.y >= 0 && neighbor.y < my_MAPSIZE ) {
+                    rebuild.set( cluster_index( neighbor ) );
+                }
+            }
+        }
+    }
+
+    std::array<int, SEEX *SEEY> dist;
+    for( int cx = 0; cx < my_MAPSIZE; cx++ ) {
+        for( int cy = 0; cy < my_MAPSIZE; cy++ ) {
+            const point cluster_pos( cx, cy );
+            if( !rebuild[cluster_index( cluster_pos )] ) {
+                continue;
+            }
+            pathfinding_cluster_graph::cluster &cluster = graph.clusters[cluster_index( cluster_pos )];
+            cluster.entrances.clear();
+            cluster.exits.clear();
+            for( const point &d : four_adjacent_offsets ) {
+                const point neighbor = cluster_pos + d;
+                if( neighbor.x >= 0 && neighbor.x < my_MAPSIZE && neighbor.y >= 0 && neighbor.y < my_MAPSIZE ) {
+                    add_cluster_portals( graph, cluster_pos, d, cluster );
+                }
+            }
+            const size_t num_entrances = cluster.entrances.size();
+            cluster.costs.assign( num_entrances * num_entrances, -1 );
+            for( size_t i = 0; i < num_entrances; i++ ) {
+                cluster_distances( graph, cluster.entrances[i], dist );
+                for( size_t j = 0; j < num_entrances; j++ ) {
+                    cluster.costs[i * num_entrances + j] = dist[cluster_local_index( cluster.entrances[j] )];
+                }
+            }
+        }
+    }
+
+    graph.dirty = false;
+}
+
+std::vector<tripoint> map::route_hierarchical( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings,
+        const std::set<tripoint> &pre_closed ) const
+{
+    if( !inbounds( f ) || !inbounds( t ) || f.z != t.z ) {
+        return std::vector<tripoint>();
+    }
+    const point f_cluster = cluster_of( f.xy() );
+    const point t_cluster = cluster_of( t.xy() );
+    if( f_cluster == t_cluster ) {
+        return std::vector<tripoint>();
+    }
+
+    update_pathfinding_cluster_graph( f.z );
+    const pathfinding_cluster_graph &graph = get_pathfinding_cache( f.z ).cluster_graph;
+
+    std::array<int, SEEX *SEEY> f_dist;
+    std::array<int, SEEX *SEEY> t_dist;
+    cluster_distances( graph, f.xy(), f_dist );
+    cluster_distances( graph, t.xy(), t_dist );
+
+    // A* over the entrances, nodes are identified by their flat index
+    std::unordered_map<int, std::pair<int, point>> visited;
+    std::unordered_set<int> closed;
+    std::priority_queue< std::pair<int, point>, std::vector< std::pair<int, point> >, pair_greater_cmp_first >
+    open;
+    const auto add_point = [&]( const point & from, const point & to, const int gscore ) {
+        const int index = flat_index( to );
+        const auto iter = visited.find( index );
+        if( closed.count( index ) || ( iter != visited.end() && iter->second.first <= gscore ) ) {
+            return;
+        }
+        visited[index] = std::make_pair( gscore, from );
+        open.emplace( gscore + 2 * rl_dist( to, t.xy() ), to );
+    };
+
+    visited[flat_index( f.xy() )] = std::make_pair( 0, f.xy() );
+    open.emplace( 0, f.xy() );
+    bool done = false;
+    while( !open.empty() ) {
+        const point cur = open.top().second;
+        open.pop();
+        const int cur_index = flat_index( cur );
+        if( !closed.insert( cur_index ).second ) {
+            continue;
+        }
+        if( cur == t.xy() ) {
+            done = true;
+            break;
+        }
+        const int gscore = visited[cur_index].first;
+        if( gscore > settings.max_length ) {
+            break;
+        }
+
+        if( cur == f.xy() ) {
+            const pathfinding_cluster_graph::cluster &cluster = graph.clusters[cluster_index( f_cluster )];
+            for( size_t i = 0; i < cluster.entrances.size(); i++ ) {
+                const point &entrance = cluster.entrances[i];
+                if( entrance == cur ) {
+                    // The start is closed already, so it has to leave through its own portals here
+                    for( const point &exit : cluster.exits[i] ) {
+                        add_point( cur, exit, gscore + graph.cost[exit.x][exit.y] );
+                    }
+                    continue;
+                }
+                const int cost = f_dist[cluster_local_index( entrance )];
+                if( cost >= 0 ) {
+                    add_point( cur, entrance, gscore + cost );
+                }
+            }
+            continue;
+        }
+
+        const point cur_cluster = cluster_of( cur );
+        const pathfinding_cluster_graph::cluster &cluster = graph.clusters[cluster_index( cur_cluster )];
+        const size_t num_entrances = cluster.entrances.size();
+        const size_t i = std::find( cluster.entrances.begin(), cluster.entrances.end(), cur ) -
+                         cluster.entrances.begin();
+        if( i >= num_entrances ) {
+            debugmsg( "Square %d,%d is not an entrance of its cluster", cur.x, cur.y );
+            continue;
+        }
+        for( size_t j = 0; j < num_entrances; j++ ) {
+            const int cost = cluster.costs[i * num_entrances + j];
+            if( j != i && cost >= 0 ) {
+                add_point( cur, cluster.entrances[j], gscore + cost );
+            }
+        }
+        for( const point &exit : cluster.exits[i] ) {
+            add_point( cur, exit, gscore + graph.cost[exit.x][exit.y] );
+        }
+        if( cur_cluster == t_cluster ) {
+            const int cost = t_dist[cluster_local_index( cur )];
+            if( cost >= 0 ) {
+                add_point( cur, t.xy(), gscore + cost );
+            }
+        }
+    }
+
+    if( !done ) {
+        return std::vector<tripoint>();
+    }
+
+    std::vector<point> waypoints;
+    for( point cur = t.xy(); cur != f.xy(); cur = visited[flat_index( cur )].second ) {
+        waypoints.push_back( cur );
+    }
+    std::reverse( waypoints.begin(), waypoints.end() );
+
+    // Refine the route with local searches, each to the farthest waypoint that is still close
+    // enough to be searched directly. Skipping waypoints lets the local search cut the corners
+    // the portals force on the abstract route.
+    std::vector<tripoint> ret;
+    tripoint cur = f;
+    for( size_t i = 0; i < waypoints.size(); ) {
+        size_t next_index = i;
+        while( next_index + 1 < waypoints.size() &&
+               rl_dist( cur.xy(), waypoints[next_index + 1] ) <= hierarchical_route_min_dist ) {
+            next_index++;
+        }
+        const tripoint next( waypoints[next_index], f.z );
+        const std::vector<tripoint> leg = route( cur, next, settings, pre_closed );
+        if( leg.empty() || leg.back() != next ) {
+            return std::vector<tripoint>();
+        }
+        ret.insert( ret.end(), leg.begin(), leg.end() );
+        cur = next;
+        i = next_index + 1;
+    }
+
+    // Same limit as the full search, where every step costs at least 2
+    if( static_cast<int>( ret.size() ) * 2 > settings.max_length ) {
+        return std::vector<tripoint>();
+    }
+
+    return ret;
+}
+
 template<class Set1, class Set2>
 bool is_disjoint( const Set1 &set1, const Set2 &set2 )
 {
@@ -176,6 +504,239 @@ bool is_disjoint( const Set1 &set1, const Set2 &set2 )
     return true;
 }
 
+// Squares that can't be walked over without a closer look
+static constexpr pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
+
+// Whether the line can be walked as it is: nothing but flat ground and no pre-closed squares
+static bool is_straight_route( const pathfinding_cache &pf_cache,
+                               const std::vector<tripoint> &line_path, const std::set<tripoint> &pre_closed )
+{
+    // Check all points for any special case (including just hard terrain)
+    if( !std::all_of( line_path.begin(), line_path.end(), [&pf_cache]( const tripoint & p ) {
+    return !( pf_cache.special[p.x][p.y] & non_normal );
+    } ) ) {
+        return false;
+    }
+    const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
+    return is_disjoint( sorted_line, pre_closed );
+}
+
+tripoint pathfinding_flow_field::next_step( const tripoint &p ) const
+{
+    const int dist = distance_at( p.xy() );
+    if( dist <= 0 ) {
+        return p;
+    }
+    tripoint best = p;
+    int best_dist = dist;
+    for( const tripoint &d : eight_horizontal_neighbors ) {
+        const tripoint next = p + d;
+        const int next_dist = distance_at( next.xy() );
+        if( next_dist < 0 || next_dist >= best_dist || enter_cost[index( next.xy() )] < 0 ) {
+            continue;
+        }
+        // Only squares the field was actually relaxed through, see map::get_flow_field
+        const int step_cost = enter_cost[index( next.xy() )] + ( d.x != 0 && d.y != 0 ? 1 : 0 );
+        if( next_dist + step_cost == dist ) {
+            best = next;
+            best_dist = next_dist;
+        }
+    }
+    return best;
+}
+
+int map::flow_field_enter_cost( const tripoint &p, const pathfinding_settings &settings ) const
+{
+    // Same costs as in the neighbor loop of route_astar, minus the parts that depend on
+    // where the square is entered from.
+    const pf_special p_special = get_pathfinding_cache_ref( p.z ).special[p.x][p.y];
+    if( !( p_special & non_normal ) ) {
+        return 2;
+    }
+    if( settings.avoid_rough_terrain ) {
+        return -1;
+    }
+
+    const int bash = settings.bash_strength;
+    const bool doors = settings.allow_open_doors;
+    int part = -1;
+    const maptile &tile = maptile_at_internal( p );
+    const auto &terrain = tile.get_ter_t();
+    const auto &furniture = tile.get_furn_t();
+    const vehicle *veh = veh_at_internal( p, part );
+
+    const int cost = move_cost_internal( furniture, terrain, veh, part );
+    const int rating = ( bash == 0 || cost != 0 ) ? -1 :
+                       bash_rating_internal( bash, furniture, terrain, false, veh, part );
+
+    if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
+        settings.climb_cost <= 0 ) {
+        return -1;
+    }
+
+    int newg = cost;
+    if( cost == 0 ) {
+        if( settings.climb_cost > 0 && p_special & PF_CLIMBABLE ) {
+            newg += settings.climb_cost;
+        } else if( doors && ( terrain.open || furniture.open ) &&
+                   ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ) ) {
+            newg += 4;
+        } else if( veh != nullptr ) {
+            const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
+            part = vpobst ? vpobst->part_index() : -1;
+            if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
+                !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ) {
+                newg += 10;
+            } else if( part >= 0 && bash > 0 ) {
+                int hp = veh->cpart( part ).hp();
+                if( hp / 20 > bash ) {
+                    return -1;
+                } else if( hp / 10 > bash ) {
+                    hp *= 2;
+                }
+                newg += 2 * hp / bash + 8 + 4;
+            } else if( part >= 0 ) {
+                return -1;
+            }
+        } else if( rating > 1 ) {
+            newg += ( 20 / rating ) + 2 + 10;
+        } else if( rating == 1 ) {
+            newg += 500;
+        } else {
+            return -1;
+        }
+    }
+
+    if( settings.avoid_traps && p_special & PF_TRAP ) {
+        const auto &ter_trp = terrain.trap.obj();
+        const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+        if( !trp.is_benign() ) {
+            if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
+                // Ledges lead to another z-level, which the field doesn't cover
+                return -1;
+            }
+            newg += 500;
+        }
+    }
+
+    if( settings.avoid_sharp && p_special & PF_SHARP ) {
+        return -1;
+    }
+
+    return newg;
+}
+
+const pathfinding_flow_field &map::get_flow_field( const tripoint &t,
+        const pathfinding_settings &settings ) const
+{
+    if( flow_fields_turn != calendar::turn ) {
+        flow_fields.clear();
+        flow_fields_turn = calendar::turn;
+    }
+    for( const std::unique_ptr<pathfinding_flow_field> &field : flow_fields ) {
+        if( field->goal == t && field->settings == settings ) {
+            return *field;
+        }
+    }
+
+    flow_fields.push_back( std::make_unique<pathfinding_flow_field>() );
+    pathfinding_flow_field &field = *flow_fields.back();
+    field.goal = t;
+    field.settings = settings;
+    // Cover every bounding box route_astar could search for a start within max_dist
+    const int pad = 16;
+    int minx = t.x - settings.max_dist - pad;
+    int miny = t.y - settings.max_dist - pad;
+    int maxx = t.x + settings.max_dist + pad;
+    int maxy = t.y + settings.max_dist + pad;
+    clip_to_bounds( minx, miny );
+    clip_to_bounds( maxx, maxy );
+    field.min = point( minx, miny );
+    field.max = point( maxx, maxy );
+    const size_t size = ( maxx - minx + 1 ) * ( maxy - miny + 1 );
+    field.enter_cost.assign( size, -1 );
+    field.distance.assign( size, -1 );
+    for( int x = minx; x <= maxx; x++ ) {
+        for( int y = miny; y <= maxy; y++ ) {
+            const tripoint p( x, y, t.z );
+            field.enter_cost[field.index( p.xy() )] = flow_field_enter_cost( p, settings );
+        }
+    }
+
+    // Dijkstra outwards from the goal. Walking from p onto q costs the entry cost of q,
+    // so q relaxes its neighbors with its own entry cost.
+    std::priority_queue< std::pair<int, point>, std::vector< std::pair<int, point> >, pair_greater_cmp_first >
+    open;
+    field.distance[field.index( t.xy() )] = 0;
+    open.emplace( 0, t.xy() );
+    while( !open.empty() ) {
+        const std::pair<int, point> cur = open.top();
+        open.pop();
+        const int cur_index = field.index( cur.second );
+        if( cur.first > field.distance[cur_index] || cur.first > settings.max_length ) {
+            continue;
+        }
+        const int cur_cost = field.enter_cost[cur_index];
+        if( cur_cost < 0 ) {
+            continue;
+        }
+        for( const tripoint &d : eight_horizontal_neighbors ) {
+            const point p = cur.second + d.xy();
+            if( !field.contains( p ) ) {
+                continue;
+            }
+            const int newg = cur.first + cur_cost + ( d.x != 0 && d.y != 0 ? 1 : 0 );
+            int &dist = field.distance[field.index( p )];
+            if( dist < 0 || newg < dist ) {
+                dist = newg;
+                open.emplace( newg, p );
+            }
+        }
+    }
+
+    return field;
+}
+
+std::vector<tripoint> map::route_flow_field( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings ) const
+{
+    if( f == t || f.z != t.z || !inbounds( f ) || !inbounds( t ) ) {
+        return route( f, t, settings );
+    }
+
+    std::vector<tripoint> ret = line_to( f, t );
+    if( is_straight_route( get_pathfinding_cache_ref( f.z ), ret, std::set<tripoint>() ) ) {
+        return ret;
+    }
+    ret.clear();
+
+    if( rl_dist( f, t ) > settings.max_dist ) {
+        return ret;
+    }
+
+    const pathfinding_flow_field &field = get_flow_field( t, settings );
+    const int dist = field.distance_at( f.xy() );
+    if( dist < 0 ) {
+        // Might still be reachable over another z-level
+        return route( f, t, settings );
+    }
+    if( dist > settings.max_length ) {
+        return ret;
+    }
+
+    tripoint cur = f;
+    while( cur != t ) {
+        const tripoint next = field.next_step( cur );
+        if( next == cur ) {
+            debugmsg( "Flow field towards %s is broken at %s", t.to_string(), cur.to_string() );
+            return std::vector<tripoint>();
+        }
+        ret.push_back( next );
+        cur = next;
+    }
+    return ret;
+}
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const pathfinding_settings &settings,
                                   const std::set<tripoint> &pre_closed ) const
@@ -196,19 +757,10 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     }
     // First, check for a simple straight line on flat ground
     // Except when the line contains a pre-closed tile - we need to do regular pathing then
-    static const auto non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
     if( f.z == t.z ) {
-        const auto line_path = line_to( f, t );
-        const auto &pf_cache = get_pathfinding_cache_ref( f.z );
-        // Check all points for any special case (including just hard terrain)
-        if( std::all_of( line_path.begin(), line_path.end(), [&pf_cache]( const tripoint & p ) {
-        return !( pf_cache.special[p.x][p.y] & non_normal );
-        } ) ) {
-            const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
-
-            if( is_disjoint( sorted_line, pre_closed ) ) {
-                return line_path;
-            }
+        std::vector<tripoint> line_path = line_to( f, t );
+        if( is_straight_route( get_pathfinding_cache_ref( f.z ), line_path, pre_closed ) ) {
+            return line_path;
         }
     }
 
@@ -217,6 +769,25 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         return ret;
     }
 
+    // Long routes are planned over the cluster graph first and then refined locally.
+    // If that doesn't produce a route (closed doors, bashing, pre_closed squares...),
+    // fall back to a full search.
+    if( f.z == t.z && rl_dist( f, t ) > hierarchical_route_min_dist ) {
+        ret = route_hierarchical( f, t, settings, pre_closed );
+        if( !ret.empty() ) {
+            return ret;
+        }
+    }
+
+    return route_astar( f, t, settings, pre_closed );
+}
+
+std::vector<tripoint> map::route_astar( const tripoint &f, const tripoint &t,
+                                        const pathfinding_settings &settings,
+                                        const std::set<tripoint> &pre_closed ) const
+{
+    std::vector<tripoint> ret;
+
     int max_length = settings.max_length;
     int bash = settings.bash_strength;
     int climb_cost = settings.climb_cost;
@@ -2,7 +2,12 @@
 #ifndef CATA_SRC_PATHFINDING_H
 #define CATA_SRC_PATHFINDING_H
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include "game_constants.h"
+#include "point.h"
 
 enum pf_special : int {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -38,6 +43,30 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
+/**
+ * Abstract graph over one z-level of the pathfinding cache, used to plan long routes.
+ * Every submap is a cluster. Neighboring clusters are connected through portals placed
+ * on the open stretches of their shared edge, and the cost of walking between the
+ * entrances of a cluster is precomputed.
+ * Only clusters whose squares changed since the last update are rebuilt.
+ */
+struct pathfinding_cluster_graph {
+    struct cluster {
+        // Squares (in map coordinates) that have a portal to a neighboring cluster
+        std::vector<point> entrances;
+        // Squares on the other side of the portals of each entrance
+        std::vector<std::vector<point>> exits;
+        // entrances.size() squared walking costs between entrances, -1 if unreachable
+        std::vector<int> costs;
+    };
+
+    // Set when the pathfinding cache was rebuilt and the graph may be stale
+    bool dirty = true;
+    // Abstract movement cost of each square, 0 for impassable
+    uint8_t cost[MAPSIZE_X][MAPSIZE_Y] = {};
+    std::array<cluster, MAPSIZE *MAPSIZE> clusters;
+};
+
 struct pathfinding_cache {
     pathfinding_cache();
     ~pathfinding_cache();
@@ -45,6 +74,8 @@ struct pathfinding_cache {
     bool dirty = false;
 
     pf_special special[MAPSIZE_X][MAPSIZE_Y];
+
+    pathfinding_cluster_graph cluster_graph;
 };
 
 struct pathfinding_settings {
@@ -70,6 +101,44 @@ struct pathfinding_settings {
         : bash_strength( bs ), max_dist( md ), max_length( ml ), climb_cost( cc ),
           allow_open_doors( aod ), avoid_traps( at ), allow_climb_stairs( acs ), avoid_rough_terrain( art ),
           avoid_sharp( as ) {}
+
+    bool operator==( const pathfinding_settings &rhs ) const {
+        return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+               max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+               allow_open_doors == rhs.allow_open_doors && avoid_traps == rhs.avoid_traps &&
+               allow_climb_stairs == rhs.allow_climb_stairs &&
+               avoid_rough_terrain == rhs.avoid_rough_terrain && avoid_sharp == rhs.avoid_sharp;
+    }
+};
+
+/**
+ * Cost of walking from every square around a destination to it, for one set of pathfinding
+ * settings. It is computed once and shared by every creature heading for the same destination,
+ * so that each of them can read its next step instead of searching for a route.
+ */
+struct pathfinding_flow_field {
+    tripoint goal;
+    pathfinding_settings settings;
+    // Bounds of the field, inclusive
+    point min;
+    point max;
+    // Cost of walking onto each square, -1 if it can't be entered
+    std::vector<int> enter_cost;
+    // Cost of walking from each square to the goal, -1 if it is unreachable
+    std::vector<int> distance;
+
+    bool contains( const point &p ) const {
+        return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+    }
+    int index( const point &p ) const {
+        return ( p.x - min.x ) * ( max.y - min.y + 1 ) + ( p.y - min.y );
+    }
+    /** Cost of walking from p to the goal, -1 if p is unreachable or outside of the field. */
+    int distance_at( const point &p ) const {
+        return contains( p ) ? distance[index( p )] : -1;
+    }
+    /** Next square on the cheapest way from p to the goal, p itself if there is none. */
+    tripoint next_step( const tripoint &p ) const;
 };
 
 #endif // CATA_SRC_PATHFINDING_H
@@ -10,13 +10,13 @@
 unsigned int rng_bits()
 {
     // Whole uint range.
-    static std::uniform_int_distribution<unsigned int> rng_uint_dist;
+    static thread_local std::uniform_int_distribution<unsigned int> rng_uint_dist;
     return rng_uint_dist( rng_get_engine() );
 }
 
 int rng( int lo, int hi )
 {
-    static std::uniform_int_distribution<int> rng_int_dist;
+    static thread_local std::uniform_int_distribution<int> rng_int_dist;
     if( lo > hi ) {
         std::swap( lo, hi );
     }
@@ -25,7 +25,7 @@ int rng( int lo, int hi )
 
 double rng_float( double lo, double hi )
 {
-    static std::uniform_real_distribution<double> rng_real_dist;
+    static thread_local std::uniform_real_distribution<double> rng_real_dist;
     if( lo > hi ) {
         std::swap( lo, hi );
     }
@@ -34,13 +34,16 @@ double rng_float( double lo, double hi )
 
 double normal_roll( double mean, double stddev )
 {
-    static std::normal_distribution<double> rng_normal_dist;
+    static thread_local std::normal_distribution<double> rng_normal_dist;
+    // The distribution keeps the second value of each pair it generates. Dropping it makes
+    // the roll depend only on the engine, which scoped_rng_engine relies on.
+    rng_normal_dist.reset();
     return rng_normal_dist( rng_get_engine(), std::normal_distribution<>::param_type( mean, stddev ) );
 }
 
 double exponential_roll( double lambda )
 {
-    static std::exponential_distribution<double> rng_exponential_dist;
+    static thread_local std::exponential_distribution<double> rng_exponential_dist;
     return rng_exponential_dist( rng_get_engine(),
                                  std::exponential_distribution<>::param_type( lambda ) );
 }
@@ -121,8 +124,14 @@ double rng_normal( double lo, double hi )
     return clamp( val, lo, hi );
 }
 
+// Engine of the innermost scoped_rng_engine on this thread, if any.
+static thread_local cata_default_random_engine *scoped_engine = nullptr;
+
 cata_default_random_engine &rng_get_engine()
 {
+    if( scoped_engine != nullptr ) {
+        return *scoped_engine;
+    }
     // NOLINTNEXTLINE(cata-determinism)
     static cata_default_random_engine eng(
         std::chrono::high_resolution_clock::now().time_since_epoch().count() );
@@ -135,3 +144,14 @@ void rng_set_engine_seed( unsigned int seed )
         rng_get_engine().seed( seed );
     }
 }
+
+scoped_rng_engine::scoped_rng_engine( unsigned int seed ) : engine( seed ),
+    previous( scoped_engine )
+{
+    scoped_engine = &engine;
+}
+
+scoped_rng_engine::~scoped_rng_engine()
+{
+    scoped_engine = previous;
+}
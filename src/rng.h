@@ -25,6 +25,26 @@ void rng_set_engine_seed( unsigned int seed );
 
 using cata_default_random_engine = std::minstd_rand0;
 cata_default_random_engine &rng_get_engine();
+
+/**
+ * While an instance is alive, the PRNG functions called on the creating thread draw from
+ * an engine seeded with @p seed instead of the shared one. The results then only depend on
+ * that seed, not on how far the shared engine has advanced or which thread does the work.
+ * Instances nest and must be destroyed on the thread that created them.
+ */
+class scoped_rng_engine
+{
+    public:
+        explicit scoped_rng_engine( unsigned int seed );
+        ~scoped_rng_engine();
+        scoped_rng_engine( const scoped_rng_engine & ) = delete;
+        scoped_rng_engine &operator=( const scoped_rng_engine & ) = delete;
+
+    private:
+        cata_default_random_engine engine;
+        cata_default_random_engine *previous;
+};
+
 unsigned int rng_bits();
 
 int rng( int lo, int hi );
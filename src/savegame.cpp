@@ -603,6 +603,7 @@ void overmap::unserialize( std::istream &fin )
                     new_npc->set_fac( new_npc->get_fac_id() );
                 }
                 npcs.push_back( new_npc );
+                add_to_npc_cells( new_npc );
             }
         } else if( name == "camps" ) {
             jsin.start_array();
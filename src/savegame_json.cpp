@@ -101,6 +101,7 @@
 #include "stomach.h"
 #include "string_id.h"
 #include "submap.h"
+#include "submap_quad.h"
 #include "text_snippets.h"
 #include "tileray.h"
 #include "units.h"
@@ -194,6 +195,7 @@ void item_contents::deserialize( JsonIn &jsin )
 {
     JsonObject data = jsin.get_object();
     data.read( "contents", contents );
+    pocket_changes++;
 }
 
 void item_pocket::serialize( JsonOut &json ) const
@@ -3765,52 +3767,18 @@ void stats_tracker::deserialize( JsonIn &jsin )
 }
 
 void submap::store( JsonOut &jsout ) const
+{
+    submap_record layers;
+    layers.set_layers( *this );
+    layers.store_layers( jsout );
+    store_contents( jsout );
+}
+
+void submap::store_contents( JsonOut &jsout ) const
 {
     jsout.member( "turn_last_touched", last_touched );
     jsout.member( "temperature", temperature );
 
-    // Terrain is saved using a simple RLE scheme.  Legacy saves don't have
-    // this feature but the algorithm is backward compatible.
-    jsout.member( "terrain" );
-    jsout.start_array();
-    std::string last_id;
-    int num_same = 1;
-    for( int j = 0; j < SEEY; j++ ) {
-        // NOLINTNEXTLINE(modernize-loop-convert)
-        for( int i = 0; i < SEEX; i++ ) {
-            const std::string this_id = ter[i][j].obj().id.str();
-            if( !last_id.empty() ) {
-                if( this_id == last_id ) {
-                    num_same++;
-                } else {
-                    if( num_same == 1 ) {
-                        // if there's only one element don't write as an array
-                        jsout.write( last_id );
-                    } else {
-                        jsout.start_array();
-                        jsout.write( last_id );
-                        jsout.write( num_same );
-                        jsout.end_array();
-                        num_same = 1;
-                    }
-                    last_id = this_id;
-                }
-            } else {
-                last_id = this_id;
-            }
-        }
-    }
-    // Because of the RLE scheme we have to do one last pass
-    if( num_same == 1 ) {
-        jsout.write( last_id );
-    } else {
-        jsout.start_array();
-        jsout.write( last_id );
-        jsout.write( num_same );
-        jsout.end_array();
-    }
-    jsout.end_array();
-
     // Write out the radiation array in a simple RLE scheme.
     // written in intensity, count pairs
     jsout.member( "radiation" );
@@ -3837,23 +3805,6 @@ void submap::store( JsonOut &jsout ) const
     jsout.write( count );
     jsout.end_array();
 
-    jsout.member( "furniture" );
-    jsout.start_array();
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            const point p( i, j );
-            // Save furniture
-            if( get_furn( p ) ) {
-                jsout.start_array();
-                jsout.write( p.x );
-                jsout.write( p.y );
-                jsout.write( get_furn( p ).obj().id );
-                jsout.end_array();
-            }
-        }
-    }
-    jsout.end_array();
-
     jsout.member( "items" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -3868,24 +3819,6 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
-    jsout.member( "traps" );
-    jsout.start_array();
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            const point p( i, j );
-            // Save traps
-            if( get_trap( p ) ) {
-                jsout.start_array();
-                jsout.write( p.x );
-                jsout.write( p.y );
-                // TODO: jsout should support writing an id like jsout.write( trap_id )
-                jsout.write( get_trap( p ).id().str() );
-                jsout.end_array();
-            }
-        }
-    }
-    jsout.end_array();
-
     jsout.member( "fields" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -4062,7 +3995,7 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version )
             int rad_num = jsin.get_int();
             for( int i = 0; i < rad_num; ++i ) {
                 if( rad_cell < SEEX * SEEY ) {
-                    set_radiation( { 0 % SEEX, rad_cell / SEEX }, rad_strength );
+                    set_radiation( { rad_cell % SEEX, rad_cell / SEEX }, rad_strength );
                     rad_cell++;
                 }
             }
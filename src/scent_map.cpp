@@ -14,6 +14,7 @@
 #include "map.h"
 #include "output.h"
 #include "string_id.h"
+#include "turn_profiler.h"
 
 static constexpr int SCENT_RADIUS = 40;
 
@@ -154,6 +155,7 @@ bool scent_map::inbounds( const point &p ) const
 
 void scent_map::update( const tripoint &center, map &m )
 {
+    TURN_PROFILER_ZONE( "scent_map::update" );
     // Stop updating scent after X turns of the player not moving.
     // Once wind is added, need to reset this on wind shifts as well.
     if( !player_last_position || center != *player_last_position ) {
@@ -163,13 +165,16 @@ void scent_map::update( const tripoint &center, map &m )
         return;
     }
 
-    // note: the next four intermediate matrices need to be at least
+    // note: the intermediate matrices need to be at least
     // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
     // The code I'm modifying used [MAPSIZE_X]. I'm staying with that to avoid new bugs.
 
-    // These two matrices are transposed so that x addresses are contiguous in memory
+    // All of them are indexed [x][y] like grscent, so the inner loops below walk along y through
+    // contiguous memory without branches and the compiler can vectorize them.
     scent_array<int> sum_3_scent_y;
     scent_array<int> squares_used_y;
+    // How much of a square takes part in diffusion: 0 if it blocks scent, else 2 or 10 (of 10)
+    scent_array<int> weight;
 
     // these are for caching flag lookups
     scent_array<bool> blocks_scent; // currently only TFLAG_NO_SCENT blocks scent
@@ -188,6 +193,10 @@ void scent_map::update( const tripoint &center, map &m )
     // The new scent flag searching function. Should be wayyy faster than the old one.
     m.scent_blockers( blocks_scent, reduces_scent, point( scentmap_minx - 1, scentmap_miny - 1 ),
                       point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+
+    // First and last y with any scent in each column, first > last if there is none.
+    std::array<int, MAPSIZE_X> first_scent_y;
+    std::array<int, MAPSIZE_X> last_scent_y;
     // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
     // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
     // is a net performance improvement over the old code. Could probably still be better.
@@ -195,59 +204,82 @@ void scent_map::update( const tripoint &center, map &m )
     // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
     // MAPSIZE_X, but if that changes, this may need tweaking.
     for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        const std::array<int, MAPSIZE_Y> &scent = grscent[x];
+        std::array<int, MAPSIZE_Y> &w = weight[x];
+        for( int y = scentmap_miny - 1; y <= scentmap_maxy + 1; ++y ) {
+            // only 20% of scent can diffuse on REDUCE_SCENT squares
+            w[y] = blocks_scent[x][y] ? 0 : reduces_scent[x][y] ? 2 : 10;
+        }
+        std::array<int, MAPSIZE_Y> &used = squares_used_y[x];
         for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = y - 1; i <= y + 1; ++i ) {
-                if( !blocks_scent[x][i] ) {
-                    if( reduces_scent[x][i] ) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
+            used[y] = w[y - 1] + w[y] + w[y + 1];
+        }
+
+        int first = scentmap_miny - 1;
+        while( first <= scentmap_maxy + 1 && scent[first] == 0 ) {
+            ++first;
+        }
+        if( first > scentmap_maxy + 1 ) {
+            // Nothing to sum, the rest of the scent map won't look at this column.
+            first_scent_y[x] = scentmap_maxy + 2;
+            last_scent_y[x] = scentmap_miny - 2;
+            continue;
+        }
+        int last = scentmap_maxy + 1;
+        while( scent[last] == 0 ) {
+            --last;
+        }
+        first_scent_y[x] = first;
+        last_scent_y[x] = last;
+        // remember the sum of the scent val for the 3 neighboring squares that can defuse into
+        std::array<int, MAPSIZE_Y> &sum = sum_3_scent_y[x];
+        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+            sum[y] = w[y - 1] * scent[y - 1] + w[y] * scent[y] + w[y + 1] * scent[y + 1];
         }
     }
 
+    // Columns without scent add nothing to their neighbors.
+    static const std::array<int, MAPSIZE_Y> no_scent{};
+    const auto scent_sum = [&]( const int x ) -> const std::array<int, MAPSIZE_Y> & {
+        return first_scent_y[x] > last_scent_y[x] ? no_scent : sum_3_scent_y[x];
+    };
+
     // Rest of the scent map
     for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            int &scent_here = grscent[x][y];
-            if( !blocks_scent[x][y] ) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                const int squares_used = squares_used_y[y][x - 1]
-                                         + squares_used_y[y][x]
-                                         + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if( !reduces_scent[x][y] ) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                // take the old scent and subtract what diffuses out
-                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
-                // neighboring REDUCE_SCENT squares absorb some scent
-                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                scent_here =
-                    ( temp_scent
-                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
-                                             + sum_3_scent_y[y][x]
-                                             + sum_3_scent_y[y][x + 1] )
-                    ) / ( 1000 * 10 );
-            } else {
-                // this cell blocks scent via NO_SCENT (in json)
-                scent_here = 0;
-            }
+        // Only squares next to some scent can change, the others stay at 0.
+        const int first = std::max( scentmap_miny, std::min( { first_scent_y[x - 1], first_scent_y[x],
+                                    first_scent_y[x + 1]
+                                                             } ) - 1 );
+        const int last = std::min( scentmap_maxy, std::max( { last_scent_y[x - 1], last_scent_y[x],
+                                   last_scent_y[x + 1]
+                                                            } ) + 1 );
+        const std::array<int, MAPSIZE_Y> &used_left = squares_used_y[x - 1];
+        const std::array<int, MAPSIZE_Y> &used_here = squares_used_y[x];
+        const std::array<int, MAPSIZE_Y> &used_right = squares_used_y[x + 1];
+        const std::array<int, MAPSIZE_Y> &sum_left = scent_sum( x - 1 );
+        const std::array<int, MAPSIZE_Y> &sum_here = scent_sum( x );
+        const std::array<int, MAPSIZE_Y> &sum_right = scent_sum( x + 1 );
+        const std::array<bool, MAPSIZE_Y> &blocks = blocks_scent[x];
+        const std::array<bool, MAPSIZE_Y> &reduces = reduces_scent[x];
+        std::array<int, MAPSIZE_Y> &scent = grscent[x];
+        for( int y = first; y <= last; ++y ) {
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares_used = used_left[y] + used_here[y] + used_right[y];
+            //less air movement for REDUCE_SCENT square
+            const int this_diffusivity = reduces[y] ? diffusivity / 5 : diffusivity;
+            const int scent_here = scent[y];
+            // take the old scent and subtract what diffuses out
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            // neighboring REDUCE_SCENT squares absorb some scent
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            // we've already summed neighboring scent values in the y direction in the previous
+            // loop. Now we do it for the x direction, multiply by diffusion, and this is what
+            // diffuses into our current square.
+            const int diffused = ( temp_scent + this_diffusivity *
+                                   ( sum_left[y] + sum_here[y] + sum_right[y] ) ) / ( 1000 * 10 );
+            // a cell that blocks scent via NO_SCENT (in json) has none
+            scent[y] = blocks[y] ? 0 : diffused;
         }
     }
 }
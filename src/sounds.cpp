@@ -16,6 +16,7 @@
 #include "character.h"
 #include "coordinate_conversions.h"
 #include "creature.h"
+#include "creature_tracker.h"
 #include "debug.h"
 #include "effect.h"
 #include "enums.h"
@@ -39,6 +40,7 @@
 #include "string_formatter.h"
 #include "string_id.h"
 #include "translations.h"
+#include "turn_profiler.h"
 #include "type_id.h"
 #include "units.h"
 #include "value_ptr.h"
@@ -301,6 +303,7 @@ static int get_signal_for_hordes( const centroid &centr )
 
 void sounds::process_sounds()
 {
+    TURN_PROFILER_ZONE( "sounds::process_sounds" );
     std::vector<centroid> sound_clusters = cluster_sounds( recent_sounds );
     const int weather_vol = get_weather().weather_id->sound_attn;
     for( const auto &this_centroid : sound_clusters ) {
@@ -321,12 +324,19 @@ void sounds::process_sounds()
             overmap_buffer.signal_hordes( target, sig_power );
         }
         // Alert all monsters (that can hear) to the sound.
-        for( monster &critter : g->all_monsters() ) {
+        // Monsters at a sound_distance of vol * 2 or more won't hear it, that distance
+        // is at least the horizontal distance and five times the vertical one.
+        const int max_dist = vol * 2 - 1;
+        if( max_dist < 0 ) {
+            continue;
+        }
+        for( monster *critter : g->critter_tracker->find_in_radius( source, max_dist,
+                max_dist / 5 ) ) {
             // TODO: Generalize this to Creature::hear_sound
-            const int dist = sound_distance( source, critter.pos() );
+            const int dist = sound_distance( source, critter->pos() );
             if( vol * 2 > dist ) {
                 // Exclude monsters that certainly won't hear the sound
-                critter.hear_sound( source, vol, dist );
+                critter->hear_sound( source, vol, dist );
             }
         }
     }
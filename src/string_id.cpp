@@ -0,0 +1,19 @@
+#include "string_id.h"
+
+#include <mutex>
+#include <unordered_map>
+
+const interned_id_string &intern_id_string( const std::string &id )
+{
+    // Never destroyed: ids in other static objects may still be used while the program exits.
+    static std::unordered_map<std::string, int> &table = *new std::unordered_map<std::string, int>();
+    static std::mutex table_mutex;
+
+    std::lock_guard<std::mutex> lock( table_mutex );
+    const auto iter = table.find( id );
+    if( iter != table.end() ) {
+        return *iter;
+    }
+    // Nodes of an unordered_map don't move when it rehashes, so the returned reference stays valid.
+    return *table.emplace( id, static_cast<int>( table.size() ) ).first;
+}
@@ -2,14 +2,36 @@
 #ifndef CATA_SRC_STRING_ID_H
 #define CATA_SRC_STRING_ID_H
 
+#include <atomic>
+#include <cstddef>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 template<typename T>
 class int_id;
 
 /**
- * This represents an identifier (implemented as std::string) of some object.
+ * Entry of the global id string table: the id string and its index in the table.
+ * Each distinct string is stored exactly once (shared by all id types) and entries are never
+ * removed, so two ids have the same string if and only if they point to the same entry.
+ */
+using interned_id_string = std::pair<const std::string, int>;
+/**
+ * Returns the table entry for @p id, adding it if it's not in the table yet.
+ * Safe to call from any thread.
+ */
+const interned_id_string &intern_id_string( const std::string &id );
+/** Table entry of the empty string, used by default constructed ids. */
+inline const interned_id_string &empty_id_string()
+{
+    static const interned_id_string &empty = intern_id_string( std::string() );
+    return empty;
+}
+
+/**
+ * This represents an identifier (implemented as a pointer into the global table of interned
+ * id strings, see @ref intern_id_string) of some object.
  * It can be used for all type of objects, one just needs to specify a type as
  * template parameter T, which separates the different identifier types.
  *
@@ -49,35 +71,49 @@ class string_id
         /**
          * Forwarding constructor, forwards any parameter to the std::string
          * constructor to create the id string. This allows plain C-strings,
-         * and std::strings to be used.
+         * and std::strings to be used. The string is looked up in the global
+         * table once here, so keep ids around instead of constructing them
+         * again from the same string in hot code.
          */
         // Beautiful C++11: enable_if makes sure that S is always something that can be used to constructor
         // a std::string, otherwise a "no matching function to call..." error is generated.
         template<typename S, class = typename
                  std::enable_if< std::is_convertible<S, std::string >::value>::type >
-        explicit string_id( S && id, int cid = -1 ) : _id( std::forward<S>( id ) ), _cid( cid ) {
+        explicit string_id( S && id, int cid = -1 ) :
+            _id( &intern_id_string( std::forward<S>( id ) ) ), _cid( cid ) {
         }
         /**
          * Default constructor constructs an empty id string.
          * Note that this id class does not enforce empty id strings (or any specific string at all)
          * to be special. Every string (including the empty one) may be a valid id.
          */
-        string_id() : _cid( -1 ) {}
+        string_id() : _id( &empty_id_string() ), _cid( -1 ) {}
+        string_id( const string_id &other ) : _id( other._id ), _cid( other._cid.load(
+                        std::memory_order_relaxed ) ) {}
+        string_id &operator=( const string_id &other ) {
+            _id = other._id;
+            _cid.store( other._cid.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+            return *this;
+        }
         /**
          * Comparison, only useful when the id is used in std::map or std::set as key. Compares
-         * the string id as with the strings comparison.
+         * the string id as with the strings comparison, so the iteration order of containers
+         * (and therefore of saves and lists in the UI) doesn't depend on the order in which
+         * the strings were interned.
          */
         bool operator<( const This &rhs ) const {
-            return _id < rhs._id;
+            return _id != rhs._id && _id->first < rhs._id->first;
         }
         /**
-         * The usual comparator, compares the string id as usual.
+         * The usual comparator. Equal strings share the same table entry, so this only
+         * compares pointers.
          */
         bool operator==( const This &rhs ) const {
             return _id == rhs._id;
         }
         /**
-         * The usual comparator, compares the string id as usual.
+         * The usual comparator. Equal strings share the same table entry, so this only
+         * compares pointers.
          */
         bool operator!=( const This &rhs ) const {
             return _id != rhs._id;
@@ -88,7 +124,7 @@ class string_id
          * to be included in the format string, e.g. debugmsg("invalid id: %s", id.c_str())
          */
         const char *c_str() const {
-            return _id.c_str();
+            return _id->first.c_str();
         }
         /**
          * Returns the identifier as plain std::string. Use with care, the plain string does not
@@ -96,11 +132,18 @@ class string_id
          * the class).
          */
         const std::string &str() const {
-            return _id;
+            return _id->first;
         }
 
         explicit operator std::string() const {
-            return _id;
+            return _id->first;
+        }
+        /**
+         * Index of the id string in the global table. It's the same for all ids with the same
+         * string and is only meant for hashing, it's not stable between program runs.
+         */
+        int interned_index() const {
+            return _id->second;
         }
 
         // Those are optional, you need to implement them on your own if you want to use them.
@@ -133,7 +176,7 @@ class string_id
          * keep consistency with the rest is_.. functions
          */
         bool is_empty() const {
-            return _id.empty();
+            return _id == &empty_id_string();
         }
         /**
          * Returns a null id whose `string_id<T>::is_null()` must always return true. See @ref is_null.
@@ -177,27 +220,31 @@ class string_id
          * Assigns a new value for the cached int id.
          */
         void set_cid( const int_id<T> &cid ) const {
-            _cid = cid.to_i();
+            _cid.store( cid.to_i(), std::memory_order_relaxed );
         }
         /**
          * Returns the current value of cached id
          */
         int_id<T> get_cid() const {
-            return int_id<T>( _cid );
+            return int_id<T>( _cid.load( std::memory_order_relaxed ) );
         }
 
     private:
-        std::string _id;
-        mutable int _cid;
+        const interned_id_string *_id;
+        /**
+         * Index of the object in its factory, a guess that the factory checks before using it.
+         * Written lazily by lookups, possibly on several threads at once, hence atomic.
+         */
+        mutable std::atomic<int> _cid;
 };
 
-// Support hashing of string based ids by forwarding the hash of the string.
+// Support hashing of string based ids by hashing the index of the interned string.
 namespace std
 {
 template<typename T>
 struct hash< string_id<T> > {
     std::size_t operator()( const string_id<T> &v ) const noexcept {
-        return hash<std::string>()( v.str() );
+        return hash<int>()( v.interned_index() );
     }
 };
 } // namespace std
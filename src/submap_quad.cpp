@@ -0,0 +1,430 @@
+#include "submap_quad.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+#include "compress.h"
+#include "int_id.h"
+#include "json.h"
+#include "mapdata.h"
+#include "string_id.h"
+#include "submap.h"
+#include "trap.h"
+
+static const std::string binary_magic = "CDDAQUAD";
+static constexpr uint64_t binary_format_version = 1;
+// Older submaps need their terrain migrated while loading, see submap::load
+static constexpr int min_layer_version = 22;
+
+static const std::string null_terrain = "t_null";
+static const std::string null_furniture = "f_null";
+static const std::string null_trap = "tr_null";
+
+namespace
+{
+// Looks up the ids of one layer in the dictionary, each of them only once
+template<typename T>
+class layer_ids
+{
+    public:
+        explicit layer_ids( const std::vector<std::string> &dictionary ) :
+            dictionary( dictionary ), ids( dictionary.size() ), known( dictionary.size(), false ) {}
+
+        const int_id<T> &operator[]( const uint16_t index ) {
+            if( !known[index] ) {
+                ids[index] = string_id<T>( dictionary[index] ).id();
+                known[index] = true;
+            }
+            return ids[index];
+        }
+
+    private:
+        const std::vector<std::string> &dictionary;
+        std::vector<int_id<T>> ids;
+        std::vector<bool> known;
+};
+} // namespace
+
+submap_record::submap_record( const submap &sm, const tripoint &coordinates, const int version )
+    : coordinates( coordinates ), version( version )
+{
+    set_layers( sm );
+
+    std::ostringstream buffer;
+    JsonOut jsout( buffer );
+    jsout.start_object();
+    sm.store_contents( jsout );
+    jsout.end_object();
+    contents = buffer.str();
+}
+
+void submap_record::set_layers( const submap &sm )
+{
+    dictionary.clear();
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            const size_t index = i + j * SEEX;
+            terrain[index] = index_of( sm.get_ter( p ).id().str() );
+            furniture[index] = index_of( sm.get_furn( p ).id().str() );
+            traps[index] = index_of( sm.get_trap( p ).id().str() );
+        }
+    }
+}
+
+uint16_t submap_record::index_of( const std::string &id )
+{
+    for( size_t i = 0; i < dictionary.size(); i++ ) {
+        if( dictionary[i] == id ) {
+            return static_cast<uint16_t>( i );
+        }
+    }
+    dictionary.push_back( id );
+    return static_cast<uint16_t>( dictionary.size() - 1 );
+}
+
+void submap_record::apply( submap &sm ) const
+{
+    static const trap_str_id tr_brazier( "tr_brazier" );
+    static const furn_str_id f_brazier( "f_brazier" );
+
+    layer_ids<ter_t> ter_ids( dictionary );
+    layer_ids<furn_t> furn_ids( dictionary );
+    layer_ids<trap> trap_ids( dictionary );
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            const size_t index = i + j * SEEX;
+            sm.set_ter( p, ter_ids[terrain[index]] );
+            sm.set_furn( p, furn_ids[furniture[index]] );
+            // TODO: remove brazier trap-to-furniture conversion after 0.D
+            if( dictionary[traps[index]] == tr_brazier.str() ) {
+                sm.set_furn( p, f_brazier.id() );
+            } else {
+                sm.set_trap( p, trap_ids[traps[index]] );
+            }
+        }
+    }
+
+    std::istringstream buffer( contents );
+    JsonIn jsin( buffer );
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        const std::string member_name = jsin.get_member_name();
+        sm.load( jsin, member_name, version );
+    }
+}
+
+bool submap_record::load_layer( JsonIn &jsin, const std::string &member_name )
+{
+    if( member_name == "terrain" ) {
+        if( version < min_layer_version ) {
+            throw std::runtime_error( "submap terrain of version " + std::to_string( version ) +
+                                      " has to be migrated by the game" );
+        }
+        // Same simple RLE scheme as submap::load
+        jsin.start_array();
+        int remaining = 0;
+        uint16_t id = 0;
+        for( uint16_t &cell : terrain ) {
+            if( !remaining ) {
+                if( jsin.test_array() ) {
+                    jsin.start_array();
+                    id = index_of( jsin.get_string() );
+                    remaining = jsin.get_int() - 1;
+                    jsin.end_array();
+                } else {
+                    id = index_of( jsin.get_string() );
+                }
+            } else {
+                --remaining;
+            }
+            cell = id;
+        }
+        if( remaining || !jsin.end_array() ) {
+            jsin.error( "terrain data is corrupt, tile data remaining" );
+        }
+    } else if( member_name == "furniture" || member_name == "traps" ) {
+        layer &target = member_name == "furniture" ? furniture : traps;
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            jsin.start_array();
+            const int i = jsin.get_int();
+            const int j = jsin.get_int();
+            if( i < 0 || i >= SEEX || j < 0 || j >= SEEY ) {
+                jsin.error( "position out of bounds" );
+            }
+            target[i + j * SEEX] = index_of( jsin.get_string() );
+            jsin.end_array();
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void submap_record::store_layers( JsonOut &jsout ) const
+{
+    // Terrain is saved using a simple RLE scheme.  Legacy saves don't have
+    // this feature but the algorithm is backward compatible.
+    jsout.member( "terrain" );
+    jsout.start_array();
+    for( size_t index = 0; index < terrain.size(); ) {
+        size_t num_same = 1;
+        while( index + num_same < terrain.size() && terrain[index + num_same] == terrain[index] ) {
+            num_same++;
+        }
+        if( num_same == 1 ) {
+            // if there's only one element don't write as an array
+            jsout.write( dictionary[terrain[index]] );
+        } else {
+            jsout.start_array();
+            jsout.write( dictionary[terrain[index]] );
+            jsout.write( num_same );
+            jsout.end_array();
+        }
+        index += num_same;
+    }
+    jsout.end_array();
+
+    const auto store_sparse = [&]( const std::string & name, const layer & cells,
+    const std::string & null_id ) {
+        jsout.member( name );
+        jsout.start_array();
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                const std::string &id = dictionary[cells[i + j * SEEX]];
+                if( id != null_id ) {
+                    jsout.start_array();
+                    jsout.write( i );
+                    jsout.write( j );
+                    jsout.write( id );
+                    jsout.end_array();
+                }
+            }
+        }
+        jsout.end_array();
+    };
+    store_sparse( "furniture", furniture, null_furniture );
+    store_sparse( "traps", traps, null_trap );
+}
+
+static void write_signed( std::string &out, const int64_t value )
+{
+    // Zigzag encoding, so that small negative numbers stay small
+    write_varint( out, ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 ) );
+}
+
+static int64_t read_signed( const std::string &in, size_t &pos )
+{
+    const uint64_t value = read_varint( in, pos );
+    return static_cast<int64_t>( value >> 1 ) ^ -static_cast<int64_t>( value & 1 );
+}
+
+static void write_string( std::string &out, const std::string &str )
+{
+    write_varint( out, str.size() );
+    out += str;
+}
+
+static std::string read_string( const std::string &in, size_t &pos )
+{
+    const uint64_t size = read_varint( in, pos );
+    if( size > in.size() - pos ) {
+        throw std::runtime_error( "quad data is corrupt, string out of bounds" );
+    }
+    std::string result = in.substr( pos, size );
+    pos += size;
+    return result;
+}
+
+static void write_layer( std::string &out, const submap_record::layer &cells )
+{
+    for( size_t index = 0; index < cells.size(); ) {
+        size_t run = 1;
+        while( index + run < cells.size() && cells[index + run] == cells[index] ) {
+            run++;
+        }
+        write_varint( out, cells[index] );
+        write_varint( out, run );
+        index += run;
+    }
+}
+
+static void read_layer( const std::string &in, size_t &pos, submap_record::layer &cells,
+                        const size_t dictionary_size )
+{
+    for( size_t index = 0; index < cells.size(); ) {
+        const uint64_t id = read_varint( in, pos );
+        const uint64_t run = read_varint( in, pos );
+        if( id >= dictionary_size || run == 0 || run > cells.size() - index ) {
+            throw std::runtime_error( "quad data is corrupt, invalid layer" );
+        }
+        std::fill_n( cells.begin() + index, run, static_cast<uint16_t>( id ) );
+        index += run;
+    }
+}
+
+namespace quad_file
+{
+
+bool is_binary( const std::string &data )
+{
+    return data.compare( 0, binary_magic.size(), binary_magic ) == 0;
+}
+
+std::string write_binary( const std::vector<submap_record> &records )
+{
+    std::string payload;
+    write_varint( payload, records.size() );
+    for( const submap_record &rec : records ) {
+        write_signed( payload, rec.coordinates.x );
+        write_signed( payload, rec.coordinates.y );
+        write_signed( payload, rec.coordinates.z );
+        write_signed( payload, rec.version );
+        write_varint( payload, rec.dictionary.size() );
+        for( const std::string &id : rec.dictionary ) {
+            write_string( payload, id );
+        }
+        write_layer( payload, rec.terrain );
+        write_layer( payload, rec.furniture );
+        write_layer( payload, rec.traps );
+        write_string( payload, rec.contents );
+    }
+
+    std::string result = binary_magic;
+    write_varint( result, binary_format_version );
+    result += compress_lz( payload );
+    return result;
+}
+
+std::vector<submap_record> read_binary( const std::string &data )
+{
+    if( !is_binary( data ) ) {
+        throw std::runtime_error( "not a binary quad" );
+    }
+    size_t pos = binary_magic.size();
+    const uint64_t format_version = read_varint( data, pos );
+    if( format_version != binary_format_version ) {
+        throw std::runtime_error( "unknown binary quad format version " +
+                                  std::to_string( format_version ) );
+    }
+    const std::string payload = decompress_lz( data.substr( pos ) );
+
+    pos = 0;
+    std::vector<submap_record> records( read_varint( payload, pos ) );
+    for( submap_record &rec : records ) {
+        rec.coordinates.x = read_signed( payload, pos );
+        rec.coordinates.y = read_signed( payload, pos );
+        rec.coordinates.z = read_signed( payload, pos );
+        rec.version = read_signed( payload, pos );
+        const uint64_t dictionary_size = read_varint( payload, pos );
+        if( dictionary_size > 3 * SEEX * SEEY ) {
+            throw std::runtime_error( "quad data is corrupt, dictionary too large" );
+        }
+        for( uint64_t i = 0; i < dictionary_size; i++ ) {
+            rec.dictionary.push_back( read_string( payload, pos ) );
+        }
+        read_layer( payload, pos, rec.terrain, dictionary_size );
+        read_layer( payload, pos, rec.furniture, dictionary_size );
+        read_layer( payload, pos, rec.traps, dictionary_size );
+        rec.contents = read_string( payload, pos );
+    }
+    if( pos != payload.size() ) {
+        throw std::runtime_error( "quad data is corrupt, trailing data" );
+    }
+    return records;
+}
+
+std::string write_json( const std::vector<submap_record> &records )
+{
+    std::string result = "[";
+    for( const submap_record &rec : records ) {
+        if( result.size() > 1 ) {
+            result += ',';
+        }
+        std::ostringstream buffer;
+        JsonOut jsout( buffer );
+        jsout.start_object();
+        jsout.member( "version", rec.version );
+        jsout.member( "coordinates" );
+        jsout.start_array();
+        jsout.write( rec.coordinates.x );
+        jsout.write( rec.coordinates.y );
+        jsout.write( rec.coordinates.z );
+        jsout.end_array();
+        rec.store_layers( jsout );
+        jsout.end_object();
+
+        // Splice the other members into the object
+        std::string object = buffer.str();
+        object.pop_back();
+        if( rec.contents.size() > 2 ) {
+            object += ',';
+            object.append( rec.contents, 1, std::string::npos );
+        } else {
+            object += '}';
+        }
+        result += object;
+    }
+    result += ']';
+    return result;
+}
+
+std::vector<submap_record> read_json( const std::string &data )
+{
+    std::vector<submap_record> records;
+    std::istringstream buffer( data );
+    JsonIn jsin( buffer );
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        submap_record rec;
+        rec.terrain.fill( rec.index_of( null_terrain ) );
+        rec.furniture.fill( rec.index_of( null_furniture ) );
+        rec.traps.fill( rec.index_of( null_trap ) );
+        rec.contents = "{";
+        jsin.start_object();
+        while( !jsin.end_object() ) {
+            const std::string member_name = jsin.get_member_name();
+            if( member_name == "version" ) {
+                rec.version = jsin.get_int();
+            } else if( member_name == "coordinates" ) {
+                jsin.start_array();
+                rec.coordinates.x = jsin.get_int();
+                rec.coordinates.y = jsin.get_int();
+                rec.coordinates.z = jsin.get_int();
+                jsin.end_array();
+            } else if( !rec.load_layer( jsin, member_name ) ) {
+                // Copied verbatim, the game will parse it
+                jsin.eat_whitespace();
+                const int start = jsin.tell();
+                jsin.skip_value();
+                std::string value = data.substr( start, jsin.tell() - start );
+                // Drop the separator skip_value eats after the value
+                while( !value.empty() && ( value.back() == ',' || std::isspace( value.back() ) ) ) {
+                    value.pop_back();
+                }
+                if( rec.contents.size() > 1 ) {
+                    rec.contents += ',';
+                }
+                rec.contents += "\"" + member_name + "\":" + value;
+            }
+        }
+        rec.contents += "}";
+        records.push_back( std::move( rec ) );
+    }
+    return records;
+}
+
+bool convert( std::string &data, const bool to_binary )
+{
+    if( is_binary( data ) == to_binary ) {
+        return false;
+    }
+    data = to_binary ? write_binary( read_json( data ) ) : write_json( read_binary( data ) );
+    return true;
+}
+
+} // namespace quad_file
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef CATA_SRC_SUBMAP_QUAD_H
+#define CATA_SRC_SUBMAP_QUAD_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game_constants.h"
+#include "point.h"
+
+class JsonIn;
+class JsonOut;
+class submap;
+
+/**
+ * One submap of a quad savefile (see @ref mapbuffer), in a form that can be read and written
+ * without the game data: the terrain, furniture and trap layers as indices into a dictionary
+ * of their ids, and everything else as a JSON object.
+ */
+struct submap_record {
+    using layer = std::array<uint16_t, SEEX * SEEY>;
+
+    tripoint coordinates;
+    int version = 0;
+    // Ids used by the layers below
+    std::vector<std::string> dictionary;
+    // Indices into dictionary, row by row
+    layer terrain;
+    layer furniture;
+    layer traps;
+    // All other members, see @ref submap::store_contents
+    std::string contents;
+
+    submap_record() = default;
+    submap_record( const submap &sm, const tripoint &coordinates, int version );
+
+    /** Takes the layers of sm, leaving the contents alone. */
+    void set_layers( const submap &sm );
+    /** Sets the layers and loads the contents of a freshly constructed submap. */
+    void apply( submap &sm ) const;
+
+    /**
+     * Reads a terrain, furniture or trap member of a JSON submap.
+     * @return false if member_name is not one of those.
+     */
+    bool load_layer( JsonIn &jsin, const std::string &member_name );
+    /** Writes the layers as the terrain, furniture and trap members of a JSON submap. */
+    void store_layers( JsonOut &jsout ) const;
+
+    // Index of id in dictionary, adding it if needed
+    uint16_t index_of( const std::string &id );
+};
+
+/**
+ * Quad savefiles come in two formats, the legacy JSON array of submap objects and a compact
+ * binary one. The binary format stores the layers run length encoded, and compresses the
+ * whole file with @ref compress_lz.
+ * All of these throw std::runtime_error (or JsonError) on malformed data.
+ */
+namespace quad_file
+{
+bool is_binary( const std::string &data );
+
+std::string write_binary( const std::vector<submap_record> &records );
+std::vector<submap_record> read_binary( const std::string &data );
+
+std::string write_json( const std::vector<submap_record> &records );
+/**
+ * Reads a JSON quad without the game data. Submaps saved before version 22 need
+ * their terrain migrated by the game, so they throw.
+ */
+std::vector<submap_record> read_json( const std::string &data );
+
+/**
+ * Converts a quad savefile to the binary format if to_binary is set, to JSON otherwise.
+ * @return false if data already is in that format.
+ */
+bool convert( std::string &data, bool to_binary );
+} // namespace quad_file
+
+#endif // CATA_SRC_SUBMAP_QUAD_H
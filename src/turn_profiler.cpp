@@ -0,0 +1,251 @@
+#include "turn_profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <thread>
+
+#include "cata_utility.h"
+#include "json.h"
+#include "path_info.h"
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+namespace
+{
+
+using profiler_clock = std::chrono::steady_clock;
+
+constexpr size_t no_parent = static_cast<size_t>( -1 );
+// Weight of the last turn in the moving averages, roughly the last 30 turns count.
+constexpr double average_weight = 1.0 / 32;
+// About 50 MB of events, or a few hours of play with the zones that are in place.
+constexpr size_t max_trace_events = 2000000;
+
+struct zone_node {
+    const char *name;
+    size_t parent;
+    int depth;
+    profiler_clock::duration this_turn;
+    int calls_this_turn;
+    double last_ms;
+    int calls_last_turn;
+    double average_ms;
+    bool averaged;
+};
+
+struct open_zone {
+    size_t node;
+    profiler_clock::time_point start;
+};
+
+struct trace_event {
+    // nullptr marks the start of a turn.
+    const char *name;
+    profiler_clock::time_point start;
+    profiler_clock::duration duration;
+};
+
+// Zones check enabled and thread on any thread, everything else belongs to the profiled thread.
+struct profiler_state {
+    std::atomic<bool> enabled{ false };
+    std::atomic<std::thread::id> thread;
+    bool tracing = false;
+    uint64_t session = 0;
+    std::vector<zone_node> nodes;
+    std::vector<open_zone> open;
+    std::vector<trace_event> events;
+    profiler_clock::time_point trace_start;
+};
+
+profiler_state &state()
+{
+    static profiler_state instance;
+    return instance;
+}
+
+size_t find_or_add_node( profiler_state &s, const char *name )
+{
+    const size_t parent = s.open.empty() ? no_parent : s.open.back().node;
+    for( size_t i = 0; i < s.nodes.size(); ++i ) {
+        const zone_node &node = s.nodes[i];
+        if( node.parent == parent &&
+            ( node.name == name || std::strcmp( node.name, name ) == 0 ) ) {
+            return i;
+        }
+    }
+    const int depth = parent == no_parent ? 0 : s.nodes[parent].depth + 1;
+    s.nodes.push_back( { name, parent, depth, profiler_clock::duration::zero(), 0, 0.0, 0, 0.0, false } );
+    return s.nodes.size() - 1;
+}
+
+void add_children( const std::vector<zone_node> &nodes, const size_t parent,
+                   std::vector<turn_profiler::zone_report> &result )
+{
+    for( size_t i = 0; i < nodes.size(); ++i ) {
+        const zone_node &node = nodes[i];
+        if( node.parent != parent ) {
+            continue;
+        }
+        turn_profiler::zone_report entry;
+        entry.name = node.name;
+        entry.depth = node.depth;
+        entry.last_ms = node.last_ms;
+        entry.average_ms = node.average_ms;
+        entry.calls = node.calls_last_turn;
+        result.push_back( entry );
+        add_children( nodes, i, result );
+    }
+}
+
+double to_microseconds( const profiler_clock::duration d )
+{
+    return std::chrono::duration<double, std::micro>( d ).count();
+}
+
+} // namespace
+
+namespace turn_profiler
+{
+
+bool enabled()
+{
+    return state().enabled.load( std::memory_order_relaxed );
+}
+
+void set_enabled( const bool enable )
+{
+    profiler_state &s = state();
+    s.enabled.store( false, std::memory_order_relaxed );
+    s.tracing = false;
+    ++s.session;
+    s.thread.store( std::this_thread::get_id(), std::memory_order_relaxed );
+    s.nodes.clear();
+    s.open.clear();
+    s.events.clear();
+    // Other threads seeing it enabled also see the new thread.
+    s.enabled.store( enable, std::memory_order_release );
+}
+
+void end_turn()
+{
+    profiler_state &s = state();
+    if( !enabled() ) {
+        return;
+    }
+    for( zone_node &node : s.nodes ) {
+        node.last_ms = std::chrono::duration<double, std::milli>( node.this_turn ).count();
+        node.calls_last_turn = node.calls_this_turn;
+        if( node.averaged ) {
+            node.average_ms += ( node.last_ms - node.average_ms ) * average_weight;
+        } else {
+            node.average_ms = node.last_ms;
+            node.averaged = true;
+        }
+        node.this_turn = profiler_clock::duration::zero();
+        node.calls_this_turn = 0;
+    }
+    if( s.tracing && s.events.size() < max_trace_events ) {
+        s.events.push_back( { nullptr, profiler_clock::now(), profiler_clock::duration::zero() } );
+    }
+}
+
+std::vector<zone_report> report()
+{
+    std::vector<zone_report> result;
+    add_children( state().nodes, no_parent, result );
+    return result;
+}
+
+bool tracing()
+{
+    return state().tracing;
+}
+
+void start_trace()
+{
+    if( !enabled() ) {
+        set_enabled( true );
+    }
+    profiler_state &s = state();
+    s.tracing = true;
+    s.events.clear();
+    s.trace_start = profiler_clock::now();
+}
+
+int stop_trace( const std::string &path )
+{
+    profiler_state &s = state();
+    s.tracing = false;
+    std::vector<trace_event> events;
+    events.swap( s.events );
+    const bool written = write_to_file( path, [&]( std::ostream & fout ) {
+        JsonOut jsout( fout );
+        jsout.start_object();
+        jsout.member( "displayTimeUnit", "ms" );
+        jsout.member( "traceEvents" );
+        jsout.start_array();
+        for( const trace_event &event : events ) {
+            jsout.start_object();
+            jsout.member( "name", event.name ? event.name : "turn" );
+            jsout.member( "cat", "turn" );
+            jsout.member( "ph", event.name ? "X" : "i" );
+            if( !event.name ) {
+                // Instant events default to the thread scope, global ones draw a line across.
+                jsout.member( "s", "g" );
+            }
+            jsout.member( "ts", to_microseconds( event.start - s.trace_start ) );
+            if( event.name ) {
+                jsout.member( "dur", to_microseconds( event.duration ) );
+            }
+            jsout.member( "pid", 1 );
+            jsout.member( "tid", 1 );
+            jsout.end_object();
+        }
+        jsout.end_array();
+        jsout.end_object();
+    }, "turn profile trace" );
+    return written ? static_cast<int>( events.size() ) : -1;
+}
+
+std::string default_trace_path()
+{
+    return PATH_INFO::config_dir() + "turn_trace.json";
+}
+
+scoped_zone::scoped_zone( const char *name ) : session( 0 )
+{
+    profiler_state &s = state();
+    if( !s.enabled.load( std::memory_order_acquire ) ||
+        s.thread.load( std::memory_order_relaxed ) != std::this_thread::get_id() ) {
+        return;
+    }
+    session = s.session;
+    const size_t node = find_or_add_node( s, name );
+    s.open.push_back( { node, profiler_clock::now() } );
+}
+
+scoped_zone::~scoped_zone()
+{
+    profiler_state &s = state();
+    // The profiler was switched off or restarted while the zone was open.
+    if( session == 0 || session != s.session || s.open.empty() ) {
+        return;
+    }
+    const open_zone zone = s.open.back();
+    s.open.pop_back();
+    const profiler_clock::duration duration = profiler_clock::now() - zone.start;
+    zone_node &node = s.nodes[zone.node];
+    node.this_turn += duration;
+    ++node.calls_this_turn;
+    if( s.tracing && s.events.size() < max_trace_events ) {
+        s.events.push_back( { node.name, zone.start, duration } );
+    }
+}
+
+} // namespace turn_profiler
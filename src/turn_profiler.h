@@ -0,0 +1,89 @@
+#pragma once
+#ifndef CATA_SRC_TURN_PROFILER_H
+#define CATA_SRC_TURN_PROFILER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Wall clock timing of the parts of a game turn.
+ *
+ * Code marks a part with TURN_PROFILER_ZONE( "name" ), which times the rest of the enclosing
+ * scope. Zones opened while another zone is open are its children, so the same name can show
+ * up in several places of the tree when a function with a zone is called from two timed phases.
+ * Only zones on the thread that enabled the profiler are timed, others are ignored.
+ *
+ * The zones are compiled in unless RELEASE is defined. Release builds can keep them with
+ * CATA_TURN_PROFILER (the TURN_PROFILER option of the CMake and make builds). Either way they
+ * cost a single check while the profiler is switched off, which is the default.
+ */
+namespace turn_profiler
+{
+
+/** One zone of the call tree, as shown by the debug overlay. */
+struct zone_report {
+    std::string name;
+    /** 0 for zones opened outside of any other zone. */
+    int depth = 0;
+    /** Time spent in the zone in the last finished turn. */
+    double last_ms = 0.0;
+    /** Moving average of the time per turn, including turns where the zone wasn't entered. */
+    double average_ms = 0.0;
+    /** How often the zone was entered in the last finished turn. */
+    int calls = 0;
+};
+
+bool enabled();
+/** Switching the profiler on or off forgets everything timed so far. */
+void set_enabled( bool enable );
+
+/**
+ * Finishes the current turn: the times collected since the last call become the "last turn"
+ * and are added to the averages. Called once at the start of every turn.
+ */
+void end_turn();
+
+/** The zones timed so far, parents before their children. */
+std::vector<zone_report> report();
+
+/**
+ * Recording a trace also switches the profiler on. Every zone that closes while recording
+ * becomes one complete event of a Chrome trace (chrome://tracing, Perfetto).
+ */
+bool tracing();
+void start_trace();
+/**
+ * Stops recording and writes the events to @p path.
+ * @return Number of events written, or -1 when the file couldn't be written.
+ */
+int stop_trace( const std::string &path );
+/** Where the debug menu writes traces to. */
+std::string default_trace_path();
+
+class scoped_zone
+{
+    public:
+        /** @p name must outlive the profiler, in practice this means a string literal. */
+        explicit scoped_zone( const char *name );
+        ~scoped_zone();
+
+        scoped_zone( const scoped_zone & ) = delete;
+        scoped_zone &operator=( const scoped_zone & ) = delete;
+    private:
+        /** 0 when the zone isn't timed. */
+        uint64_t session;
+};
+
+} // namespace turn_profiler
+
+#if !defined(RELEASE) || defined(CATA_TURN_PROFILER)
+#define CATA_TURN_PROFILER_ZONE_NAME2( line ) turn_profiler_zone_##line
+#define CATA_TURN_PROFILER_ZONE_NAME( line ) CATA_TURN_PROFILER_ZONE_NAME2( line )
+#define TURN_PROFILER_ZONE( name ) \
+    const turn_profiler::scoped_zone CATA_TURN_PROFILER_ZONE_NAME( __LINE__ )( name )
+#else
+#define TURN_PROFILER_ZONE( name ) static_cast<void>( 0 )
+#endif
+
+#endif // CATA_SRC_TURN_PROFILER_H
@@ -4949,54 +4949,114 @@ void vehicle::enumerate_vehicles( std::map<vehicle *, bool> &connected_vehicles,
     }
 }
 
-template <typename Func, typename Vehicle>
-int vehicle::traverse_vehicle_graph( Vehicle *start_veh, int amount, Func action )
+// Vehicles placed on the map or moved, see vehicle::power_grid::open
+static uint64_t vehicle_placements = 0;
+
+vehicle::power_grid &vehicle::power_grid::operator=( const power_grid & )
+{
+    // The vehicle owning this grid became a different one.
+    invalidate();
+    return *this;
+}
+
+vehicle::power_grid::~power_grid()
+{
+    invalidate();
+}
+
+void vehicle::power_grid::invalidate()
+{
+    std::set<power_grid *> including;
+    including.swap( included_by );
+    for( power_grid *grid : including ) {
+        grid->clear();
+    }
+    clear();
+}
+
+void vehicle::power_grid::clear()
+{
+    for( const std::pair<vehicle *, int> &member : members ) {
+        member.first->power_grid_cache.included_by.erase( this );
+    }
+    members.clear();
+    open = false;
+    valid = false;
+}
+
+void vehicle::invalidate_power_grid( const bool moved )
 {
+    power_grid_cache.invalidate();
+    if( moved ) {
+        vehicle_placements++;
+    }
+}
+
+const vehicle::power_grid &vehicle::get_power_grid() const
+{
+    if( power_grid_cache.valid && ( !power_grid_cache.open ||
+                                    power_grid_cache.placements == vehicle_placements ) ) {
+        return power_grid_cache;
+    }
+    power_grid_cache.clear();
+    power_grid_cache.valid = true;
+    power_grid_cache.placements = vehicle_placements;
+
     // Breadth-first search! Initialize the queue with a pointer to ourselves and go!
-    std::queue< std::pair<Vehicle *, int> > connected_vehs;
-    std::set<Vehicle *> visited_vehs;
-    connected_vehs.push( std::make_pair( start_veh, 0 ) );
+    std::queue< std::pair<const vehicle *, int> > connected_vehs;
+    std::set<const vehicle *> visited_vehs;
+    connected_vehs.push( std::make_pair( this, 0 ) );
 
-    while( amount > 0 && !connected_vehs.empty() ) {
+    while( !connected_vehs.empty() ) {
         auto current_node = connected_vehs.front();
-        Vehicle *current_veh = current_node.first;
+        const vehicle *current_veh = current_node.first;
         int current_loss = current_node.second;
 
         visited_vehs.insert( current_veh );
         connected_vehs.pop();
 
-        add_msg( m_debug, "Traversing graph with %d power", amount );
-
         for( auto &p : current_veh->loose_parts ) {
             if( !current_veh->part_info( p ).has_flag( "POWER_TRANSFER" ) ) {
                 continue; // ignore loose parts that aren't power transfer cables
             }
 
             auto target_veh = vehicle::find_vehicle( current_veh->parts[p].target.second );
-            if( target_veh == nullptr || visited_vehs.count( target_veh ) > 0 ) {
-                // Either no destination here (that vehicle's rolled away or off-map) or
-                // we've already looked at that vehicle.
+            if( target_veh == nullptr ) {
+                // No destination here (that vehicle's rolled away or off-map).
+                power_grid_cache.open = true;
+                continue;
+            }
+            if( visited_vehs.count( target_veh ) > 0 ) {
+                // We've already looked at that vehicle.
                 continue;
             }
 
             // Add this connected vehicle to the queue of vehicles to search next,
             // but only if we haven't seen this one before.
-            if( visited_vehs.count( target_veh ) < 1 ) {
-                int target_loss = current_loss + current_veh->part_info( p ).epower;
-                connected_vehs.push( std::make_pair( target_veh, target_loss ) );
-
-                float loss_amount = ( static_cast<float>( amount ) * static_cast<float>( target_loss ) ) / 100;
-                add_msg( m_debug, "Visiting remote %p with %d power (loss %f, which is %d percent)",
-                         static_cast<void *>( target_veh ), amount, loss_amount, target_loss );
-
-                amount = action( target_veh, amount, static_cast<int>( loss_amount ) );
-                add_msg( m_debug, "After remote %p, %d power", static_cast<void *>( target_veh ), amount );
+            int target_loss = current_loss + current_veh->part_info( p ).epower;
+            connected_vehs.push( std::make_pair( target_veh, target_loss ) );
+            power_grid_cache.members.emplace_back( target_veh, target_loss );
+            target_veh->power_grid_cache.included_by.insert( &power_grid_cache );
+        }
+    }
+    return power_grid_cache;
+}
 
-                if( amount < 1 ) {
-                    break; // No more charge to donate away.
-                }
-            }
+template <typename Func, typename Vehicle>
+int vehicle::traverse_vehicle_graph( Vehicle *start_veh, int amount, Func action )
+{
+    for( const std::pair<vehicle *, int> &member : start_veh->get_power_grid().members ) {
+        if( amount < 1 ) {
+            break; // No more charge to donate away.
         }
+        Vehicle *target_veh = member.first;
+        const int target_loss = member.second;
+        float loss_amount = ( static_cast<float>( amount ) * static_cast<float>( target_loss ) ) / 100;
+        add_msg( m_debug, "Visiting remote %p with %d power (loss %f, which is %d percent)",
+                 static_cast<const void *>( target_veh ), amount, loss_amount, target_loss );
+
+        amount = action( target_veh, amount, static_cast<int>( loss_amount ) );
+        add_msg( m_debug, "After remote %p, %d power", static_cast<const void *>( target_veh ), amount );
     }
     return amount;
 }
@@ -5005,8 +5065,9 @@ int vehicle::charge_battery( int amount, bool include_other_vehicles )
 {
     // Key parts by percentage charge level.
     std::multimap<int, vehicle_part *> chargeable_parts;
-    for( vehicle_part &p : parts ) {
-        if( p.is_available() && p.is_battery() &&
+    for( const int bi : batteries ) {
+        vehicle_part &p = parts[bi];
+        if( p.is_available() &&
             p.ammo_capacity( ammotype( "battery" ) ) > p.ammo_remaining() ) {
             chargeable_parts.insert( { ( p.ammo_remaining() * 100 ) / p.ammo_capacity( ammotype( "battery" ) ), &p } );
         }
@@ -5045,8 +5106,9 @@ int vehicle::discharge_battery( int amount, bool recurse )
 {
     // Key parts by percentage charge level.
     std::multimap<int, vehicle_part *> dischargeable_parts;
-    for( vehicle_part &p : parts ) {
-        if( p.is_available() && p.is_battery() && p.ammo_remaining() > 0 ) {
+    for( const int bi : batteries ) {
+        vehicle_part &p = parts[bi];
+        if( p.is_available() && p.ammo_remaining() > 0 ) {
             dischargeable_parts.insert( { ( p.ammo_remaining() * 100 ) / p.ammo_capacity( ammotype( "battery" ) ), &p } );
         }
     }
@@ -5547,6 +5609,7 @@ void vehicle::refresh()
     if( no_refresh ) {
         return;
     }
+    invalidate_power_grid( false );
 
     alternators.clear();
     engines.clear();
@@ -5,6 +5,7 @@
 #include <array>
 #include <climits>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <set>
@@ -732,7 +733,8 @@ class vehicle
 
         /**
          * Traverses the graph of connected vehicles, starting from start_veh, and continuing
-         * along all vehicles connected by some kind of POWER_TRANSFER part.
+         * along all vehicles connected by some kind of POWER_TRANSFER part. The connections come
+         * from the cached @ref get_power_grid of start_veh.
          * @param start_veh The vehicle to start traversing from. NB: the start_vehicle is
          * assumed to have been already visited!
          * @param amount An amount of power to traverse with. This is passed back to the visitor,
@@ -1392,6 +1394,14 @@ class vehicle
          */
         static void enumerate_vehicles( std::map<vehicle *, bool> &connected_vehicles,
                                         std::set<vehicle *> &vehicle_list );
+
+        /**
+         * Marks the power grids (see @ref get_power_grid) that include this vehicle as out of date.
+         * Needed whenever it changes its parts, which can add or remove cables, or leaves its place.
+         * @param moved The vehicle was placed somewhere new. Grids with a cable that led nowhere
+         * are out of date as well, as it may lead to this vehicle now.
+         */
+        void invalidate_power_grid( bool moved );
         // idle fuel consumption
         void idle( bool on_map = true );
         // continuous processing for running vehicle alarms
@@ -1839,6 +1849,37 @@ class vehicle
         mutable point mass_center_no_precalc;
         tripoint autodrive_local_target = tripoint_zero; // current node the autopilot is aiming for
 
+        /** The vehicles connected to this one by power cables, see @ref get_power_grid. */
+        struct power_grid {
+            power_grid() = default;
+            // A copy of a vehicle searches its own connections.
+            power_grid( const power_grid & ) {}
+            power_grid &operator=( const power_grid & );
+            ~power_grid();
+
+            bool valid = false;
+            // Connected vehicles in the order power reaches them, each with the percentage of
+            // power lost in the cables on the way there.
+            std::vector<std::pair<vehicle *, int>> members;
+            // A cable led to a place without a vehicle, so the grid changes whenever a vehicle is
+            // placed somewhere. The count of placements when it was built.
+            bool open = false;
+            uint64_t placements = 0;
+            // Grids of other vehicles that include the vehicle owning this one.
+            std::set<power_grid *> included_by;
+
+            /** Forgets this grid and every grid in @ref included_by. */
+            void invalidate();
+            /** Forgets this grid only. */
+            void clear();
+        };
+        mutable power_grid power_grid_cache;
+        /**
+         * Returns the cached grid of this vehicle, searching the cable connections again only if
+         * it or one of its members changed parts, moved or was destroyed since it was built.
+         */
+        const power_grid &get_power_grid() const;
+
     public:
         // Subtract from parts.size() to get the real part count.
         int removed_part_count = 0;
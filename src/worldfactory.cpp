@@ -1516,6 +1516,7 @@ void WORLD::load_legacy_options( std::istream &fin )
 bool WORLD::load_options()
 {
     WORLD_OPTIONS = get_options().get_world_defaults();
+    options_manager::values_changed();
 
     using namespace std::placeholders;
     const auto path = folder_path() + "/" + PATH_INFO::worldoptions();
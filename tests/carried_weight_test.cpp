@@ -0,0 +1,102 @@
+#include <cstddef>
+#include <list>
+
+#include "avatar.h"
+#include "bodypart.h"
+#include "catch/catch.hpp"
+#include "character.h"
+#include "item.h"
+#include "item_contents.h"
+#include "item_pocket.h"
+#include "player_helpers.h"
+#include "type_id.h"
+#include "units.h"
+
+TEST_CASE( "carried_weight_and_volume_follow_the_items", "[character][item]" )
+{
+    clear_avatar();
+    avatar &dummy = get_avatar();
+    const item rock( "test_rock" );
+
+    dummy.wear_item( item( "test_backpack" ), false );
+    REQUIRE( dummy.worn.size() == 1 );
+    item &backpack = dummy.worn.front();
+    const units::mass empty_weight = dummy.weight_carried();
+    const units::volume empty_space = dummy.free_space();
+    CHECK( empty_weight == backpack.weight() );
+    CHECK( dummy.volume_carried() == 0_ml );
+    CHECK( dummy.check_carried_caches() );
+
+    SECTION( "items put straight into a worn pocket are counted" ) {
+        REQUIRE( backpack.put_in( rock, item_pocket::pocket_type::CONTAINER ).success() );
+        CHECK( dummy.weight_carried() == empty_weight + rock.weight() );
+        CHECK( dummy.check_carried_caches() );
+
+        dummy.remove_items_with( []( const item & it ) {
+            return it.typeId() == itype_id( "test_rock" );
+        } );
+        CHECK( dummy.weight_carried() == empty_weight );
+        CHECK( dummy.free_space() == empty_space );
+        CHECK( dummy.check_carried_caches() );
+    }
+    SECTION( "items put into a bag inside a worn pocket are counted" ) {
+        REQUIRE( backpack.put_in( item( "bag_plastic" ), item_pocket::pocket_type::CONTAINER ).success() );
+        const units::mass bag_weight = dummy.weight_carried();
+        item &bag = *backpack.contents.all_items_top( item_pocket::pocket_type::CONTAINER ).front();
+        REQUIRE( bag.put_in( rock, item_pocket::pocket_type::CONTAINER ).success() );
+        CHECK( dummy.weight_carried() == bag_weight + rock.weight() );
+        CHECK( dummy.check_carried_caches() );
+    }
+    SECTION( "charges used up in a worn pocket are noticed" ) {
+        item ammo( "test_9mm_ammo" );
+        ammo.charges = 50;
+        REQUIRE( backpack.put_in( ammo, item_pocket::pocket_type::CONTAINER ).success() );
+        const units::mass full_weight = dummy.weight_carried();
+        backpack.contents.all_items_top( item_pocket::pocket_type::CONTAINER ).front()->charges = 10;
+        CHECK( dummy.weight_carried() < full_weight );
+        CHECK( dummy.check_carried_caches() );
+    }
+    SECTION( "changes to items someone else carries are not counted" ) {
+        const size_t changes = backpack.contents.changes();
+        item other_backpack( "test_backpack" );
+        REQUIRE( other_backpack.put_in( rock, item_pocket::pocket_type::CONTAINER ).success() );
+        CHECK( backpack.contents.changes() == changes );
+        REQUIRE( backpack.put_in( rock, item_pocket::pocket_type::CONTAINER ).success() );
+        CHECK( backpack.contents.changes() != changes );
+    }
+    SECTION( "changing worn items directly is noticed" ) {
+        dummy.worn.clear();
+        dummy.worn.push_back( item( "test_socks" ) );
+        CHECK( dummy.weight_carried() == dummy.worn.front().weight() );
+        CHECK( dummy.free_space() == 0_ml );
+        CHECK( dummy.check_carried_caches() );
+        dummy.check_item_encumbrance_flag();
+        CHECK( dummy.encumb( bodypart_id( "torso" ) ) == 0 );
+        CHECK( dummy.check_carried_caches() );
+    }
+    SECTION( "the wielded item is counted" ) {
+        dummy.weapon = rock;
+        CHECK( dummy.weight_carried() == empty_weight + rock.weight() );
+        dummy.remove_weapon();
+        CHECK( dummy.weight_carried() == empty_weight );
+        CHECK( dummy.check_carried_caches() );
+    }
+}
+
+TEST_CASE( "encumbrance_is_not_recalculated_without_changes", "[character][encumbrance]" )
+{
+    clear_avatar();
+    avatar &dummy = get_avatar();
+    dummy.calc_encumbrance();
+    CHECK_FALSE( dummy.get_check_encumbrance() );
+
+    dummy.wear_item( item( "test_longshirt" ), false );
+    CHECK( dummy.encumb( bodypart_id( "torso" ) ) > 0 );
+    CHECK( dummy.check_carried_caches() );
+
+    dummy.flag_encumbrance();
+    CHECK( dummy.get_check_encumbrance() );
+    dummy.check_item_encumbrance_flag();
+    CHECK_FALSE( dummy.get_check_encumbrance() );
+    CHECK( dummy.check_carried_caches() );
+}
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <vector>
+
+#include "avatar.h"
+#include "catch/catch.hpp"
+#include "creature.h"
+#include "creature_tracker.h"
+#include "game.h"
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_iterator.h"
+#include "mapdata.h"
+#include "memory_fast.h"
+#include "monster.h"
+#include "point.h"
+
+// What find_in_rectangle should return, by looking at every monster.
+static std::vector<monster *> monsters_in_box( const tripoint &min, const tripoint &max )
+{
+    std::vector<monster *> result;
+    for( const tripoint &p : tripoint_range<tripoint>( min, max ) ) {
+        if( const shared_ptr_fast<monster> mon = g->critter_tracker->find( p ) ) {
+            result.push_back( mon.get() );
+        }
+    }
+    return result;
+}
+
+TEST_CASE( "creature_tracker_area_queries_follow_monsters", "[creature_tracker][monster]" )
+{
+    clear_map_and_put_player_underground();
+    const Creature_tracker &tracker = *g->critter_tracker;
+    // On both sides of the borders between the tracker's cells.
+    monster &a = spawn_test_monster( "mon_zombie", { 11, 11, 0 } );
+    monster &b = spawn_test_monster( "mon_zombie", { 12, 12, 0 } );
+    monster &c = spawn_test_monster( "mon_zombie", { 30, 5, 0 } );
+    // Only the surface is cleared, below it is solid rock.
+    get_map().set( { 13, 12, -1 }, t_floor, f_null );
+    monster &d = spawn_test_monster( "mon_zombie", { 13, 12, -1 } );
+
+    CHECK( tracker.find_in_rectangle( { 0, 0, 0 }, { 11, 11, 0 } ) == std::vector<monster *> { &a } );
+    CHECK( tracker.find_in_rectangle( { 11, 11, 0 }, { 12, 12, 0 } ) ==
+           std::vector<monster *> { &a, &b } );
+    CHECK( tracker.find_in_rectangle( { 0, 0, -1 }, { 40, 40, 0 } ) ==
+           std::vector<monster *> { &d, &c, &a, &b } );
+    CHECK( tracker.find_in_radius( { 12, 12, 0 }, 1 ) == std::vector<monster *> { &a, &b } );
+    CHECK( tracker.find_in_radius( { 12, 12, 0 }, 1, 1 ) == std::vector<monster *> { &d, &a, &b } );
+
+    SECTION( "moving a monster moves it in the queries" ) {
+        b.setpos( { 29, 5, 0 } );
+        CHECK( tracker.find_in_radius( { 12, 12, 0 }, 1 ) == std::vector<monster *> { &a } );
+        CHECK( tracker.find_in_radius( { 30, 5, 0 }, 1 ) == std::vector<monster *> { &b, &c } );
+    }
+    SECTION( "swapped monsters are found at their new positions" ) {
+        g->swap_critters( a, c );
+        CHECK( tracker.find_in_radius( { 11, 11, 0 }, 0 ) == std::vector<monster *> { &c } );
+        CHECK( tracker.find_in_radius( { 30, 5, 0 }, 0 ) == std::vector<monster *> { &a } );
+    }
+    SECTION( "dead and removed monsters are not found" ) {
+        a.die( nullptr );
+        CHECK( tracker.find_in_radius( { 12, 12, 0 }, 1 ) == std::vector<monster *> { &b } );
+        g->remove_zombie( b );
+        CHECK( tracker.find_in_radius( { 12, 12, 0 }, 1 ).empty() );
+    }
+    SECTION( "queries match looking at every point" ) {
+        for( const tripoint &min : {
+                 tripoint( 0, 0, -1 ), tripoint( 5, 5, 0 ), tripoint( 12, 0, 0 ), tripoint( -20, -20, -1 )
+             } ) {
+            for( const int size : { 0, 5, 11, 12, 25, 200 } ) {
+                const tripoint max = min + tripoint( size, size, 1 );
+                CAPTURE( min, max );
+                CHECK( tracker.find_in_rectangle( min, max ) == monsters_in_box( min, max ) );
+            }
+        }
+    }
+    SECTION( "get_creatures_in_radius visits the squares in order" ) {
+        avatar &you = get_avatar();
+        you.setpos( { 12, 11, 0 } );
+        const std::list<Creature *> expected { &a, &you, &b };
+        CHECK( get_map().get_creatures_in_radius( { 12, 12, 0 }, 1 ) == expected );
+    }
+    clear_creatures();
+}
+
+TEST_CASE( "creature_tracker_area_query_performance", "[.]" )
+{
+    clear_map_and_put_player_underground();
+    const Creature_tracker &tracker = *g->critter_tracker;
+    for( int x = 0; x < MAPSIZE_X; x += 3 ) {
+        for( int y = 0; y < MAPSIZE_Y; y += 3 ) {
+            spawn_test_monster( "mon_zombie", { x, y, 0 } );
+        }
+    }
+    const int iterations = 10000;
+    size_t found = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for( int i = 0; i < iterations; ++i ) {
+        const tripoint center( i % MAPSIZE_X, ( i / MAPSIZE_X ) % MAPSIZE_Y, 0 );
+        found += tracker.find_in_radius( center, 10 ).size();
+    }
+    const auto grid_end = std::chrono::steady_clock::now();
+    for( int i = 0; i < iterations; ++i ) {
+        const tripoint center( i % MAPSIZE_X, ( i / MAPSIZE_X ) % MAPSIZE_Y, 0 );
+        for( const monster &mon : g->all_monsters() ) {
+            if( square_dist( center, mon.pos() ) <= 10 ) {
+                --found;
+            }
+        }
+    }
+    const auto scan_end = std::chrono::steady_clock::now();
+    CHECK( found == 0 );
+    printf( "%zu monsters, %d radius 10 queries: grid %lld ms, scanning all monsters %lld ms\n",
+            tracker.size(), iterations,
+            static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>
+                                    ( grid_end - start ).count() ),
+            static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>
+                                    ( scan_end - grid_end ).count() ) );
+    clear_creatures();
+}
@@ -0,0 +1,73 @@
+#include "catch/catch.hpp"
+#include "init.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "cata_utility.h"
+#include "filesystem.h"
+
+static void write_data_file( const std::string &path, const std::string &contents )
+{
+    write_to_file( path, [&]( std::ostream & fout ) {
+        fout << contents;
+    } );
+}
+
+// Key of the data files at @p paths, loaded by the mods in @p sources (each loads all files).
+static std::string key_of( const std::vector<std::string> &sources,
+                           const std::vector<std::string> &paths )
+{
+    loaded_data_key key;
+    for( const std::string &src : sources ) {
+        key.add_source( src );
+        for( const std::string &path : paths ) {
+            const mapped_file contents( path );
+            key.add_file( path, loaded_data_key::hash_contents( contents.data(), contents.size() ),
+                          contents.size() );
+        }
+    }
+    return key.str();
+}
+
+TEST_CASE( "loaded_data_key_changes_with_the_data", "[init]" )
+{
+    const std::string path = "init_test_data.json";
+    const std::string other_path = "init_test_other_data.json";
+    const std::string contents = R"([ { "type": "item_group", "id": "x", "items": [ "rock" ] } ])";
+    write_data_file( path, contents );
+    write_data_file( other_path, "[ ]" );
+    const std::string key = key_of( { "dda" }, { path, other_path } );
+
+    SECTION( "same files" ) {
+        CHECK( key_of( { "dda" }, { path, other_path } ) == key );
+    }
+    SECTION( "file edited" ) {
+        // Same size, only one letter differs.
+        write_data_file( path, R"([ { "type": "item_group", "id": "x", "items": [ "rack" ] } ])" );
+        CHECK( key_of( { "dda" }, { path, other_path } ) != key );
+        write_data_file( path, contents );
+        CHECK( key_of( { "dda" }, { path, other_path } ) == key );
+    }
+    SECTION( "file added or removed" ) {
+        CHECK( key_of( { "dda" }, { path } ) != key );
+        CHECK( key_of( { "dda" }, { path, other_path, other_path } ) != key );
+    }
+    SECTION( "files loaded in a different order" ) {
+        CHECK( key_of( { "dda" }, { other_path, path } ) != key );
+    }
+    SECTION( "different mods" ) {
+        CHECK( key_of( { "mod" }, { path, other_path } ) != key );
+        CHECK( key_of( { "dda", "mod" }, { path, other_path } ) !=
+               key_of( { "mod", "dda" }, { path, other_path } ) );
+    }
+    SECTION( "cleared" ) {
+        loaded_data_key cleared;
+        cleared.add_source( "dda" );
+        cleared.clear();
+        CHECK( cleared.str() == loaded_data_key().str() );
+    }
+    remove_file( path );
+    remove_file( other_path );
+}
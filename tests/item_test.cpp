@@ -2,14 +2,19 @@
 #include <initializer_list>
 #include <limits>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "calendar.h"
 #include "catch/catch.hpp"
 #include "enums.h"
+#include "flag.h"
 #include "item.h"
 #include "item_factory.h"
 #include "itype.h"
 #include "monstergenerator.h"
+#include "parallel.h"
 #include "ret_val.h"
 #include "units.h"
 #include "value_ptr.h"
@@ -203,3 +208,72 @@ TEST_CASE( "corpse length sanity check", "[item]" )
         assert_minimum_length_to_volume_ratio( sample );
     }
 }
+
+TEST_CASE( "flag_set", "[item]" )
+{
+    flag_set flags;
+    CHECK( flags.empty() );
+
+    const flag_id fit( "FIT" );
+    flags.insert( fit );
+    flags.insert( "FLAG_SET_TEST_TAG" );
+    CHECK( flags.count( fit ) );
+    CHECK( flags.count( "FIT" ) );
+    CHECK( flags.count( "FLAG_SET_TEST_TAG" ) );
+    CHECK_FALSE( flags.count( "FLAG_SET_TEST_NEVER_USED" ) );
+    CHECK( flags.size() == 2 );
+
+    std::set<std::string> names( flags.begin(), flags.end() );
+    CHECK( names == std::set<std::string> { "FIT", "FLAG_SET_TEST_TAG" } );
+    CHECK( flag_set( names ) == flags );
+
+    flags.erase( "FLAG_SET_TEST_TAG" );
+    CHECK_FALSE( flags.count( "FLAG_SET_TEST_TAG" ) );
+    flags.erase( fit );
+    CHECK( flags.empty() );
+    CHECK( flags == flag_set() );
+}
+
+TEST_CASE( "item_flags_by_id_and_name", "[item]" )
+{
+    item sweater( itype_id( "sweater" ) );
+    CHECK_FALSE( sweater.has_flag( "FIT" ) );
+    sweater.set_flag( flag_id( "FIT" ) );
+    CHECK( sweater.has_flag( "FIT" ) );
+    CHECK( sweater.has_flag( flag_id( "FIT" ) ) );
+
+    // Flags from the type and from the item itself
+    for( const std::string &flag : sweater.type->item_tags ) {
+        CHECK( sweater.has_flag( flag ) );
+        CHECK( sweater.has_flag( flag_id( flag ) ) );
+    }
+    sweater.unset_flag( "FIT" );
+    CHECK_FALSE( sweater.has_flag( flag_id( "FIT" ) ) );
+}
+
+TEST_CASE( "flag_lookups_by_name_dont_intern_it", "[item]" )
+{
+    const std::string name = "FLAG_LOOKUP_TEST_NEVER_SET";
+    item sweater( itype_id( "sweater" ) );
+    CHECK_FALSE( sweater.has_flag( name ) );
+    CHECK_FALSE( flag_set().count( name ) );
+    CHECK_FALSE( flag_id::lookup( name ) );
+
+    const flag_id interned( name );
+    REQUIRE( flag_id::lookup( name ) );
+    CHECK( *flag_id::lookup( name ) == interned );
+}
+
+TEST_CASE( "flags_interned_on_several_threads", "[item][parallel]" )
+{
+    scoped_parallel_threads threads( 4 );
+    std::vector<flag_id> ids( 200 );
+    parallel_for( ids.size(), [&ids]( const size_t i ) {
+        ids[i] = flag_id( "FLAG_THREAD_TEST_" + std::to_string( i % 50 ) );
+        flag_id::lookup( "FLAG_THREAD_TEST_" + std::to_string( i % 60 ) );
+    } );
+    for( size_t i = 0; i < ids.size(); ++i ) {
+        CHECK( ids[i].str() == "FLAG_THREAD_TEST_" + std::to_string( i % 50 ) );
+        CHECK( ids[i] == ids[i % 50] );
+    }
+}
@@ -1,11 +1,16 @@
 #include "json.h"
 
+#include <chrono>
+#include <cstdio>
+#include <functional>
 #include <list>
 #include <sstream>
 
 #include "bodypart.h"
 #include "catch/catch.hpp"
 #include "debug.h"
+#include "filesystem.h"
+#include "path_info.h"
 #include "string_formatter.h"
 #include "type_id.h"
 
@@ -28,6 +33,13 @@ void test_serialization( const T &val, const std::string &s )
         CHECK( jsin.read( read_val ) );
         CHECK( val == read_val );
     }
+    {
+        INFO( "test_deserialization_from_buffer" );
+        JsonIn jsin( s.data(), s.size() );
+        T read_val;
+        CHECK( jsin.read( read_val ) );
+        CHECK( val == read_val );
+    }
 }
 
 TEST_CASE( "serialize_colony", "[json]" )
@@ -71,3 +83,93 @@ TEST_CASE( "serialize_set", "[json]" )
     std::set<body_part> enum_set = { bp_foot_l };
     test_serialization( enum_set, string_format( R"([%d])", static_cast<int>( bp_foot_l ) ) );
 }
+
+// Reads the whole value, so both kinds of JsonIn can be compared by what they return
+static std::string read_all( JsonIn &jsin )
+{
+    std::ostringstream os;
+    try {
+        JsonOut jsout( os );
+        const std::function<void()> copy_value = [&]() {
+            if( jsin.test_object() ) {
+                jsout.start_object();
+                jsin.start_object();
+                while( !jsin.end_object() ) {
+                    jsout.member( jsin.get_member_name() );
+                    copy_value();
+                }
+                jsout.end_object();
+            } else if( jsin.test_array() ) {
+                jsout.start_array();
+                jsin.start_array();
+                while( !jsin.end_array() ) {
+                    copy_value();
+                }
+                jsout.end_array();
+            } else if( jsin.test_string() ) {
+                jsout.write( jsin.get_string() );
+            } else if( jsin.test_bool() ) {
+                jsout.write( jsin.get_bool() );
+            } else if( jsin.test_null() ) {
+                jsin.skip_null();
+                jsout.write_null();
+            } else {
+                jsout.write( jsin.get_float() );
+            }
+        };
+        copy_value();
+    } catch( const JsonError &err ) {
+        os << "\nerror: " << err.what();
+    }
+    return os.str();
+}
+
+TEST_CASE( "json_buffer_matches_stream", "[json]" )
+{
+    const std::vector<std::string> inputs = {
+        R"({"id":"foo","list":[1,-2.5,3e2,true,false,null],"nested":{"a":"b"}})",
+        R"( [ "escaped \" \\ \/ \n \u00e9 string", "plain" ] )",
+        "{\n  \"a\": 1,\n  \"b\": [ 1, 2, ]\n}",
+        "{\r\n  \"a\": \"unterminated\r\n}",
+        R"({"a":1 "b":2})",
+        R"(["truncated)",
+        R"({"a":tru})",
+        R"([01])",
+        "",
+    };
+    for( const std::string &input : inputs ) {
+        CAPTURE( input );
+        std::istringstream is( input );
+        JsonIn stream_in( is );
+        JsonIn buffer_in( input.data(), input.size() );
+        CHECK( read_all( buffer_in ) == read_all( stream_in ) );
+    }
+}
+
+TEST_CASE( "json_buffer_performance", "[.]" )
+{
+    const std::vector<std::string> files = get_files_from_path( ".json", PATH_INFO::jsondir(),
+                                           true, true );
+    const auto time_reads = [&]( const bool buffered ) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        size_t size = 0;
+        for( const std::string &file : files ) {
+            const mapped_file contents( file );
+            size += contents.size();
+            if( buffered ) {
+                JsonIn jsin( contents.data(), contents.size() );
+                read_all( jsin );
+            } else {
+                std::istringstream is( std::string( contents.data(), contents.size() ) );
+                JsonIn jsin( is );
+                read_all( jsin );
+            }
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        const long diff = std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+        printf( "%s: %zu files, %zu bytes in %ld us\n", buffered ? "buffer" : "stream", files.size(),
+                size, diff );
+    };
+    time_reads( false );
+    time_reads( true );
+}
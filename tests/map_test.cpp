@@ -1,13 +1,19 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "avatar.h"
+#include "calendar.h"
 #include "catch/catch.hpp"
 #include "enums.h"
 #include "game.h"
 #include "game_constants.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "mapdata.h"
+#include "parallel.h"
 #include "point.h"
 #include "type_id.h"
 
@@ -90,3 +96,103 @@ TEST_CASE( "place_player_can_safely_move_multiple_submaps" )
     g->place_player( tripoint_zero );
     CHECK( get_map().check_submap_active_item_consistency().empty() );
 }
+
+TEST_CASE( "map_sees_remembers_lines_until_the_map_changes", "[map][vision]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint from( 10, 10, 0 );
+    const tripoint to( 20, 12, 0 );
+    here.build_map_cache( 0 );
+    REQUIRE( here.sees( from, to, 60 ) );
+
+    const map::sight_memo_stats before = here.get_sight_memo_stats();
+    CHECK( here.sees( to, from, 60 ) );
+    CHECK( here.get_sight_memo_stats().hits == before.hits + 1 );
+    CHECK_FALSE( here.sees( from, to, 5 ) );
+
+    for( int y = 0; y < 30; ++y ) {
+        here.ter_set( tripoint( 15, y, 0 ), t_wall );
+    }
+    here.build_map_cache( 0 );
+    CHECK_FALSE( here.sees( from, to, 60 ) );
+    CHECK( here.get_sight_memo_stats().invalidations > before.invalidations );
+
+    for( int y = 0; y < 30; ++y ) {
+        here.ter_set( tripoint( 15, y, 0 ), t_floor );
+    }
+    here.build_map_cache( 0 );
+    CHECK( here.sees( from, to, 60 ) );
+
+    const uint64_t misses = here.get_sight_memo_stats().misses;
+    calendar::turn += 1_turns;
+    CHECK( here.sees( from, to, 60 ) );
+    CHECK( here.get_sight_memo_stats().misses == misses + 1 );
+}
+
+// Outside, transparency and floor caches of every level after rebuilding them all
+static std::vector<float> level_caches_built_on( const size_t threads )
+{
+    map &here = get_map();
+    const int minz = here.has_zlevels() ? -OVERMAP_DEPTH : 0;
+    const int maxz = here.has_zlevels() ? OVERMAP_HEIGHT : 0;
+    scoped_parallel_threads scoped( threads );
+    for( int z = minz; z <= maxz; z++ ) {
+        // Overwrite the previous results, so a level that isn't built shows up as a difference
+        level_cache &cache = here.access_cache( z );
+        std::fill_n( &cache.outside_cache[0][0], MAPSIZE_X * MAPSIZE_Y, threads % 2 == 0 );
+        std::fill_n( &cache.transparency_cache[0][0], MAPSIZE_X * MAPSIZE_Y, -1.0f * threads );
+        std::fill_n( &cache.floor_cache[0][0], MAPSIZE_X * MAPSIZE_Y, threads % 2 == 0 );
+        here.invalidate_map_cache( z );
+    }
+    here.build_map_cache( 0, true );
+
+    std::vector<float> result;
+    for( int z = minz; z <= maxz; z++ ) {
+        const level_cache &cache = here.access_cache( z );
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                result.push_back( cache.outside_cache[x][y] );
+                result.push_back( cache.transparency_cache[x][y] );
+                result.push_back( cache.floor_cache[x][y] );
+            }
+        }
+    }
+    return result;
+}
+
+TEST_CASE( "level_caches_built_on_threads_match_a_serial_build", "[map][parallel]" )
+{
+    clear_map();
+    map &here = get_map();
+    const ter_id t_flat_roof( "t_flat_roof" );
+    const field_type_id fd_smoke( "fd_smoke" );
+    // Rooms of different sizes on several levels, with smoke in some of them
+    for( int z = -2; z <= 2; z++ ) {
+        const int size = 6 + 3 * ( z + 2 );
+        for( int x = 20; x <= 20 + size; x++ ) {
+            for( int y = 30; y <= 30 + size; y++ ) {
+                const tripoint p( x, y, z );
+                const bool wall = x == 20 || y == 30 || x == 20 + size || y == 30 + size;
+                here.ter_set( p, wall ? t_wall : t_floor );
+                if( !wall && ( x + y + z ) % 5 == 0 ) {
+                    here.add_field( p, fd_smoke, 2 );
+                }
+                if( z < 2 ) {
+                    here.ter_set( p + tripoint_above, t_flat_roof );
+                }
+            }
+        }
+    }
+
+    const std::vector<float> serial = level_caches_built_on( 1 );
+    const std::vector<float> threaded = level_caches_built_on( 4 );
+    REQUIRE( serial.size() == threaded.size() );
+    int differences = 0;
+    for( size_t i = 0; i < serial.size(); i++ ) {
+        if( serial[i] != threaded[i] ) {
+            differences++;
+        }
+    }
+    CHECK( differences == 0 );
+}
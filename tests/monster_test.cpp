@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -6,8 +8,11 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <utility>
 
+#include "avatar.h"
+#include "calendar.h"
 #include "catch/catch.hpp"
 #include "character.h"
 #include "game.h"
@@ -16,10 +21,14 @@
 #include "line.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "map_iterator.h"
+#include "mapdata.h"
 #include "monster.h"
 #include "options_helpers.h"
 #include "options.h"
+#include "parallel.h"
 #include "point.h"
+#include "rng.h"
 #include "test_statistics.h"
 
 using move_statistics = statistics<int>;
@@ -329,3 +338,83 @@ TEST_CASE( "monster_speed_trig", "[speed]" )
     trigdist = true;
     monster_check();
 }
+
+struct planned_move {
+    tripoint goal;
+    int anger;
+    int morale;
+};
+
+// Plans of a group of zombies and of friendly dogs hunting them, made one after another after
+// the sight lines were traced on @p threads threads, if @p trace is set.
+static std::vector<planned_move> plans_of_a_fight( const bool trace, const size_t threads,
+        uint64_t &sight_misses )
+{
+    clear_map_and_put_player_underground();
+    calendar::turn = calendar::turn_zero + 12_hours;
+    map &here = get_map();
+    const tripoint center( 60, 60, 0 );
+    // Hides some of the monsters from each other.
+    for( int y = 52; y <= 58; ++y ) {
+        here.ter_set( center + point( -2, y - 60 ), t_wall );
+    }
+    const scoped_rng_engine rng_scope( 42 );
+    std::vector<monster *> critters;
+    for( const tripoint &p : here.points_in_radius( center, 10 ) ) {
+        if( here.impassable( p ) ) {
+            continue;
+        }
+        if( ( p.x * 7 + p.y * 3 ) % 23 == 0 ) {
+            critters.push_back( &spawn_test_monster( "mon_zombie", p ) );
+        } else if( ( p.x * 5 + p.y * 11 ) % 37 == 0 ) {
+            monster &dog = spawn_test_monster( "mon_dog", p );
+            dog.friendly = -1;
+            critters.push_back( &dog );
+        }
+    }
+    // Starts with an empty memo of lines.
+    here.set_transparency_cache_dirty( 0 );
+    here.build_map_cache( 0 );
+
+    if( trace ) {
+        scoped_parallel_threads scoped( threads );
+        monster::trace_plan_sight_lines( std::vector<const monster *>( critters.begin(),
+                                         critters.end() ) );
+    }
+    const uint64_t misses_before = here.get_sight_memo_stats().misses;
+    std::vector<planned_move> plans;
+    for( monster *critter : critters ) {
+        critter->plan();
+        plans.push_back( { critter->move_target(), critter->anger, critter->morale } );
+    }
+    sight_misses = here.get_sight_memo_stats().misses - misses_before;
+    clear_creatures();
+    return plans;
+}
+
+TEST_CASE( "monsters_plan_the_same_with_traced_sight_lines", "[monster][parallel]" )
+{
+    uint64_t untraced_misses = 0;
+    const std::vector<planned_move> untraced = plans_of_a_fight( false, 1, untraced_misses );
+    // The dogs go for different zombies.
+    std::set<tripoint> goals;
+    for( const planned_move &plan : untraced ) {
+        goals.insert( plan.goal );
+    }
+    REQUIRE( goals.size() > untraced.size() / 2 );
+    REQUIRE( untraced_misses > 0 );
+
+    const size_t threads = GENERATE( 1, 4 );
+    CAPTURE( threads );
+    uint64_t traced_misses = 0;
+    const std::vector<planned_move> traced = plans_of_a_fight( true, threads, traced_misses );
+    REQUIRE( traced.size() == untraced.size() );
+    for( size_t i = 0; i < traced.size(); ++i ) {
+        CAPTURE( i );
+        CHECK( traced[i].goal == untraced[i].goal );
+        CHECK( traced[i].anger == untraced[i].anger );
+        CHECK( traced[i].morale == untraced[i].morale );
+    }
+    // The plans found the lines traced before.
+    CHECK( traced_misses < untraced_misses / 2 );
+}
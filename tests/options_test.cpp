@@ -0,0 +1,52 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "catch/catch.hpp"
+#include "options.h"
+#include "options_helpers.h"
+
+TEST_CASE( "option_handle_follows_option_changes", "[options]" )
+{
+    const option_handle<bool> autosave( "AUTOSAVE" );
+    const option_handle<int> autosave_turns( "AUTOSAVE_TURNS" );
+    {
+        override_option opt( "AUTOSAVE", "true" );
+        override_option turns( "AUTOSAVE_TURNS", "70" );
+        CHECK( autosave.get() );
+        CHECK( autosave_turns.get() == 70 );
+        get_options().get_option( "AUTOSAVE_TURNS" ).setValue( 110 );
+        CHECK( autosave_turns.get() == 110 );
+    }
+    {
+        override_option opt( "AUTOSAVE", "false" );
+        CHECK_FALSE( autosave.get() );
+        CHECK( autosave.get() == get_option<bool>( "AUTOSAVE" ) );
+    }
+    const option_handle<std::string> sidebar( "SIDEBAR_POSITION" );
+    options_manager::options_container world_options = get_options().get_world_defaults();
+    get_options().set_world_options( &world_options );
+    CHECK( sidebar.get() == get_option<std::string>( "SIDEBAR_POSITION" ) );
+    get_options().set_world_options( nullptr );
+}
+
+TEST_CASE( "option_handle_performance", "[.]" )
+{
+    constexpr int reads = 1000000;
+    const option_handle<int> handle( "AUTOSAVE_TURNS" );
+    int sum = 0;
+    const auto start1 = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < reads; ++i ) {
+        sum += get_option<int>( "AUTOSAVE_TURNS" );
+    }
+    const auto end1 = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < reads; ++i ) {
+        sum += handle.get();
+    }
+    const auto end2 = std::chrono::high_resolution_clock::now();
+    const long long diff1 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end1 - start1 ).count();
+    const long long diff2 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end2 - end1 ).count();
+    printf( "%d reads: get_option %lld us, option_handle %lld us (%d)\n", reads, diff1, diff2, sum );
+}
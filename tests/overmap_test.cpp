@@ -1,17 +1,24 @@
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <memory>
 #include <vector>
 
 #include "calendar.h"
 #include "catch/catch.hpp"
 #include "common_types.h"
+#include "coordinates.h"
 #include "enums.h"
 #include "game_constants.h"
+#include "mongroup.h"
+#include "npc.h"
 #include "omdata.h"
+#include "options_helpers.h"
 #include "overmap.h"
 #include "overmap_types.h"
 #include "overmapbuffer.h"
 #include "point.h"
+#include "rng.h"
 #include "type_id.h"
 
 TEST_CASE( "set_and_get_overmap_scents" )
@@ -106,6 +113,159 @@ TEST_CASE( "default_overmap_generation_has_non_mandatory_specials_at_origin", "[
     CHECK( found_optional == true );
 }
 
+// Terrain of the ground level of the overmaps around @p center, generated in a fixed order.
+static std::vector<oter_id> generate_around( const point_abs_om &center )
+{
+    overmap_buffer.clear();
+    overmap_buffer.get( center );
+    std::vector<oter_id> result;
+    for( const point &dir : four_adjacent_offsets ) {
+        // Just inside the edge of the center overmap in that direction.
+        const point_abs_omt edge = project_combine( center, point_om_omt(
+                                       ( OMAPX - 1 ) * ( dir.x + 1 ) / 2, ( OMAPY - 1 ) * ( dir.y + 1 ) / 2 ) );
+        overmap_buffer.pregenerate_near( tripoint_abs_omt( edge, 0 ) );
+        const overmap &om = overmap_buffer.get( center + dir );
+        for( int x = 0; x < OMAPX; ++x ) {
+            for( int y = 0; y < OMAPY; ++y ) {
+                result.push_back( om.ter( tripoint_om_omt( x, y, 0 ) ) );
+            }
+        }
+    }
+    overmap_buffer.clear();
+    return result;
+}
+
+TEST_CASE( "pregenerated_overmaps_match_generated_ones", "[overmap][slow]" )
+{
+    const point_abs_om center( 40, 40 );
+    std::vector<oter_id> pregenerated;
+    {
+        override_option distance( "OVERMAP_PREGENERATION", "10" );
+        pregenerated = generate_around( center );
+    }
+    override_option distance( "OVERMAP_PREGENERATION", "0" );
+    const std::vector<oter_id> generated = generate_around( center );
+    CHECK( pregenerated == generated );
+}
+
+TEST_CASE( "overmaps_being_pregenerated_count_as_existing", "[overmap]" )
+{
+    override_option distance( "OVERMAP_PREGENERATION", "10" );
+    overmap_buffer.clear();
+    const point_abs_om center( 45, 45 );
+    const point_abs_om target = center + point_east;
+    overmap_buffer.get( center );
+    REQUIRE_FALSE( overmap_buffer.has( target ) );
+
+    const point_abs_omt east_edge = project_combine( center, point_om_omt( OMAPX - 1, OMAPY / 2 ) );
+    overmap_buffer.pregenerate_near( tripoint_abs_omt( east_edge, 0 ) );
+    // Nothing may pick it as a place for a new overmap while it's being generated.
+    CHECK( overmap_buffer.has( target ) );
+    CHECK( overmap_buffer.get( target ).pos() == target );
+    overmap_buffer.clear();
+}
+
+TEST_CASE( "overmap_npc_queries_follow_moves", "[overmap][npc]" )
+{
+    const point_abs_om om_pos( 30, 30 );
+    std::unique_ptr<overmap> test_overmap = std::make_unique<overmap>( om_pos );
+    overmap &om = *test_overmap;
+    const point_abs_sm origin = project_to<coords::sm>( om_pos );
+    const auto anyone = []( const npc & ) {
+        return true;
+    };
+
+    std::vector<shared_ptr_fast<npc>> guys;
+    for( int i = 0; i < 20; ++i ) {
+        shared_ptr_fast<npc> guy = make_shared_fast<npc>();
+        guy->setID( character_id( 1000 + i ) );
+        guy->spawn_at_precise( ( origin + point( 10 * i, 10 * i ) ).raw(), tripoint_zero );
+        om.insert_npc( guy );
+        guys.push_back( guy );
+    }
+
+    const point_abs_sm near_first = origin + point( 2, 2 );
+    REQUIRE( om.get_npcs_near( near_first, 3, anyone ).size() == 1 );
+    CHECK( om.get_npcs_near( near_first, 3, anyone ).front() == guys[0] );
+    CHECK( om.get_npcs_near( origin, 10, anyone ).size() == 2 );
+    CHECK( om.get_npcs_near( origin, 1000, anyone ).size() == guys.size() );
+
+    // Moving it across the overmap must take it out of its old square.
+    guys[0]->spawn_at_precise( ( origin + point( 300, 10 ) ).raw(), tripoint_zero );
+    om.npc_moved( *guys[0] );
+    CHECK( om.get_npcs_near( near_first, 3, anyone ).empty() );
+    REQUIRE( om.get_npcs_near( origin + point( 300, 10 ), 0, anyone ).size() == 1 );
+    CHECK( om.get_npcs_near( origin + point( 300, 10 ), 0, anyone ).front() == guys[0] );
+
+    CHECK( om.erase_npc( guys[0]->getID() ) == guys[0] );
+    CHECK( om.get_npcs_near( origin + point( 300, 10 ), 0, anyone ).empty() );
+    CHECK( om.get_npcs_near( origin, 1000, anyone ).size() == guys.size() - 1 );
+}
+
+static mongroup make_horde( const tripoint_om_sm &pos, const tripoint_om_sm &target )
+{
+    mongroup horde( mongroup_id( "GROUP_ZOMBIE" ), pos, 1, 10 );
+    horde.horde = true;
+    horde.horde_behaviour = "roam";
+    horde.target = target;
+    horde.interest = 100;
+    return horde;
+}
+
+TEST_CASE( "hordes_move_towards_their_target", "[overmap][horde]" )
+{
+    std::unique_ptr<overmap> test_overmap = std::make_unique<overmap>( point_abs_om( 25, 25 ) );
+    const tripoint_om_sm start( 100, 100, 0 );
+    const tripoint_om_sm target( 110, 100, 0 );
+    const size_t num_hordes = 50;
+    for( size_t i = 0; i < num_hordes; ++i ) {
+        test_overmap->add_mon_group( make_horde( start, target ) );
+    }
+
+    for( int turn = 0; turn < 10; ++turn ) {
+        test_overmap->move_hordes();
+    }
+
+    const std::multimap<tripoint_om_sm, mongroup> &groups = test_overmap->get_mongroups();
+    CHECK( groups.size() == num_hordes );
+    int moved = 0;
+    for( const auto &entry : groups ) {
+        CAPTURE( entry.first );
+        CHECK( entry.first == entry.second.pos );
+        CHECK( entry.first.x() >= start.x() );
+        CHECK( entry.first.x() <= target.x() );
+        CHECK( entry.first.y() == start.y() );
+        if( entry.first != start ) {
+            moved++;
+        }
+    }
+    CHECK( moved > 0 );
+}
+
+TEST_CASE( "horde_movement_performance", "[.]" )
+{
+    std::unique_ptr<overmap> test_overmap = std::make_unique<overmap>( point_abs_om( 25, 25 ) );
+    const int size = OMAPX * 2;
+    for( int i = 0; i < 10000; ++i ) {
+        test_overmap->add_mon_group( make_horde(
+                                         tripoint_om_sm( rng( 0, size - 1 ), rng( 0, size - 1 ), 0 ),
+                                         tripoint_om_sm( rng( 0, size - 1 ), rng( 0, size - 1 ), 0 ) ) );
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int turn = 0; turn < 100; ++turn ) {
+        for( int sound = 0; sound < 10; ++sound ) {
+            test_overmap->signal_hordes( tripoint_rel_sm( rng( 0, size - 1 ), rng( 0, size - 1 ), 0 ),
+                                         rng( 5, 40 ) );
+        }
+        test_overmap->move_hordes();
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const long diff = std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    printf( "100 turns of %zu hordes with 10 sounds each: %ld us\n",
+            test_overmap->get_mongroups().size(), diff );
+}
+
 TEST_CASE( "is_ot_match", "[overmap][terrain]" )
 {
     SECTION( "exact match" ) {
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "debug.h"
+#include "parallel.h"
+
+TEST_CASE( "parallel_for_visits_every_index_once", "[parallel]" )
+{
+    const size_t threads = GENERATE( 1, 4 );
+    CAPTURE( threads );
+    scoped_parallel_threads scoped( threads );
+    for( const size_t count : {
+             0, 1, 2, 7, 1000
+         } ) {
+        CAPTURE( count );
+        std::vector<std::atomic<int>> visits( count );
+        for( std::atomic<int> &v : visits ) {
+            v = 0;
+        }
+        parallel_for( count, [&]( const size_t i ) {
+            ++visits[i];
+        } );
+        for( const std::atomic<int> &v : visits ) {
+            CHECK( v == 1 );
+        }
+    }
+}
+
+TEST_CASE( "deferred_debugmsgs_are_kept_per_capture", "[parallel]" )
+{
+    scoped_parallel_threads scoped( 4 );
+    std::vector<deferred_debugmsgs> messages( 16 );
+    parallel_for( messages.size(), [&]( const size_t i ) {
+        deferred_debugmsgs::capture capture( messages[i] );
+        if( i % 2 == 1 ) {
+            debugmsg( "message %d", static_cast<int>( i ) );
+        }
+        if( i % 3 == 0 ) {
+            DebugLog( D_WARNING, D_MAIN ) << "log line " << i;
+        }
+    } );
+    for( size_t i = 0; i < messages.size(); ++i ) {
+        CHECK( messages[i].empty() == ( i % 2 == 0 && i % 3 != 0 ) );
+    }
+}
+
+TEST_CASE( "parallel_for_inside_parallel_for_runs_serially", "[parallel]" )
+{
+    scoped_parallel_threads scoped( 4 );
+    std::vector<std::atomic<int>> visits( 64 );
+    for( std::atomic<int> &v : visits ) {
+        v = 0;
+    }
+    parallel_for( 8, [&]( const size_t outer ) {
+        parallel_for( 8, [&]( const size_t inner ) {
+            ++visits[outer * 8 + inner];
+        } );
+    } );
+    for( const std::atomic<int> &v : visits ) {
+        CHECK( v == 1 );
+    }
+}
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_door_c( "t_door_c" );
+static const ter_str_id ter_t_floor( "t_floor" );
+static const ter_str_id ter_t_wall( "t_wall" );
+
+// Settings of a monster that can't bash, open doors or climb, but may path over the whole map
+static const pathfinding_settings long_range_settings( 0, 1000, 1000, 0, false, false, true, false,
+        false );
+
+// Fills the map with walled buildings, leaving streets between them.
+// Every building has a closed door on its west side.
+static void build_city_block()
+{
+    clear_map();
+    map &here = get_map();
+    for( int bx = 24; bx + 10 < MAPSIZE_X; bx += 16 ) {
+        for( int by = 4; by + 10 < MAPSIZE_Y; by += 16 ) {
+            for( int x = bx; x < bx + 10; x++ ) {
+                for( int y = by; y < by + 10; y++ ) {
+                    const bool edge = x == bx || x == bx + 9 || y == by || y == by + 9;
+                    here.ter_set( tripoint( x, y, 0 ), edge ? ter_t_wall : ter_t_floor );
+                }
+            }
+            here.ter_set( tripoint( bx, by + 5, 0 ), ter_t_door_c );
+        }
+    }
+}
+
+static void check_route( const std::vector<tripoint> &route, const tripoint &from,
+                         const tripoint &to )
+{
+    map &here = get_map();
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == to );
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        INFO( "step from " << prev.to_string() << " to " << p.to_string() );
+        CHECK( rl_dist( prev, p ) == 1 );
+        CHECK( here.passable( p ) );
+        prev = p;
+    }
+}
+
+TEST_CASE( "hierarchical_route_through_city_block", "[pathfinding]" )
+{
+    build_city_block();
+    map &here = get_map();
+    const tripoint from( 2, 2, 0 );
+    const tripoint to( MAPSIZE_X - 3, MAPSIZE_Y - 3, 0 );
+
+    const std::vector<tripoint> hierarchical = here.route_hierarchical( from, to,
+            long_range_settings );
+    const std::vector<tripoint> full = here.route_astar( from, to, long_range_settings );
+    check_route( hierarchical, from, to );
+    check_route( full, from, to );
+    // Hierarchical routes are not optimal, but shouldn't be much worse
+    CHECK( hierarchical.size() <= full.size() * 5 / 4 );
+    CHECK( here.route( from, to, long_range_settings ) == hierarchical );
+}
+
+TEST_CASE( "hierarchical_route_follows_map_changes", "[pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+    const int wall_x = MAPSIZE_X / 2;
+    const tripoint from( 5, MAPSIZE_Y / 2, 0 );
+    const tripoint to( MAPSIZE_X - 5, MAPSIZE_Y / 2, 0 );
+    const auto build_wall = [&]( int gap_y ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            here.ter_set( tripoint( wall_x, y, 0 ), y == gap_y ? ter_t_floor : ter_t_wall );
+        }
+    };
+    const auto passes_through = []( const std::vector<tripoint> &route, const tripoint & p ) {
+        return std::find( route.begin(), route.end(), p ) != route.end();
+    };
+
+    build_wall( 10 );
+    std::vector<tripoint> route = here.route_hierarchical( from, to, long_range_settings );
+    check_route( route, from, to );
+    CHECK( passes_through( route, tripoint( wall_x, 10, 0 ) ) );
+
+    // Moving the gap must be picked up by the cluster graph
+    build_wall( MAPSIZE_Y - 10 );
+    route = here.route_hierarchical( from, to, long_range_settings );
+    check_route( route, from, to );
+    CHECK( passes_through( route, tripoint( wall_x, MAPSIZE_Y - 10, 0 ) ) );
+
+    // No gap at all, there is no route
+    build_wall( -1 );
+    CHECK( here.route_hierarchical( from, to, long_range_settings ).empty() );
+}
+
+TEST_CASE( "hierarchical_route_length_matches_full_search", "[pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+    // Scattered pillars and a few walls with gaps
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const bool pillar = ( x * 7 + y * 13 ) % 23 == 0;
+            const bool wall = ( x == 40 && y % 30 > 3 ) || ( y == 50 && x > 60 && x % 25 != 0 );
+            if( pillar || wall ) {
+                here.ter_set( tripoint( x, y, 0 ), ter_t_wall );
+            }
+        }
+    }
+
+    size_t full_steps = 0;
+    size_t hierarchical_steps = 0;
+    int routes = 0;
+    for( int i = 0; i < 40; i++ ) {
+        const tripoint from( 1 + ( i * 37 ) % 30, 1 + ( i * 53 ) % ( MAPSIZE_Y - 2 ), 0 );
+        const tripoint to( MAPSIZE_X - 2 - ( i * 29 ) % 40, 1 + ( i * 17 ) % ( MAPSIZE_Y - 2 ), 0 );
+        if( !here.passable( from ) || !here.passable( to ) ) {
+            continue;
+        }
+        CAPTURE( from, to );
+        const std::vector<tripoint> full = here.route_astar( from, to, long_range_settings );
+        if( full.empty() ) {
+            continue;
+        }
+        const std::vector<tripoint> hierarchical = here.route_hierarchical( from, to,
+                long_range_settings );
+        check_route( hierarchical, from, to );
+        // Single routes may take a detour through a portal, but never a long one
+        CHECK( hierarchical.size() <= full.size() * 6 / 5 );
+        full_steps += full.size();
+        hierarchical_steps += hierarchical.size();
+        routes++;
+    }
+    CHECK( routes > 20 );
+    // On the whole they are almost as short as the full search
+    CHECK( hierarchical_steps <= full_steps * 21 / 20 );
+}
+
+TEST_CASE( "hierarchical_route_from_a_cluster_entrance", "[pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+    // The start is the only open square of its cluster, on the edge to the next cluster east,
+    // so the portal on that edge starts at the start itself.
+    const tripoint from( SEEX - 1, 5, 0 );
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            if( tripoint( x, y, 0 ) != from ) {
+                here.ter_set( tripoint( x, y, 0 ), ter_t_wall );
+            }
+        }
+    }
+    const tripoint to( MAPSIZE_X - 3, MAPSIZE_Y - 3, 0 );
+    check_route( here.route_hierarchical( from, to, long_range_settings ), from, to );
+}
+
+TEST_CASE( "hierarchical_route_performance", "[.]" )
+{
+    build_city_block();
+    map &here = get_map();
+    const tripoint goal( MAPSIZE_X - 3, MAPSIZE_Y / 2, 0 );
+    // 200 zombies spread over the west side of the map, all chasing the same goal
+    std::vector<tripoint> zombies;
+    for( int i = 0; i < 200; i++ ) {
+        zombies.emplace_back( 1 + ( i % 10 ) * 2, 1 + ( i / 10 ) * 6, 0 );
+    }
+
+    // Warm up the caches, so that only the searches are measured
+    here.route_hierarchical( zombies.front(), goal, long_range_settings );
+
+    size_t full_steps = 0;
+    const auto start1 = std::chrono::high_resolution_clock::now();
+    for( const tripoint &z : zombies ) {
+        full_steps += here.route_astar( z, goal, long_range_settings ).size();
+    }
+    const auto end1 = std::chrono::high_resolution_clock::now();
+
+    size_t hierarchical_steps = 0;
+    const auto start2 = std::chrono::high_resolution_clock::now();
+    for( const tripoint &z : zombies ) {
+        hierarchical_steps += here.route_hierarchical( z, goal, long_range_settings ).size();
+    }
+    const auto end2 = std::chrono::high_resolution_clock::now();
+
+    const long long diff1 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end1 - start1 ).count();
+    const long long diff2 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end2 - start2 ).count();
+    printf( "route_astar() found %zu routes of %zu steps in %lld microseconds.\n",
+            zombies.size(), full_steps, diff1 );
+    printf( "route_hierarchical() found %zu routes of %zu steps in %lld microseconds.\n",
+            zombies.size(), hierarchical_steps, diff2 );
+    printf( "new/old execution time ratio: %.02f.\n", static_cast<double>( diff2 ) / diff1 );
+    CHECK( hierarchical_steps > 0 );
+}
+
+// Cost of walking the route according to the flow field
+static int flow_field_cost( const pathfinding_flow_field &field, const tripoint &from,
+                            const std::vector<tripoint> &route )
+{
+    int cost = 0;
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        cost += field.enter_cost[field.index( p.xy() )] + ( prev.x != p.x && prev.y != p.y ? 1 : 0 );
+        prev = p;
+    }
+    return cost;
+}
+
+TEST_CASE( "flow_field_routes_are_optimal", "[pathfinding]" )
+{
+    build_city_block();
+    map &here = get_map();
+    const tripoint goal( MAPSIZE_X - 3, MAPSIZE_Y / 2, 0 );
+    const pathfinding_flow_field &field = here.get_flow_field( goal, long_range_settings );
+    CHECK( &here.get_flow_field( goal, long_range_settings ) == &field );
+
+    for( const tripoint &from : {
+             tripoint( 2, 2, 0 ), tripoint( 2, MAPSIZE_Y - 3, 0 ), tripoint( 36, 40, 0 )
+         } ) {
+        INFO( "from " << from.to_string() );
+        const std::vector<tripoint> flow = here.route_flow_field( from, goal, long_range_settings );
+        const std::vector<tripoint> full = here.route_astar( from, goal, long_range_settings );
+        check_route( flow, from, goal );
+        check_route( full, from, goal );
+        CHECK( flow_field_cost( field, from, flow ) == field.distance_at( from.xy() ) );
+        CHECK( flow_field_cost( field, from, flow ) <= flow_field_cost( field, from, full ) );
+    }
+
+    // Map changes invalidate the field
+    here.ter_set( goal + tripoint_west, ter_t_wall );
+    const pathfinding_flow_field &new_field = here.get_flow_field( goal, long_range_settings );
+    CHECK( new_field.enter_cost[new_field.index( goal.xy() + point_west )] == -1 );
+}
+
+TEST_CASE( "flow_field_performance", "[.]" )
+{
+    build_city_block();
+    map &here = get_map();
+    const tripoint goal( MAPSIZE_X - 3, MAPSIZE_Y / 2, 0 );
+    std::vector<tripoint> zombies;
+    for( int i = 0; i < 200; i++ ) {
+        zombies.emplace_back( 1 + ( i % 10 ) * 2, 1 + ( i / 10 ) * 6, 0 );
+    }
+
+    size_t full_steps = 0;
+    const auto start1 = std::chrono::high_resolution_clock::now();
+    for( const tripoint &z : zombies ) {
+        full_steps += here.route_astar( z, goal, long_range_settings ).size();
+    }
+    const auto end1 = std::chrono::high_resolution_clock::now();
+
+    // Includes building the field once
+    size_t flow_steps = 0;
+    const auto start2 = std::chrono::high_resolution_clock::now();
+    for( const tripoint &z : zombies ) {
+        flow_steps += here.route_flow_field( z, goal, long_range_settings ).size();
+    }
+    const auto end2 = std::chrono::high_resolution_clock::now();
+
+    const long long diff1 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end1 - start1 ).count();
+    const long long diff2 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end2 - start2 ).count();
+    printf( "route_astar() found %zu routes of %zu steps in %lld microseconds.\n",
+            zombies.size(), full_steps, diff1 );
+    printf( "route_flow_field() found %zu routes of %zu steps in %lld microseconds.\n",
+            zombies.size(), flow_steps, diff2 );
+    printf( "new/old execution time ratio: %.02f.\n", static_cast<double>( diff2 ) / diff1 );
+    CHECK( flow_steps > 0 );
+}
@@ -0,0 +1,130 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+#include "calendar.h"
+#include "catch/catch.hpp"
+#include "game.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "point.h"
+#include "scent_map.h"
+#include "type_id.h"
+
+static constexpr int scent_radius = 40;
+
+using scent_values = std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X>;
+
+static scent_values read_scent( const scent_map &scent, const int z )
+{
+    scent_values result;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            result[x][y] = scent.get_unsafe( { x, y, z } );
+        }
+    }
+    return result;
+}
+
+// One step of scent diffusion written out square by square, the way scent_map::update
+// used to do it.
+static void diffuse_reference( scent_values &grscent, const tripoint &center, const map &m )
+{
+    const auto blocks = [&]( const int x, const int y ) {
+        return m.has_flag_ter( TFLAG_NO_SCENT, { x, y, center.z } );
+    };
+    const auto reduces = [&]( const int x, const int y ) {
+        return !blocks( x, y ) && ( m.has_flag_ter( TFLAG_REDUCE_SCENT, { x, y, center.z } ) ||
+                                    m.has_flag_furn( TFLAG_REDUCE_SCENT, { x, y, center.z } ) );
+    };
+    const int diffusivity = 100;
+    scent_values sum_3_scent_y{};
+    scent_values squares_used_y{};
+    for( int x = center.x - scent_radius - 1; x <= center.x + scent_radius + 1; ++x ) {
+        for( int y = center.y - scent_radius; y <= center.y + scent_radius; ++y ) {
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( !blocks( x, i ) ) {
+                    const int weight = reduces( x, i ) ? 2 : 10;
+                    sum_3_scent_y[y][x] += weight * grscent[x][i];
+                    squares_used_y[y][x] += weight;
+                }
+            }
+        }
+    }
+    for( int x = center.x - scent_radius; x <= center.x + scent_radius; ++x ) {
+        for( int y = center.y - scent_radius; y <= center.y + scent_radius; ++y ) {
+            int &scent_here = grscent[x][y];
+            if( blocks( x, y ) ) {
+                scent_here = 0;
+                continue;
+            }
+            const int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] +
+                                     squares_used_y[y][x + 1];
+            const int this_diffusivity = reduces( x, y ) ? diffusivity / 5 : diffusivity;
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            scent_here = ( temp_scent + this_diffusivity * ( sum_3_scent_y[y][x - 1] +
+                           sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1] ) ) / ( 1000 * 10 );
+        }
+    }
+}
+
+TEST_CASE( "scent_diffusion_matches_the_square_by_square_version", "[scent]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint center( 60, 60, 0 );
+    // A room with a gap in its wall, a strip of scent reducing floor and water next to it.
+    for( int i = 45; i <= 75; ++i ) {
+        here.ter_set( { i, 45, 0 }, t_wall );
+        here.ter_set( { 45, i, 0 }, t_wall );
+        here.ter_set( { i, 75, 0 }, t_wall );
+    }
+    here.ter_set( { 60, 45, 0 }, t_floor );
+    for( int i = 50; i <= 70; ++i ) {
+        here.ter_set( { 52, i, 0 }, ter_str_id( "t_rad_platform" ) );
+        here.ter_set( { 80, i, 0 }, t_water_dp );
+    }
+
+    scent_map scent( *g );
+    scent.reset();
+    scent.set_unsafe( center, 1000 );
+    scent.set_unsafe( { 61, 60, 0 }, 500 );
+    scent.set_unsafe( { 22, 22, 0 }, 300 );
+    scent.set_unsafe( { 100, 99, 0 }, 800 );
+    scent_values expected = read_scent( scent, 0 );
+
+    for( int turn = 0; turn < 20; ++turn ) {
+        CAPTURE( turn );
+        if( turn == 10 ) {
+            // Terrain changes must reach the diffusion even though the blockers are cached.
+            here.ter_set( { 60, 45, 0 }, t_wall );
+            here.ter_set( { 61, 61, 0 }, t_wall );
+        }
+        diffuse_reference( expected, center, here );
+        scent.update( center, here );
+        CHECK( read_scent( scent, 0 ) == expected );
+    }
+}
+
+TEST_CASE( "scent_diffusion_performance", "[.]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint center( 60, 60, 0 );
+    scent_map scent( *g );
+    scent.reset();
+    const int iterations = 2000;
+    const auto start = std::chrono::steady_clock::now();
+    for( int i = 0; i < iterations; ++i ) {
+        scent.set_unsafe( center + point( i % 3, i % 5 ), 1000 );
+        scent.update( center, here );
+    }
+    const auto end = std::chrono::steady_clock::now();
+    CHECK( scent.get_unsafe( center ) > 0 );
+    printf( "%d scent updates: %lld ms\n", iterations,
+            static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>
+                                    ( end - start ).count() ) );
+}
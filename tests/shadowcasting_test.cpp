@@ -407,6 +407,153 @@ static constexpr float X = LIGHT_TRANSPARENCY_SOLID;
 
 const point ORIGIN( 65, 65 );
 
+// castLight() as it was before it reused the intensity along a row, calculating it for every
+// square. Kept to check that the shortcut doesn't change the results.
+// NOLINTNEXTLINE(cata-xy)
+static void uncachedCastLight( float ( &output_cache )[MAPSIZE * SEEX][MAPSIZE * SEEY],
+                               const float ( &input_array )[MAPSIZE * SEEX][MAPSIZE * SEEY],
+                               const int xx, const int xy, const int yx, const int yy,
+                               const point &offset, const int row = 1, float start = 1.0f,
+                               const float end = 0.0f,
+                               float cumulative_transparency = LIGHT_TRANSPARENCY_OPEN_AIR )
+{
+    float newStart = 0.0f;
+    const float radius = 60.0f;
+    if( start < end ) {
+        return;
+    }
+    float last_intensity = 0.0;
+    tripoint delta;
+    for( int distance = row; distance <= radius; distance++ ) {
+        delta.y = -distance;
+        bool started_row = false;
+        float current_transparency = 0.0;
+        const float away = start - ( -distance + 0.5f ) / ( -distance - 0.5f );
+        delta.x = -distance + std::max( static_cast<int>( std::ceil( away * ( -distance - 0.5f ) ) ), 0 );
+
+        for( ; delta.x <= 0; delta.x++ ) {
+            const point current( offset.x + delta.x * xx + delta.y * xy,
+                                 offset.y + delta.x * yx + delta.y * yy );
+            const float trailingEdge = ( delta.x - 0.5f ) / ( delta.y + 0.5f );
+            const float leadingEdge = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
+
+            if( !( current.x >= 0 && current.y >= 0 && current.x < MAPSIZE_X &&
+                   current.y < MAPSIZE_Y ) ) {
+                continue;
+            } else if( end > trailingEdge ) {
+                break;
+            }
+            if( !started_row ) {
+                started_row = true;
+                current_transparency = input_array[ current.x ][ current.y ];
+            }
+
+            last_intensity = sight_calc( 1.0f, cumulative_transparency, rl_dist( tripoint_zero, delta ) );
+            const float new_transparency = input_array[ current.x ][ current.y ];
+            update_light( output_cache[current.x][current.y], last_intensity, quadrant::default_ );
+
+            if( new_transparency == current_transparency ) {
+                newStart = leadingEdge;
+                continue;
+            }
+            if( sight_check( current_transparency, last_intensity ) ) {
+                uncachedCastLight( output_cache, input_array, xx, xy, yx, yy, offset, distance + 1,
+                                   start, trailingEdge,
+                                   accumulate_transparency( cumulative_transparency, current_transparency, distance ) );
+            }
+            if( !sight_check( current_transparency, last_intensity ) ) {
+                start = newStart;
+            } else {
+                start = trailingEdge;
+            }
+            if( start < end ) {
+                return;
+            }
+            current_transparency = new_transparency;
+            newStart = leadingEdge;
+        }
+        if( !sight_check( current_transparency, last_intensity ) ) {
+            break;
+        }
+        cumulative_transparency = accumulate_transparency( cumulative_transparency,
+                                  current_transparency, distance );
+    }
+}
+
+static void shadowcasting_row_intensity( const int iterations, const bool use_trigdist )
+{
+    float seen_squares_control[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{0}};
+    float seen_squares_experiment[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{0}};
+    float transparency_cache[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{0}};
+
+    // Mix in some smoke, so that the cumulative transparency varies between rows
+    std::uniform_int_distribution<int> distribution( 0, 9 );
+    for( auto &inner : transparency_cache ) {
+        for( float &square : inner ) {
+            const int roll = distribution( rng_get_engine() );
+            square = roll == 0 ? LIGHT_TRANSPARENCY_SOLID :
+                     roll == 1 ? LIGHT_TRANSPARENCY_OPEN_AIR * 5 : LIGHT_TRANSPARENCY_OPEN_AIR;
+        }
+    }
+
+    const bool old_trigdist = trigdist;
+    trigdist = use_trigdist;
+
+    const point offset( 65, 65 );
+
+    const auto start1 = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        uncachedCastLight( seen_squares_control, transparency_cache, 0, 1, 1, 0, offset );
+        uncachedCastLight( seen_squares_control, transparency_cache, 1, 0, 0, 1, offset );
+        uncachedCastLight( seen_squares_control, transparency_cache, 0, -1, 1, 0, offset );
+        uncachedCastLight( seen_squares_control, transparency_cache, -1, 0, 0, 1, offset );
+        uncachedCastLight( seen_squares_control, transparency_cache, 0, 1, -1, 0, offset );
+        uncachedCastLight( seen_squares_control, transparency_cache, 1, 0, 0, -1, offset );
+        uncachedCastLight( seen_squares_control, transparency_cache, 0, -1, -1, 0, offset );
+        uncachedCastLight( seen_squares_control, transparency_cache, -1, 0, 0, -1, offset );
+    }
+    const auto end1 = std::chrono::high_resolution_clock::now();
+
+    const auto start2 = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+            seen_squares_experiment, transparency_cache, offset );
+    }
+    const auto end2 = std::chrono::high_resolution_clock::now();
+
+    trigdist = old_trigdist;
+
+    if( iterations > 1 ) {
+        const long long diff1 = std::chrono::duration_cast<std::chrono::microseconds>
+                                ( end1 - start1 ).count();
+        const long long diff2 = std::chrono::duration_cast<std::chrono::microseconds>
+                                ( end2 - start2 ).count();
+        const double cells = static_cast<double>( iterations ) * MAPSIZE_X * MAPSIZE_Y;
+        printf( "uncached castLight (trigdist %d) executed %d times in %lld microseconds, "
+                "%.0f cells per second.\n", use_trigdist, iterations, diff1, cells * 1e6 / diff1 );
+        printf( "castLight (trigdist %d) executed %d times in %lld microseconds, "
+                "%.0f cells per second.\n", use_trigdist, iterations, diff2, cells * 1e6 / diff2 );
+    }
+
+    // Not just the same outcome, exactly the same values
+    bool passed = true;
+    for( int x = 0; passed && x < MAPSIZE * SEEX; ++x ) {
+        for( int y = 0; y < MAPSIZE * SEEY; ++y ) {
+            if( seen_squares_control[x][y] != seen_squares_experiment[x][y] ) {
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    if( !passed ) {
+        print_grid_comparison( offset, transparency_cache, seen_squares_control,
+                               seen_squares_experiment );
+    }
+
+    REQUIRE( passed );
+}
+
 struct grid_overlay {
     std::vector<std::vector<float>> data;
     point offset;
@@ -632,6 +779,18 @@ TEST_CASE( "shadowcasting_float_quad_performance", "[.]" )
     shadowcasting_float_quad( 1000000, 100 );
 }
 
+TEST_CASE( "shadowcasting_row_intensity_equivalence", "[shadowcasting]" )
+{
+    shadowcasting_row_intensity( 1, false );
+    shadowcasting_row_intensity( 1, true );
+}
+
+TEST_CASE( "shadowcasting_row_intensity_performance", "[.]" )
+{
+    shadowcasting_row_intensity( 10000, false );
+    shadowcasting_row_intensity( 10000, true );
+}
+
 // I'm not sure this will ever work.
 TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
 {
@@ -0,0 +1,53 @@
+#include <functional>
+#include <set>
+#include <string>
+
+#include "catch/catch.hpp"
+#include "string_id.h"
+
+namespace
+{
+struct test_obj;
+struct other_test_obj;
+} // namespace
+
+using test_id = string_id<test_obj>;
+using other_test_id = string_id<other_test_obj>;
+
+TEST_CASE( "string_id_interning", "[string_id]" )
+{
+    const std::string name = "test_string_id_interning";
+    const test_id a( name );
+    const test_id b( name.c_str() );
+    const test_id c( "test_string_id_interning_other" );
+
+    CHECK( a == b );
+    CHECK( a != c );
+    CHECK( a.str() == name );
+    CHECK( std::hash<test_id>()( a ) == std::hash<test_id>()( b ) );
+    CHECK( std::hash<test_id>()( a ) != std::hash<test_id>()( c ) );
+    // Ids of different types share the table entry of their string
+    CHECK( a.interned_index() == other_test_id( name ).interned_index() );
+
+    CHECK( test_id().is_empty() );
+    CHECK( test_id( "" ).is_empty() );
+    CHECK( test_id() == test_id( std::string() ) );
+    CHECK_FALSE( a.is_empty() );
+}
+
+TEST_CASE( "string_id_ordering_is_lexical", "[string_id]" )
+{
+    // Intern in reverse order, containers must still sort by the string
+    const test_id z( "test_string_id_order_z" );
+    const test_id m( "test_string_id_order_m" );
+    const test_id a( "test_string_id_order_a" );
+    const std::set<test_id> ids = { z, a, m };
+    std::string joined;
+    for( const test_id &id : ids ) {
+        joined += id.str().back();
+    }
+    CHECK( joined == "amz" );
+    CHECK_FALSE( a < a );
+    CHECK( a < m );
+    CHECK_FALSE( m < a );
+}
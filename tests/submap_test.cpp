@@ -1,8 +1,27 @@
 #include "catch/catch.hpp"
 #include "submap.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cata_utility.h"
+#include "compress.h"
+#include "coordinate_conversions.h"
+#include "game.h"
 #include "game_constants.h"
 #include "int_id.h"
+#include "json.h"
+#include "map.h"
+#include "mapbuffer.h"
+#include "mapdata.h"
+#include "options_helpers.h"
+#include "path_info.h"
 #include "point.h"
+#include "string_formatter.h"
+#include "submap_quad.h"
+#include "trap.h"
 #include "type_id.h"
 
 TEST_CASE( "submap rotation", "[submap]" )
@@ -88,3 +107,198 @@ TEST_CASE( "submap rotation", "[submap]" )
         }
     }
 }
+
+static submap make_marked_submap()
+{
+    submap sm;
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            sm.set_ter( point( i, j ), ter_str_id( "t_dirt" ).id() );
+        }
+    }
+    sm.set_ter( point( 3, 4 ), ter_str_id( "t_floor" ).id() );
+    sm.set_ter( point( SEEX - 1, SEEY - 1 ), ter_str_id( "t_wall" ).id() );
+    sm.set_furn( point( 5, 5 ), furn_str_id( "f_chair" ).id() );
+    sm.set_trap( point( 7, 2 ), trap_str_id( "tr_beartrap" ).id() );
+    sm.set_radiation( point( 1, 1 ), 23 );
+    sm.set_temperature( 17 );
+    return sm;
+}
+
+static void check_same_submap( const submap &expected, const submap &actual )
+{
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            CAPTURE( p );
+            CHECK( actual.get_ter( p ) == expected.get_ter( p ) );
+            CHECK( actual.get_furn( p ) == expected.get_furn( p ) );
+            CHECK( actual.get_trap( p ) == expected.get_trap( p ) );
+            CHECK( actual.get_radiation( p ) == expected.get_radiation( p ) );
+        }
+    }
+    CHECK( actual.get_temperature() == expected.get_temperature() );
+}
+
+TEST_CASE( "submap binary quad round trip", "[submap]" )
+{
+    const submap original = make_marked_submap();
+    const tripoint coordinates( -12, 34, -1 );
+    const std::vector<submap_record> records{ submap_record( original, coordinates, savegame_version ) };
+
+    const std::string data = quad_file::write_binary( records );
+    REQUIRE( quad_file::is_binary( data ) );
+    const std::vector<submap_record> loaded = quad_file::read_binary( data );
+    REQUIRE( loaded.size() == 1 );
+    CHECK( loaded[0].coordinates == coordinates );
+    CHECK( loaded[0].version == savegame_version );
+
+    submap sm;
+    loaded[0].apply( sm );
+    check_same_submap( original, sm );
+
+    // A truncated file must not load
+    CHECK_THROWS( quad_file::read_binary( data.substr( 0, data.size() - 3 ) ) );
+}
+
+TEST_CASE( "submap quad format conversion", "[submap]" )
+{
+    const submap original = make_marked_submap();
+
+    // Same layout mapbuffer used for its JSON quads
+    std::ostringstream buffer;
+    JsonOut jsout( buffer );
+    jsout.start_array();
+    jsout.start_object();
+    jsout.member( "version", savegame_version );
+    jsout.member( "coordinates" );
+    jsout.start_array();
+    jsout.write( 2 );
+    jsout.write( 4 );
+    jsout.write( 0 );
+    jsout.end_array();
+    original.store( jsout );
+    jsout.end_object();
+    jsout.end_array();
+    const std::string legacy = buffer.str();
+
+    std::string data = legacy;
+    CHECK_FALSE( quad_file::convert( data, false ) );
+    REQUIRE( quad_file::convert( data, true ) );
+    CHECK( quad_file::is_binary( data ) );
+    CHECK_FALSE( quad_file::convert( data, true ) );
+
+    const std::vector<submap_record> records = quad_file::read_binary( data );
+    REQUIRE( records.size() == 1 );
+    CHECK( records[0].coordinates == tripoint( 2, 4, 0 ) );
+    submap sm;
+    records[0].apply( sm );
+    check_same_submap( original, sm );
+
+    REQUIRE( quad_file::convert( data, false ) );
+    const std::vector<submap_record> json_records = quad_file::read_json( data );
+    REQUIRE( json_records.size() == 1 );
+    submap from_json;
+    json_records[0].apply( from_json );
+    check_same_submap( original, from_json );
+    // Converting again gives the same file
+    CHECK( quad_file::write_json( json_records ) == data );
+}
+
+// Looks up the submaps of a quad that was saved and removed from the buffer, and removes them again
+static void check_loaded_quad( const std::vector<tripoint> &addrs )
+{
+    for( const tripoint &p : addrs ) {
+        CAPTURE( p );
+        const submap *sm = MAPBUFFER.lookup_submap( p );
+        REQUIRE( sm != nullptr );
+        check_same_submap( make_marked_submap(), *sm );
+    }
+    // The quad is outside the reality bubble, so saving removes it from the buffer
+    MAPBUFFER.save();
+}
+
+// Saves a quad of marked submaps outside the reality bubble, returns their positions
+static std::vector<tripoint> save_marked_quad()
+{
+    const tripoint quad = omt_to_sm_copy( sm_to_omt_copy( get_map().get_abs_sub() ) +
+                                          tripoint( 50, 50, 0 ) );
+    const std::vector<tripoint> addrs{
+        quad, quad + point_south, quad + point_east, quad + point_south_east
+    };
+    for( const tripoint &p : addrs ) {
+        std::unique_ptr<submap> sm = std::make_unique<submap>( make_marked_submap() );
+        REQUIRE( MAPBUFFER.add_submap( p, sm ) );
+    }
+    MAPBUFFER.save();
+    return addrs;
+}
+
+TEST_CASE( "prefetched submaps load like directly read ones", "[submap]" )
+{
+    const std::vector<tripoint> addrs = save_marked_quad();
+    const tripoint &quad = addrs[0];
+
+    SECTION( "read directly" ) {
+        check_loaded_quad( addrs );
+    }
+    SECTION( "prefetched" ) {
+        MAPBUFFER.prefetch( addrs );
+        MAPBUFFER.finish_prefetch();
+        check_loaded_quad( addrs );
+    }
+    SECTION( "looked up while prefetching" ) {
+        MAPBUFFER.prefetch( addrs );
+        check_loaded_quad( addrs );
+    }
+    SECTION( "prefetched and dropped again" ) {
+        MAPBUFFER.prefetch( addrs );
+        MAPBUFFER.prefetch( {} );
+        check_loaded_quad( addrs );
+    }
+    SECTION( "prefetched twice" ) {
+        MAPBUFFER.prefetch( addrs );
+        MAPBUFFER.prefetch( { quad } );
+        MAPBUFFER.finish_prefetch();
+        check_loaded_quad( addrs );
+    }
+}
+
+TEST_CASE( "map quads are saved in the chosen format", "[submap]" )
+{
+    for( const std::string format : {
+             "compact", "json"
+         } ) {
+        CAPTURE( format );
+        override_option opt( "MAP_SAVE_FORMAT", format );
+        const std::vector<tripoint> addrs = save_marked_quad();
+
+        const tripoint om_addr = sm_to_omt_copy( addrs[0] );
+        const tripoint segment = omt_to_seg_copy( om_addr );
+        const std::string path = string_format( "%s/maps/%d.%d.%d/%d.%d.%d.map",
+                                                PATH_INFO::world_base_save_path(), segment.x, segment.y, segment.z,
+                                                om_addr.x, om_addr.y, om_addr.z );
+        std::string data;
+        REQUIRE( read_from_file( path, [&data]( std::istream & fin ) {
+            std::ostringstream buffer;
+            buffer << fin.rdbuf();
+            data = buffer.str();
+        } ) );
+        CHECK( quad_file::is_binary( data ) == ( format == "compact" ) );
+        check_loaded_quad( addrs );
+    }
+}
+
+TEST_CASE( "lz compression round trip", "[submap]" )
+{
+    std::string input;
+    for( int i = 0; i < 1000; i++ ) {
+        input += "[\"t_dirt\"," + std::to_string( i % 7 ) + "],";
+    }
+    const std::string compressed = compress_lz( input );
+    CHECK( compressed.size() < input.size() / 4 );
+    CHECK( decompress_lz( compressed ) == input );
+    CHECK( decompress_lz( compress_lz( std::string() ) ).empty() );
+
+    CHECK_THROWS( decompress_lz( compressed.substr( 0, compressed.size() - 1 ) ) );
+}
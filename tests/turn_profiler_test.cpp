@@ -0,0 +1,99 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cata_utility.h"
+#include "catch/catch.hpp"
+#include "filesystem.h"
+#include "json.h"
+#include "turn_profiler.h"
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+static void run_turn()
+{
+    turn_profiler::scoped_zone outer( "outer" );
+    {
+        turn_profiler::scoped_zone inner( "inner" );
+    }
+    {
+        turn_profiler::scoped_zone inner( "inner" );
+        turn_profiler::scoped_zone innermost( "innermost" );
+    }
+    turn_profiler::scoped_zone other( "other" );
+}
+
+TEST_CASE( "turn_profiler_builds_the_zone_tree", "[turn_profiler]" )
+{
+    turn_profiler::set_enabled( true );
+    run_turn();
+    std::thread( []() {
+        // Zones on other threads are ignored.
+        turn_profiler::scoped_zone elsewhere( "elsewhere" );
+    } ).join();
+    {
+        turn_profiler::scoped_zone second( "second" );
+    }
+    turn_profiler::end_turn();
+
+    const std::vector<turn_profiler::zone_report> zones = turn_profiler::report();
+    REQUIRE( zones.size() == 5 );
+    CHECK( zones[0].name == "outer" );
+    CHECK( zones[0].depth == 0 );
+    CHECK( zones[0].calls == 1 );
+    CHECK( zones[1].name == "inner" );
+    CHECK( zones[1].depth == 1 );
+    CHECK( zones[1].calls == 2 );
+    CHECK( zones[2].name == "innermost" );
+    CHECK( zones[2].depth == 2 );
+    CHECK( zones[3].name == "other" );
+    CHECK( zones[3].depth == 1 );
+    CHECK( zones[4].name == "second" );
+    CHECK( zones[4].depth == 0 );
+    CHECK( zones[0].last_ms >= zones[1].last_ms );
+    CHECK( zones[0].average_ms == zones[0].last_ms );
+
+    turn_profiler::end_turn();
+    CHECK( turn_profiler::report()[1].calls == 0 );
+
+    turn_profiler::set_enabled( false );
+    run_turn();
+    turn_profiler::end_turn();
+    CHECK( turn_profiler::report().empty() );
+}
+
+TEST_CASE( "turn_profiler_writes_a_chrome_trace", "[turn_profiler]" )
+{
+    const std::string path = "turn_profiler_test_trace.json";
+    turn_profiler::start_trace();
+    REQUIRE( turn_profiler::enabled() );
+    run_turn();
+    turn_profiler::end_turn();
+    run_turn();
+    // Five zones per turn and the start of the second turn.
+    CHECK( turn_profiler::stop_trace( path ) == 11 );
+    CHECK_FALSE( turn_profiler::tracing() );
+    turn_profiler::set_enabled( false );
+
+    std::vector<std::string> names;
+    std::vector<std::string> phases;
+    REQUIRE( read_from_file_json( path, [&]( JsonIn & jsin ) {
+        JsonObject trace = jsin.get_object();
+        trace.allow_omitted_members();
+        for( JsonObject event : trace.get_array( "traceEvents" ) ) {
+            event.allow_omitted_members();
+            names.push_back( event.get_string( "name" ) );
+            phases.push_back( event.get_string( "ph" ) );
+            CHECK( event.get_float( "ts" ) >= 0.0 );
+        }
+    } ) );
+    remove_file( path );
+    // Zones are written when they close, so children come before their parents.
+    CHECK( names == std::vector<std::string> {
+        "inner", "innermost", "inner", "other", "outer", "turn",
+        "inner", "innermost", "inner", "other", "outer"
+    } );
+    CHECK( phases[5] == "i" );
+}
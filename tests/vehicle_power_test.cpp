@@ -178,3 +178,94 @@ TEST_CASE( "maximum reverse velocity", "[vehicle][power][reverse]" )
     }
 }
 
+
+static void connect_with_cable( vehicle &from, vehicle &to, const std::string &cable )
+{
+    map &here = get_map();
+    const vpart_id cable_part( cable );
+    vehicle_part from_end( cable_part, point_zero, item( cable ) );
+    from_end.target.first = here.getabs( to.global_pos3() );
+    from_end.target.second = here.getabs( to.global_pos3() );
+    REQUIRE( from.install_part( point_zero, from_end ) >= 0 );
+    vehicle_part to_end( cable_part, point_zero, item( cable ) );
+    to_end.target.first = here.getabs( from.global_pos3() );
+    to_end.target.second = here.getabs( from.global_pos3() );
+    REQUIRE( to.install_part( point_zero, to_end ) >= 0 );
+}
+
+static void set_battery_charge( vehicle &veh, bool full )
+{
+    for( const int bi : veh.batteries ) {
+        vehicle_part &battery = veh.part( bi );
+        battery.ammo_set( fuel_type_battery, full ? battery.ammo_capacity( ammotype( "battery" ) ) : 0 );
+    }
+}
+
+TEST_CASE( "power flows through cables to connected vehicles", "[vehicle][power]" )
+{
+    reset_player();
+    build_test_map( ter_id( "t_pavement" ) );
+    clear_vehicles();
+    map &here = get_map();
+
+    vehicle *first = here.add_vehicle( vproto_id( "reactor_test" ), tripoint( 10, 10, 0 ), 0, 0, 0 );
+    vehicle *second = here.add_vehicle( vproto_id( "reactor_test" ), tripoint( 20, 10, 0 ), 0, 0, 0 );
+    vehicle *third = here.add_vehicle( vproto_id( "reactor_test" ), tripoint( 30, 10, 0 ), 0, 0, 0 );
+    REQUIRE( first != nullptr );
+    REQUIRE( second != nullptr );
+    REQUIRE( third != nullptr );
+    // 1% loss between the first two, another 5% to the third one
+    connect_with_cable( *first, *second, "jumper_cable" );
+    connect_with_cable( *second, *third, "jumper_cable_heavy" );
+    set_battery_charge( *first, true );
+    set_battery_charge( *second, true );
+    set_battery_charge( *third, false );
+    const int full = first->fuel_left( fuel_type_battery, false );
+    REQUIRE( full > 0 );
+    REQUIRE( first->fuel_left( fuel_type_battery, true ) == 2 * full );
+
+    WHEN( "the first vehicle is charged" ) {
+        CHECK( first->charge_battery( 1000 ) == 0 );
+        THEN( "the power reaches the third one with the losses of both cables" ) {
+            // 10 lost on the way to the second vehicle, 990 * 6% on the way to the third
+            CHECK( third->fuel_left( fuel_type_battery, false ) == 931 );
+            CHECK( first->fuel_left( fuel_type_battery, true ) == 2 * full + 931 );
+        }
+    }
+    WHEN( "the third vehicle draws power" ) {
+        CHECK( third->discharge_battery( 100 ) == 0 );
+        THEN( "the second one provides it, with the loss of the cable" ) {
+            CHECK( second->fuel_left( fuel_type_battery, false ) == full - 105 );
+            CHECK( first->fuel_left( fuel_type_battery, false ) == full );
+        }
+    }
+    WHEN( "a connected vehicle is destroyed" ) {
+        CHECK( first->fuel_left( fuel_type_battery, true ) == 2 * full );
+        here.destroy_vehicle( second );
+        THEN( "the others are no longer connected" ) {
+            CHECK( first->fuel_left( fuel_type_battery, true ) == full );
+            CHECK( first->charge_battery( 1000 ) == 1000 );
+            CHECK( third->fuel_left( fuel_type_battery, true ) == 0 );
+        }
+        AND_WHEN( "another vehicle is placed where the cables lead" ) {
+            vehicle *replacement = here.add_vehicle( vproto_id( "reactor_test" ), tripoint( 20, 10, 0 ),
+                                   0, 0, 0 );
+            REQUIRE( replacement != nullptr );
+            set_battery_charge( *replacement, true );
+            THEN( "the cables connect to it" ) {
+                CHECK( first->fuel_left( fuel_type_battery, true ) == 2 * full );
+                CHECK( third->fuel_left( fuel_type_battery, true ) == full );
+            }
+        }
+    }
+    WHEN( "an unconnected vehicle moves" ) {
+        vehicle *other = here.add_vehicle( vproto_id( "reactor_test" ), tripoint( 40, 10, 0 ), 0, 0, 0 );
+        REQUIRE( other != nullptr );
+        set_battery_charge( *other, true );
+        REQUIRE( here.displace_vehicle( *other, tripoint_east ) );
+        THEN( "the grid stays the same" ) {
+            CHECK( first->fuel_left( fuel_type_battery, true ) == 2 * full );
+            CHECK( other->fuel_left( fuel_type_battery, true ) == full );
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <iomanip>
 #include <list>
@@ -542,3 +543,91 @@ TEST_CASE( "vision_see_wall_in_moonlight", "[shadowcasting][vision]" )
 
     t.test_all();
 }
+
+// Lightmap of the last build_map_cache, the stationary light either reused or cast again
+static std::vector<float> lightmap_after_update( map &here, bool recast_stationary_light )
+{
+    if( recast_stationary_light ) {
+        here.invalidate_stationary_light();
+    }
+    here.invalidate_map_cache( 0 );
+    here.build_map_cache( 0 );
+    const level_cache &cache = here.access_cache( 0 );
+    std::vector<float> result;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            const std::array<float, 4> &quadrants = cache.lm[x][y].values;
+            result.insert( result.end(), quadrants.begin(), quadrants.end() );
+            result.push_back( cache.sm[x][y] );
+        }
+    }
+    return result;
+}
+
+static void check_stationary_light_matches_recast( map &here )
+{
+    const std::vector<float> updated = lightmap_after_update( here, false );
+    const std::vector<float> recast = lightmap_after_update( here, true );
+    REQUIRE( updated.size() == recast.size() );
+    int differences = 0;
+    for( size_t i = 0; i < updated.size(); ++i ) {
+        if( updated[i] != recast[i] ) {
+            ++differences;
+        }
+    }
+    CHECK( differences == 0 );
+}
+
+TEST_CASE( "stationary_light_matches_full_recompute", "[shadowcasting][vision]" )
+{
+    const ter_id t_brick_wall( "t_brick_wall" );
+    const ter_id t_floor( "t_floor" );
+    const ter_id t_utility_light( "t_utility_light" );
+    const ter_id t_flat_roof( "t_flat_roof" );
+
+    Character &player_character = get_player_character();
+    g->place_player( tripoint( 60, 60, 0 ) );
+    player_character.worn.clear();
+    player_character.clear_effects();
+    clear_map();
+    g->reset_light_level();
+    calendar::turn = midnight;
+
+    map &here = get_map();
+    // A roofed room with a doorway, so light falls both indoors and out of it
+    for( int x = 50; x <= 70; ++x ) {
+        for( int y = 50; y <= 58; ++y ) {
+            const tripoint p( x, y, 0 );
+            const bool wall = x == 50 || x == 70 || y == 50 || y == 58;
+            here.ter_set( p, wall && x != 60 ? t_brick_wall : t_floor );
+            here.ter_set( p + tripoint_above, t_flat_roof );
+        }
+    }
+    here.ter_set( tripoint( 55, 54, 0 ), t_utility_light );
+    here.ter_set( tripoint( 66, 52, 0 ), t_utility_light );
+    here.add_item( tripoint( 40, 62, 0 ), item( "plastic_jack_o_lantern_lit" ) );
+    check_stationary_light_matches_recast( here );
+
+    SECTION( "light added" ) {
+        here.ter_set( tripoint( 62, 56, 0 ), t_utility_light );
+        here.add_item( tripoint( 61, 51, 0 ), item( "plastic_jack_o_lantern_lit" ) );
+        check_stationary_light_matches_recast( here );
+    }
+    SECTION( "light removed" ) {
+        here.ter_set( tripoint( 66, 52, 0 ), t_floor );
+        here.i_clear( tripoint( 40, 62, 0 ) );
+        check_stationary_light_matches_recast( here );
+    }
+    SECTION( "light moved" ) {
+        here.ter_set( tripoint( 55, 54, 0 ), t_floor );
+        here.ter_set( tripoint( 56, 55, 0 ), t_utility_light );
+        here.i_clear( tripoint( 40, 62, 0 ) );
+        here.add_item( tripoint( 41, 62, 0 ), item( "plastic_jack_o_lantern_lit" ) );
+        check_stationary_light_matches_recast( here );
+    }
+    SECTION( "wall moved" ) {
+        here.ter_set( tripoint( 60, 58, 0 ), t_brick_wall );
+        here.ter_set( tripoint( 61, 58, 0 ), t_floor );
+        check_stationary_light_matches_recast( here );
+    }
+}